@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Converts a BDF bitmap font into a scrolltext font (see src/scrolltext/font.h).
+
+usage: bdf2font.py [options] FONT.bdf NAME
+
+Writes font_NAME.c and font_NAME.h into the current directory. Monospaced
+BDF fonts get the fixed-stride layout without an index table, all others
+the proportional one; --fixed and --proportional override that choice.
+
+--text FILE keeps only the glyphs which occur in FILE (e.g. the texts of a
+deployment). In the proportional layout unused glyphs shrink to zero
+columns, in the fixed-stride layout the glyph range gets trimmed to the
+used characters.
+
+Characters beyond the range (e.g. umlauts) can be added with --extra or
+simply by using them in the --text file. Their glyphs follow the range and
+get looked up via the glyphRanges table. All other characters are shown as
+spaces.
+"""
+
+import argparse
+import sys
+
+
+def parse_bdf(path):
+    """Returns (ascent, descent, {code: (dwidth, bbx, rows)})."""
+    ascent = descent = None
+    glyphs = {}
+    code = dwidth = bbx = rows = None
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            fields = line.split()
+            if not fields:
+                continue
+            key = fields[0]
+            if key == "FONT_ASCENT":
+                ascent = int(fields[1])
+            elif key == "FONT_DESCENT":
+                descent = int(fields[1])
+            elif key == "FONTBOUNDINGBOX" and ascent is None:
+                ascent = int(fields[2]) + int(fields[4])
+                descent = -int(fields[4])
+            elif key == "ENCODING":
+                code = int(fields[1])
+            elif key == "DWIDTH":
+                dwidth = int(fields[1])
+            elif key == "BBX":
+                bbx = [int(v) for v in fields[1:5]]
+            elif key == "BITMAP":
+                rows = []
+            elif key == "ENDCHAR":
+                if code is not None and code >= 0:
+                    glyphs[code] = (dwidth, bbx, rows)
+                code = dwidth = bbx = rows = None
+            elif rows is not None:
+                rows.append(int(key, 16) << (4 * (8 - len(key))))
+    if ascent is None:
+        sys.exit("%s: no font metrics found" % path)
+    return ascent, descent, glyphs
+
+
+def render(glyph, ascent, height):
+    """Returns the columns of a glyph as integers, bit 0 is the top row."""
+    dwidth, (w, h, xoff, yoff), rows = glyph
+    width = max(xoff + w, 0)
+    columns = [0] * width
+    top = ascent - (yoff + h)
+    for r, bits in enumerate(rows):
+        y = top + r
+        if not 0 <= y < height:
+            continue
+        for c in range(w):
+            x = xoff + c
+            if x >= 0 and bits & (1 << (31 - c)):
+                columns[x] |= 1 << y
+    # glyphs without ink (e.g. the space) keep their advance width
+    if not any(columns):
+        columns = [0] * max(dwidth - 1, 1)
+    return columns
+
+
+def glyph_comment(code):
+    char = chr(code)
+    if char in "\\*/" or not char.isprintable():
+        char = "?"
+    return char
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.split("\n")[0])
+    parser.add_argument("bdf")
+    parser.add_argument("name")
+    parser.add_argument("--first", default=" ",
+                        help="first character of the font (default: space)")
+    parser.add_argument("--last", default="~",
+                        help="last character of the font (default: ~)")
+    parser.add_argument("--text", help="only keep the glyphs used in this file")
+    parser.add_argument("--extra", default="",
+                        help="further characters beyond the range")
+    layout = parser.add_mutually_exclusive_group()
+    layout.add_argument("--fixed", action="store_true",
+                        help="force the fixed-stride layout")
+    layout.add_argument("--proportional", action="store_true",
+                        help="force the proportional layout")
+    args = parser.parse_args()
+
+    ascent, descent, glyphs = parse_bdf(args.bdf)
+    height = ascent + descent
+    if height > 16:
+        sys.exit("fonts taller than 16 pixels are not supported")
+    storebytes = (height + 7) // 8
+
+    first, last = ord(args.first), ord(args.last)
+    extra = set(ord(c) for c in args.extra)
+    used = None
+    if args.text:
+        with open(args.text, "rb") as f:
+            raw = f.read()
+        try:
+            text = raw.decode("utf-8")
+        except UnicodeDecodeError:
+            text = raw.decode("latin-1")
+        used = set(ord(c) for c in text if first <= ord(c) <= last)
+        used.add(first)  # stands in for characters outside of the range
+        extra |= set(ord(c) for c in text)
+    extra = sorted(c for c in extra if c in glyphs and not first <= c <= last)
+    if any(c > 0xFFFF for c in extra):
+        sys.exit("only code points up to U+FFFF are supported")
+
+    monospaced = len(set(glyphs[c][0] for c in range(first, last + 1)
+                         if c in glyphs)) <= 1
+    fixed = args.fixed or (monospaced and not args.proportional)
+    if fixed and used:
+        first, last = min(used), max(used)
+
+    codes = list(range(first, last + 1)) + extra
+    if len(codes) > 254:
+        sys.exit("a font can't have more than 254 glyphs")
+    columns = {}
+    for code in codes:
+        if code in glyphs and (used is None or code in used or code > last):
+            columns[code] = render(glyphs[code], ascent, height)
+        else:
+            columns[code] = [] if not fixed else [0]
+    if fixed:
+        width = max(len(cols) for cols in columns.values())
+        for code in codes:
+            columns[code] += [0] * (width - len(columns[code]))
+
+    name = args.name
+    out = ['#include "font.h"', ""]
+    if not fixed:
+        out.append("unsigned int const fontIndex_%s[] PROGMEM = {" % name)
+        offset = 0
+        for code in codes:
+            out.append("\t%d, /* %s */" % (offset, glyph_comment(code)
+                       if code <= last else "U+%04X" % code))
+            offset += len(columns[code]) * storebytes
+        out.append("\t%d" % offset)
+        out += ["};", ""]
+
+    out.append("unsigned char const fontData_%s[] PROGMEM = {" % name)
+    for code in codes:
+        if code <= last:
+            out.append("\t/* character %s / ASCII code %d */"
+                       % (glyph_comment(code), code))
+        else:
+            out.append("\t/* character U+%04X */" % code)
+        for col in columns[code]:
+            data = ", ".join("0x%02x" % ((col >> (8 * i)) & 0xff)
+                             for i in range(storebytes))
+            pixels = "".join("#" if col & (1 << b) else "."
+                             for b in reversed(range(8 * storebytes)))
+            out.append("\t%s, /* %s */" % (data, pixels))
+    out += ["};", ""]
+
+    # runs of consecutive code points share a range
+    ranges = []
+    for glyph, code in enumerate(extra, last + 1 - first):
+        if ranges and ranges[-1][0] + ranges[-1][1] == code \
+                and ranges[-1][1] < 255:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([code, 1, glyph])
+    if ranges:
+        out.append("glyph_range const glyphRanges_%s[] PROGMEM = {" % name)
+        for code, count, glyph in ranges:
+            out.append("\t{0x%04X, %d, %d}," % (code, count, glyph))
+        out += ["};", ""]
+
+    # glyph_end is exclusive, see scrolltext3.c
+    out.append("font font_%s = {%d, %s, fontData_%s, %d, %d, '.', %d, %d, %s, "
+               "%d};"
+               % (name, height, "0" if fixed else "fontIndex_" + name, name,
+                  first, last + 1, storebytes, width if fixed else 0,
+                  "glyphRanges_" + name if ranges else "0", len(ranges)))
+
+    with open("font_%s.c" % name, "w", encoding="latin-1") as f:
+        f.write("\n".join(out) + "\n")
+
+    guard = "FONT_%s_H" % name.upper()
+    with open("font_%s.h" % name, "w") as f:
+        f.write("#ifndef %s\n#define %s\n\n#include \"font.h\"\n"
+                "extern font font_%s;\n\n#endif /* %s */\n"
+                % (guard, guard, name, guard))
+
+
+if __name__ == "__main__":
+    main()
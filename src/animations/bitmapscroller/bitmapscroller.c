@@ -15,6 +15,7 @@
 
 #include "../../random/prng.h"
 #include "../../util.h"
+#include "../../frame_pacer.h"
 #include "../../autoconf.h"
 #include "../../pixel.h"
 #include "bitmapscroller.h"
@@ -223,6 +224,9 @@ void bitmap_scroll(unsigned char const nWidth,
 	signed char dx = 0;
 	signed char dy = 0;
 
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, nTick);
+
 	for (unsigned int i = 0; i < nTickCount; ++i)
 	{
 		bitmap_drawViewport(&bitmap, x, y);
@@ -243,7 +247,7 @@ void bitmap_scroll(unsigned char const nWidth,
 			x += bitmap.nWidth > bitmap.nViewportWidth ? dx : 0;
 			y += bitmap.nHeight > bitmap.nViewportHeight ? dy : 0;
 		}
-		wait(nTick);
+		next_frame(&pacer);
 	}
 }
 
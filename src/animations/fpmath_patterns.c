@@ -15,6 +15,8 @@
 #include "../config.h"
 #include "../pixel.h"
 #include "../util.h"
+#include "../compositor.h"
+#include "../frame_pacer.h"
 #include "fpmath_patterns.h"
 
 
@@ -333,7 +335,7 @@ typedef unsigned char (*fpmath_pattern_func_t)(unsigned char const x,
  * @param t_start  A start value for the function's step variable.
  * @param t_stop A stop value for the function's step variable.
  * @param t_delta Value by which the function's step variable gets incremented.
- * @param frame_delay The frame delay in milliseconds.
+ * @param frame_delay The target frame period in milliseconds.
  * @param fpPattern Function which generates a pattern depending on x, y and t.
  * @param r A pointer to persistent data required by the fpPattern function.
  */
@@ -344,60 +346,36 @@ static void fixDrawPattern(fixp_t const t_start,
                            fpmath_pattern_func_t fpPattern,
                            void *r)
 {
-	// off-screen buffer
-	unsigned char pOffScreen[NUMPLANE + 1][NUM_ROWS][LINEBYTES];
+	// off-screen buffer, the patterns only yield NUMPLANE + 1 levels, so four
+	// bits per pixel are plenty
+	intensity4_buf_t offScreen;
+
+	// the render time gets deducted from the frame delay
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, frame_delay);
 
 	for (fixp_t t = t_start; t < t_stop; t += t_delta)
 	{
-		// For performance reasons the pattern is drawn to an off-screen buffer
-		// without distributing bits of higher planes down to lower ones.
-		ptrdiff_t nRowColOffset = 0;
+		// The pattern is drawn to an off-screen buffer first, so that the
+		// frame buffer gets updated in one go by the compositor.
+		uint8_t *pOffScreen = &offScreen[0][0];
 		for (unsigned char y = 0; y < UNUM_ROWS; ++y)
 		{
-			for (unsigned char x = 0; x < (LINEBYTES * 8u); ++x)
+			for (unsigned char x = 0; x < UNUM_COLS; x += 2)
 			{
-				// Since multidimensional subscript expressions are rather
-				// expensive, we just resolve the first dimension (which
-				// represents the plane) and add an offset that correlates to
-				// the currently processed row and column.
-				*(&pOffScreen[fpPattern(x, y, t, r)][0][0] + nRowColOffset) |=
-						shl_table[x % 8u];
-
-				// increment the offset after completion of a byte
-				if ((x % 8u) == 7u)
+				// even columns go to the low nibble, odd ones to the high one
+				uint8_t nPair = COMPOSITOR_LEVEL4(fpPattern(x, y, t, r));
+				if ((x + 1) < UNUM_COLS)
 				{
-					nRowColOffset++;
+					nPair |= COMPOSITOR_LEVEL4(fpPattern(x + 1, y, t, r)) << 4;
 				}
+				*pOffScreen++ = nPair;
 			}
 		}
-
-		// one byte behind the frame buffer
-		unsigned char *pPixmap =
-				(&pixmap[NUMPLANE - 1][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-		// one byte behind the off-screen buffer
-		unsigned char *pOffscreenDistHigh =
-				(&pOffScreen[NUMPLANE][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-		// one byte behind the second last plane of the off-screen buffer
-		unsigned char *pOffscreenDistLow =
-				(&pOffScreen[NUMPLANE - 1][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-
-		// Here we transcribe the off-screen contents to the actual frame buffer
-		// by distributing down 8 bits in parallel per iteration. We start at
-		// the end of both buffers and move backwards through their space.
-		// The pre-decrement operator is used so that GCC utilizes the AVR's
-		// built-in pre-decrement variants of the "ld" and "st" instructions.
-		while (pPixmap != &pixmap[0][0][0]) // stop at the beginning
-		{
-			// actually draw off-screen contents
-			*(--pPixmap) = *(--pOffscreenDistHigh);
-			// distribute bits down to the next lower plane
-			*(--pOffscreenDistLow) |= *pOffscreenDistHigh;
-			// clear already drawn off-screen contents
-			*pOffscreenDistHigh = 0;
-		}
+		compositor_flush4(offScreen, false);
 
 		// wait a moment to ensure that the current frame is visible
-		wait(frame_delay);
+		next_frame(&pacer);
 	}
 }
 
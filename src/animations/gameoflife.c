@@ -262,19 +262,15 @@ static void insertglider(field_t pf) {
 
 static void pfinit(field_t pf)
 {
-	coord_t x, y;
 #ifndef BITSTUFFED
+	coord_t x, y;
 	for (y = YSIZE; y--;) {
 		for (x = XSIZE; x--;) {
-			setcell(pf, x, y, (random8() & 1) ? alive : dead);
+			setcell(pf, x, y, (random_fast8() & 1) ? alive : dead);
 		}
 	}
 #else
-	for (y = 0; y < FIELD_YSIZE; ++y) {
-		for (x = 0; x < FIELD_XSIZE; ++x) {
-			pf[y][x] = random8();
-		}
-	}
+	random_fill(pf, sizeof(field_t));
 #endif
 }
 
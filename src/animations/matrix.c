@@ -1,9 +1,11 @@
 
 #include "../config.h"
 #include <stdint.h>
+#include <string.h>
 #include "../random/prng.h"
 #include "../pixel.h"
 #include "../util.h"
+#include "../compositor.h"
 
 #ifndef MATRIX_CYCLES
 	#define MATRIX_CYCLES 500
@@ -23,27 +25,10 @@ typedef struct{
 	unsigned char speed;
 } streamer;
 
-typedef uint8_t pixel_matrix_t[NUM_COLS][NUM_ROWS/4];
-
-inline static uint8_t get_bright(pixel_matrix_t *matrix, uint8_t x, uint8_t y){
-	uint8_t ret;
-	ret = (*matrix)[x][y/4];
-	return 0x3&(ret>>(2*(y%4)));
-}
-
-inline static void set_bright(pixel_matrix_t *matrix, uint8_t x, uint8_t y, uint8_t value){
-	uint8_t t;
-	t = (*matrix)[x][y/4];
-	t &= ~(0x3<<(2*(y%4)));
-	t |= value<<(2*(y%4));
-	(*matrix)[x][y/4] = t;
-}
-
 void matrix() {
 	unsigned int counter = MATRIX_CYCLES;
 	streamer streamers[MATRIX_STREAMER_NUM];
-	pixel_matrix_t matrix_bright;
-	unsigned char x, y;
+	intensity4_buf_t matrix_bright;
 	unsigned char index = 0;
 	unsigned char draw;
 	unsigned char streamer_num = 0;
@@ -51,9 +36,7 @@ void matrix() {
 	while(counter--){
 		unsigned char i, j;
 		/* initialise matrix-buffer */
-		for(x=0;x<NUM_COLS;x++)
-			for(y=0;y<NUM_ROWS/4;y++)
-				matrix_bright[x][y]=0;
+		memset(matrix_bright, 0, sizeof(matrix_bright));
 
 		for(i=0;i<streamer_num;i++){
 			streamer str = streamers[i];
@@ -63,9 +46,8 @@ void matrix() {
 				if(j+str.start.y<NUM_ROWS){
 					if(bright>>6) /* bright>>6 */
 						draw = 1;
-					if(bright > (get_bright(&matrix_bright, str.start.x, str.start.y+j)<<6) ){
-						set_bright(&matrix_bright, str.start.x, str.start.y+j, bright>>6);
-
+					if((bright>>4) > intensity4_get(matrix_bright, str.start.x, str.start.y+j)){
+						intensity4_set(matrix_bright, str.start.x, str.start.y+j, bright>>4);
 					}
 				}
 				bright-=((bright>>5)*str.decay);
@@ -82,17 +64,15 @@ void matrix() {
 			}
 		}
 
-		for(y=NUM_ROWS;y--;)
-			for(x=NUM_COLS;x--;){
-				setpixel((pixel){x,y}, get_bright(&matrix_bright,x,y));
-			}
+		/* the decay of the streamers is smoothed by dithering */
+		compositor_flush4(matrix_bright, true);
 
 		unsigned char nsc;
 		for(nsc=0;nsc<6;nsc++){
 			if(streamer_num<MATRIX_STREAMER_NUM){
-				unsigned char sy = random8()%(2*NUM_ROWS);
+				unsigned char sy = random_fast8()%(2*NUM_ROWS);
 				if (sy>NUM_ROWS-1) sy=0;
-				streamers[streamer_num] = (streamer){{random8()%NUM_COLS, sy}, 0, (random8()%8)+12, index++,(random8()%16)+3};
+				streamers[streamer_num] = (streamer){{random_fast8()%NUM_COLS, sy}, 0, (random_fast8()%8)+12, index++,(random_fast8()%16)+3};
 				streamer_num++;
 			}
 		}
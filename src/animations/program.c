@@ -174,16 +174,7 @@ void fire()
  */
 void random_bright(unsigned int cycles) {
 	while (cycles--) {
-		for (unsigned char p = NUMPLANE; p--;) {
-			for (unsigned char y = NUM_ROWS; y--;) {
-				for (unsigned char x = LINEBYTES; x--;) {
-					if (p < (NUMPLANE - 1)) {
-						pixmap[p][y][x] |= pixmap[p + 1][y][x];
-					}
-					pixmap[p][y][x] = random8();
-				}
-			}
-		}
+		random_fill(pixmap, sizeof(pixmap));
 		wait(200);
 	}
 }
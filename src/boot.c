@@ -0,0 +1,81 @@
+/**
+ * @file boot.c
+ * @brief Deferred initialization of slow peripherals.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "util.h"
+#include "boot.h"
+
+#ifdef RANDOM_SUPPORT
+#	include "random/prng.h"
+#	include "kvstore.h"
+#endif
+
+#ifdef RFM12_SUPPORT
+#	include "rfm12/borg_rfm12.h"
+#endif
+
+/** the RFM12 module needs some time after power-up before it takes commands */
+#define BOOT_RFM12_DELAY 200u
+
+
+uint8_t boot_pending;
+tick_t boot_first_frame;
+
+#ifdef RANDOM_SUPPORT
+/** reset counter which waits for being written back */
+static uint32_t boot_nResets;
+#endif
+
+
+void boot_init(void)
+{
+	uint8_t nPending = BOOT_FIRST_FRAME;
+
+#ifdef RANDOM_SUPPORT
+	// reading is fast, only the write-back (several ms per byte) is deferred
+	kv_get(KV_RESET_COUNTER, &boot_nResets, sizeof(boot_nResets));
+	srandom32(boot_nResets++);
+	nPending |= BOOT_RESET_COUNTER;
+#endif
+
+#ifdef RFM12_SUPPORT
+	nPending |= BOOT_RFM12;
+#endif
+
+	boot_pending = nPending;
+}
+
+
+void boot_service(void)
+{
+	// the display loop only calls wait() after it has drawn something
+	if (boot_pending & BOOT_FIRST_FRAME)
+	{
+		boot_first_frame = get_tick();
+		boot_pending &= ~BOOT_FIRST_FRAME;
+		return;
+	}
+
+#ifdef RANDOM_SUPPORT
+	if (boot_pending & BOOT_RESET_COUNTER)
+	{
+		kv_set(KV_RESET_COUNTER, &boot_nResets, sizeof(boot_nResets));
+		boot_pending &= ~BOOT_RESET_COUNTER;
+		return;
+	}
+#endif
+
+#ifdef RFM12_SUPPORT
+	// the tick starts at zero, so it can't have wrapped around yet
+	if ((boot_pending & BOOT_RFM12) && (get_tick() >= BOOT_RFM12_DELAY))
+	{
+		borg_rfm12_init();
+		boot_pending &= ~BOOT_RFM12;
+	}
+#endif
+}
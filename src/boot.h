@@ -0,0 +1,65 @@
+/**
+ * @file boot.h
+ * @brief Deferred initialization of slow peripherals.
+ *
+ * main() only brings up what is needed to get the first animation onto the
+ * display. Everything that would hold the first frame back (the power-up
+ * delay of the RFM12 module and the EEPROM write of the reset counter) is
+ * left to boot_service(), which gets called by wait() in the background
+ * until all jobs are done.
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "util.h"
+
+/** jobs which are still pending after main() has started the display loop */
+enum boot_job_e
+{
+	BOOT_FIRST_FRAME    = 0x01, /**< first frame not yet finished */
+	BOOT_RESET_COUNTER  = 0x02, /**< incremented reset counter not yet saved */
+	BOOT_RFM12          = 0x04  /**< RFM12 module not yet initialized */
+};
+#ifdef NDEBUG
+	typedef uint8_t boot_job_t;
+#else
+	typedef enum boot_job_e boot_job_t;
+#endif
+
+
+/** bit mask of pending jobs, zero once booting is complete */
+extern uint8_t boot_pending;
+
+/** milliseconds from tick_init() to the end of the first frame */
+extern tick_t boot_first_frame;
+
+
+/**
+ * Seeds the PRNG and schedules the jobs for boot_service(). Has to be called
+ * after tick_init() and before the display loop starts.
+ */
+void boot_init(void);
+
+
+/**
+ * Runs all pending jobs which are due. Gets called by wait() as long as
+ * boot_pending isn't zero.
+ */
+void boot_service(void);
+
+
+/**
+ * Tells if a job is done, i.e. if its subsystem may be used.
+ * @param nJob the job in question
+ * @return true if the job is done
+ */
+inline static bool boot_isDone(boot_job_t nJob)
+{
+	return !(boot_pending & nJob);
+}
+
+#endif /* BOOT_H_ */
@@ -11,6 +11,14 @@
 	unsigned char framebuf[NUM_ROWS][NUM_COLS];
 #endif /* BORG_FRAMEBUF */
 
+#ifdef TEMPORAL_DITHER_SUPPORT
+	// incremented by the display interrupt each time a frame has been shown
+	extern volatile unsigned char borg_hw_frame_count;
+#	define BORG_HW_FRAME_FLIP() (++borg_hw_frame_count)
+#else
+#	define BORG_HW_FRAME_FLIP()
+#endif
+
 void watchdog_enable();
 void borg_hw_init();
 void timer0_off();
@@ -5,6 +5,12 @@
 #include <avr/io.h>
 #include <avr/wdt.h>
 #include "borg_hw.h"
+#ifdef BCM_SUPPORT
+#	include "borg_hw_bcm.h"
+#	define TIMER0_CS BCM_CS_BITS
+#else
+#	define TIMER0_CS _BV(CS02)
+#endif
 
 
 #define COLDDR1  DDR(COLPORT1)
@@ -20,14 +26,14 @@
     defined(__AVR_ATmega1284__)  || \
     defined(__AVR_ATmega1284P__)
 #	define TIMER0_OFF()        TIMSK0 &= ~(OCIE0A); TCCR0A = 0; TCCR0B = 0
-#	define TIMER0_CTC_CS256()  TCCR0A = _BV(WGM01); TCCR0B = _BV(CS02)
+#	define TIMER0_CTC()        TCCR0A = _BV(WGM01); TCCR0B = TIMER0_CS
 #	define TIMER0_RESET()      TCNT0  = 0
 #	define TIMER0_COMPARE(t)   OCR0A  = t
 #	define TIMER0_INT_ENABLE() TIMSK0 |= _BV(OCIE0A)
 #	define TIMER0_ISR          TIMER0_COMPA_vect
 #else // ATmega16/32
 #	define TIMER0_OFF()        TIMSK &= ~(OCIE0); TCCR0 = 0
-#	define TIMER0_CTC_CS256()  TCCR0 = _BV(WGM01) | _BV(CS02)
+#	define TIMER0_CTC()        TCCR0 = _BV(WGM01) | TIMER0_CS
 #	define TIMER0_RESET()      TCNT0 = 0
 #	define TIMER0_COMPARE(t)   OCR0  = t
 #	define TIMER0_INT_ENABLE() TIMSK |= _BV(OCIE0)
@@ -84,7 +90,11 @@ static void nextrow(uint8_t row) {
 static void rowshow(unsigned char row, unsigned char plane) {
 	// depending on the currently drawn plane, display the row for a specific
 	// amount of time
+#ifdef BCM_SUPPORT
+	static unsigned char const ocr_table[] = BCM_OCR_TABLE;
+#else
 	static unsigned char const ocr_table[] = {2, 5, 22};
+#endif
 
 	TIMER0_COMPARE(ocr_table[plane]);
 
@@ -107,6 +117,7 @@ ISR(TIMER0_ISR) {
 			wdt_reset();
 
 			row = 0;
+			BORG_HW_FRAME_FLIP();
 		}
 		nextrow(row);
 	}
@@ -129,7 +140,7 @@ void timer0_off() {
 
 // initialize timer which triggers the interrupt
 static void timer0_on() {
-	TIMER0_CTC_CS256();  // CTC mode, prescaling conforms to clk/256
+	TIMER0_CTC();        // CTC mode, prescaling usually conforms to clk/256
 	TIMER0_RESET();      // set counter to 0
 	TIMER0_COMPARE(20);  // compare with this value first
 	TIMER0_INT_ENABLE(); // enable Timer/Counter0 Output Compare Match (A) Int.
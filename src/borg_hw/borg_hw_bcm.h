@@ -0,0 +1,87 @@
+/**
+ * @file borg_hw_bcm.h
+ * @brief Gamma-corrected plane timing for the shift register based drivers.
+ *
+ * These drivers multiplex the rows and show each plane of a row for a specific
+ * amount of time. Since planes are lit in ascending order (a pixel with
+ * brightness level L is lit on the planes 0..L-1), the perceived brightness of
+ * level L is the sum of the times of its planes. So the time of plane p is the
+ * difference of the gamma curve between the levels p + 1 and p, scaled to the
+ * time which is available for one row at the configured FRAMERATE. All values
+ * are folded into constants by the compiler.
+ */
+
+#ifndef BORG_HW_BCM_H_
+#define BORG_HW_BCM_H_
+
+#include <avr/io.h>
+#include "../config.h"
+
+#if NUMPLANE > 8
+#	error BCM plane timing supports at most 8 planes
+#endif
+
+/** Number of multiplexed rows, drivers may override this. */
+#ifndef BCM_MUX_ROWS
+#	define BCM_MUX_ROWS NUM_ROWS
+#endif
+
+/** CPU cycles an ISR call takes at least (including the row switch). */
+#define BCM_MIN_CYCLES 160ul
+
+// use the finer prescaler if a whole row fits into the 8 bit timer
+#if (F_CPU / 64ul / (FRAMERATE * BCM_MUX_ROWS)) <= 256ul
+#	define BCM_PRESCALER 64ul
+#	define BCM_CS_BITS   (_BV(CS01) | _BV(CS00))
+#else
+#	define BCM_PRESCALER 256ul
+#	define BCM_CS_BITS   _BV(CS02)
+#	if (F_CPU / 256ul / (FRAMERATE * BCM_MUX_ROWS)) > 256ul
+#		error FRAMERATE is too low for BCM plane timing
+#	endif
+#endif
+
+/** Timer ticks which are available for one row. */
+#define BCM_ROW_TICKS \
+	((double)(F_CPU / BCM_PRESCALER) / ((double)FRAMERATE * BCM_MUX_ROWS))
+
+/** Minimum amount of timer ticks per plane. */
+#define BCM_MIN_TICKS \
+	((double)((BCM_MIN_CYCLES + BCM_PRESCALER - 1) / BCM_PRESCALER))
+
+/** Relative brightness (0..1) of a given level. */
+#define BCM_CURVE(level) \
+	__builtin_pow((double)(level) / NUMPLANE, BCM_GAMMA / 10.0)
+
+/** Timer ticks of a given plane, limited to the range of the timer. */
+#define BCM_TICKS(plane) \
+	(BCM_ROW_TICKS * (BCM_CURVE((plane) + 1) - BCM_CURVE(plane)) + 0.5)
+#define BCM_CLAMP(t) \
+	((t) < BCM_MIN_TICKS ? BCM_MIN_TICKS : ((t) > 256.0 ? 256.0 : (t)))
+
+/** Output compare value of a given plane (the timer counts from 0 to OCR). */
+#define BCM_OCR(plane) ((unsigned char)(BCM_CLAMP(BCM_TICKS(plane)) - 1.0))
+
+#if NUMPLANE == 1
+#	define BCM_OCR_TABLE {BCM_OCR(0)}
+#elif NUMPLANE == 2
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1)}
+#elif NUMPLANE == 3
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2)}
+#elif NUMPLANE == 4
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2), BCM_OCR(3)}
+#elif NUMPLANE == 5
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2), BCM_OCR(3), \
+		BCM_OCR(4)}
+#elif NUMPLANE == 6
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2), BCM_OCR(3), \
+		BCM_OCR(4), BCM_OCR(5)}
+#elif NUMPLANE == 7
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2), BCM_OCR(3), \
+		BCM_OCR(4), BCM_OCR(5), BCM_OCR(6)}
+#else
+#	define BCM_OCR_TABLE {BCM_OCR(0), BCM_OCR(1), BCM_OCR(2), BCM_OCR(3), \
+		BCM_OCR(4), BCM_OCR(5), BCM_OCR(6), BCM_OCR(7)}
+#endif
+
+#endif /* BORG_HW_BCM_H_ */
@@ -31,6 +31,14 @@
 
 #define MUX_ROWS        4
 
+#ifdef BCM_SUPPORT
+#	define BCM_MUX_ROWS MUX_ROWS
+#	include "borg_hw_bcm.h"
+#	define TIMER0_CS BCM_CS_BITS
+#else
+#	define TIMER0_CS _BV(CS02)
+#endif
+
 #if defined (__AVR_ATmega644P__) || defined (__AVR_ATmega644__) || (__AVR_ATmega1284P__) || defined (__AVR_ATmega1284__)
 	/* more ifdef magic :-( */
 	#define OCR0 OCR0A
@@ -142,7 +150,11 @@ static inline unsigned short bitgeschubse2(unsigned short x_in) {
 static void rowshow(unsigned char row, unsigned char plane) {
 	// depending on the currently drawn plane, display the row for a specific
 	// amount of time
+#ifdef BCM_SUPPORT
+	static unsigned char const ocr_table[] = BCM_OCR_TABLE;
+#else
 	static unsigned char const ocr_table[] = { 3, 4, 22 };
+#endif
 	unsigned char i;
 	union u {
 		unsigned short sValue;
@@ -268,6 +280,7 @@ ISR( TIMER0_COMP_vect) {
 		plane = 0;
 		if (++row == MUX_ROWS) {
 			row = 0;
+			BORG_HW_FRAME_FLIP();
 		}
 	}
 
@@ -307,12 +320,12 @@ static void timer0_on() {
 
 #if defined (__AVR_ATmega644P__) || defined (__AVR_ATmega644__) || (__AVR_ATmega1284P__) || defined (__AVR_ATmega1284__)
 	TCCR0A = 0x02; // CTC Mode
-	TCCR0B = 0x04; // clk/256
+	TCCR0B = TIMER0_CS; // usually clk/256
 	TCNT0  =    0; // reset timer
 	OCR0   =   20; // compare with this value
 	TIMSK0 = 0x02; // compare match Interrupt on
 #else
-	TCCR0 = 0x0C; // CTC Mode, clk/256
+	TCCR0 = _BV(WGM01) | TIMER0_CS; // CTC Mode, usually clk/256
 	TCNT0 =    0; // reset timer
 	OCR0  =   20; // compare with this value
 	TIMSK = 0x02; // compare match Interrupt on
@@ -167,8 +167,24 @@ uint8_t prescaler[NUMPLANE + 1] = {0};
 #	error BRIGHTNESS must be between 0 and 127
 #endif
 
+// Worst case CPU cycles of compose_cycle() (up to 11 LEDs per cycle and four
+// source ports) plus the interrupt overhead, generously rounded up.
+#define COMPOSE_CYCLES (120ul + 11ul * (40ul + 10ul * NUMPLANE))
+
+// The next cycle gets composed while the dark plane is shown, so the dark plane
+// has to last at least this many ticks of the slow prescaler.
+#define COMPOSE_TICKS ((COMPOSE_CYCLES + (1ul << SLOWSCALERSHIFT) - 1) >> \
+	SLOWSCALERSHIFT)
+
+#if COMPOSE_TICKS >= TICKS
+#	error FRAMERATE is too high to compose the cycles in time
+#endif
+
+// The lit planes only get the ticks which are left over by compose_cycle().
+#define LIT_TICKS (TICKS - COMPOSE_TICKS)
+
 #define BRIGHTNESSPERCENT ((BRIGHTNESS * BRIGHTNESS + 8ul) / 16ul)
-#define M (TICKS << FASTSCALERSHIFT) * BRIGHTNESSPERCENT /*10b*/
+#define M (LIT_TICKS << FASTSCALERSHIFT) * BRIGHTNESSPERCENT /*10b*/
 #define C(x) ((M * (unsigned long)(x * 1024UL) + (1UL << 19)) >> 20) /*10b+10b-20b=0b*/
 
 #define COUNT(u, v) (256 - (((C(v) - C(u)) != 0) ? (C(v) - C(u)) : 1))
@@ -255,14 +271,198 @@ static void setBrightness()
 }
 #endif
 
+/*
+ * The LoL Shield is driven through the Arduino pins D2..D13. During each of the
+ * 12 cycles, pin D(cycle + 2) sinks the current while the other pins source
+ * the LEDs of that cycle. The following macros map those pins to the ports of
+ * the supported Arduino variants (port index, pin mask), so the LED table
+ * below resolves to port images at compile time.
+ */
+#if defined (__AVR_ATmega1280__) || defined (__AVR_ATmega2560__)
+#	define SOURCE_PORTS 4
+#	define PORT_B 0
+#	define PORT_E 1
+#	define PORT_G 2
+#	define PORT_H 3
+#	define PIN_D2  PORT_E, 0x10
+#	define PIN_D3  PORT_E, 0x20
+#	define PIN_D4  PORT_G, 0x20
+#	define PIN_D5  PORT_E, 0x08
+#	define PIN_D6  PORT_H, 0x08
+#	define PIN_D7  PORT_H, 0x10
+#	define PIN_D8  PORT_H, 0x20
+#	define PIN_D9  PORT_H, 0x40
+#	define PIN_D10 PORT_B, 0x10
+#	define PIN_D11 PORT_B, 0x20
+#	define PIN_D12 PORT_B, 0x40
+#	define PIN_D13 PORT_B, 0x80
+#elif defined (__AVR_ATmega32U4__)
+#	define SOURCE_PORTS 4
+#	define PORT_B 0
+#	define PORT_C 1
+#	define PORT_D 2
+#	define PORT_E 3
+#	define PIN_D2  PORT_D, 0x02
+#	define PIN_D3  PORT_D, 0x01
+#	define PIN_D4  PORT_D, 0x10
+#	define PIN_D5  PORT_C, 0x40
+#	define PIN_D6  PORT_D, 0x80
+#	define PIN_D7  PORT_E, 0x40
+#	define PIN_D8  PORT_B, 0x10
+#	define PIN_D9  PORT_B, 0x20
+#	define PIN_D10 PORT_B, 0x40
+#	define PIN_D11 PORT_B, 0x80
+#	define PIN_D12 PORT_D, 0x40
+#	define PIN_D13 PORT_C, 0x80
+#else
+#	define SOURCE_PORTS 2
+#	define PORT_D 0
+#	define PORT_B 1
+#	define PIN_D2  PORT_D, 0x04
+#	define PIN_D3  PORT_D, 0x08
+#	define PIN_D4  PORT_D, 0x10
+#	define PIN_D5  PORT_D, 0x20
+#	define PIN_D6  PORT_D, 0x40
+#	define PIN_D7  PORT_D, 0x80
+#	define PIN_D8  PORT_B, 0x01
+#	define PIN_D9  PORT_B, 0x02
+#	define PIN_D10 PORT_B, 0x04
+#	define PIN_D11 PORT_B, 0x08
+#	define PIN_D12 PORT_B, 0x10
+#	define PIN_D13 PORT_B, 0x20
+#endif
+
+/** A pin of a port. */
+typedef struct lolshield_pin_s {
+	uint8_t port; /**< index of the port within a port image */
+	uint8_t mask; /**< bit mask of the pin */
+} lolshield_pin_t;
+
+/** Assignment of a pixel to the pin which sources its LED. */
+typedef struct lolshield_led_s {
+	uint8_t offset;         /**< byte offset of the pixel within a plane */
+	uint8_t mask;           /**< bit mask of the pixel within that byte */
+	lolshield_pin_t source; /**< pin which sources the LED */
+} lolshield_led_t;
+
+#define LED(x, y, pin) {(y) * LINEBYTES + (x) / 8, 1u << ((x) % 8), {pin}}
+
+/** Sink pins of the cycles. */
+static lolshield_pin_t const PROGMEM sinks[12] = {
+	{PIN_D2},  {PIN_D3},  {PIN_D4},  {PIN_D5},  {PIN_D6},  {PIN_D7},
+	{PIN_D8},  {PIN_D9},  {PIN_D10}, {PIN_D11}, {PIN_D12}, {PIN_D13}
+};
+
+/** LEDs of all cycles. NOTE: (0,0) is UPPER RIGHT in the Borgware realm */
+static lolshield_led_t const PROGMEM leds[] = {
+	// cycle  0, sink pin D2
+	LED( 1, 0, PIN_D13), LED( 1, 1, PIN_D12), LED( 1, 2, PIN_D11),
+	LED( 1, 3, PIN_D10), LED( 1, 4, PIN_D9), LED( 1, 5, PIN_D8),
+	LED( 1, 6, PIN_D7), LED( 1, 7, PIN_D6), LED( 1, 8, PIN_D5),
+	// cycle  1, sink pin D3
+	LED( 3, 0, PIN_D13), LED( 3, 1, PIN_D12), LED( 3, 2, PIN_D11),
+	LED( 3, 3, PIN_D10), LED( 3, 4, PIN_D9), LED( 3, 5, PIN_D8),
+	LED( 3, 6, PIN_D7), LED( 3, 7, PIN_D6), LED( 3, 8, PIN_D5),
+	// cycle  2, sink pin D4
+	LED( 5, 0, PIN_D13), LED( 5, 1, PIN_D12), LED( 5, 2, PIN_D11),
+	LED( 5, 3, PIN_D10), LED( 5, 4, PIN_D9), LED( 5, 5, PIN_D8),
+	LED( 5, 6, PIN_D7), LED( 5, 7, PIN_D6), LED( 5, 8, PIN_D5),
+	// cycle  3, sink pin D5
+	LED( 0, 8, PIN_D2) , LED( 2, 8, PIN_D3), LED( 4, 8, PIN_D4),
+	LED(13, 0, PIN_D13), LED(13, 1, PIN_D12), LED(13, 2, PIN_D11),
+	LED(13, 3, PIN_D10), LED(13, 4, PIN_D9), LED(13, 5, PIN_D8),
+	LED(13, 6, PIN_D7), LED(13, 7, PIN_D6),
+	// cycle  4, sink pin D6
+	LED( 0, 7, PIN_D2) , LED( 2, 7, PIN_D3), LED( 4, 7, PIN_D4),
+	LED(12, 0, PIN_D13), LED(12, 1, PIN_D12), LED(12, 2, PIN_D11),
+	LED(12, 3, PIN_D10), LED(12, 4, PIN_D9), LED(12, 5, PIN_D8),
+	LED(12, 6, PIN_D7), LED(13, 8, PIN_D5),
+	// cycle  5, sink pin D7
+	LED( 0, 6, PIN_D2) , LED( 2, 6, PIN_D3), LED( 4, 6, PIN_D4),
+	LED(11, 0, PIN_D13), LED(11, 1, PIN_D12), LED(11, 2, PIN_D11),
+	LED(11, 3, PIN_D10), LED(11, 4, PIN_D9), LED(11, 5, PIN_D8),
+	LED(12, 7, PIN_D6), LED(12, 8, PIN_D5),
+	// cycle  6, sink pin D8
+	LED( 0, 5, PIN_D2) , LED( 2, 5, PIN_D3), LED( 4, 5, PIN_D4),
+	LED(10, 0, PIN_D13), LED(10, 1, PIN_D12), LED(10, 2, PIN_D11),
+	LED(10, 3, PIN_D10), LED(10, 4, PIN_D9), LED(11, 6, PIN_D7),
+	LED(11, 7, PIN_D6), LED(11, 8, PIN_D5),
+	// cycle  7, sink pin D9
+	LED( 0, 4, PIN_D2) , LED( 2, 4, PIN_D3), LED( 4, 4, PIN_D4),
+	LED( 9, 0, PIN_D13), LED( 9, 1, PIN_D12), LED( 9, 2, PIN_D11),
+	LED( 9, 3, PIN_D10), LED(10, 5, PIN_D8), LED(10, 6, PIN_D7),
+	LED(10, 7, PIN_D6), LED(10, 8, PIN_D5),
+	// cycle  8, sink pin D10
+	LED( 0, 3, PIN_D2) , LED( 2, 3, PIN_D3), LED( 4, 3, PIN_D4),
+	LED( 8, 0, PIN_D13), LED( 8, 1, PIN_D12), LED( 8, 2, PIN_D11),
+	LED( 9, 4, PIN_D9), LED( 9, 5, PIN_D8), LED( 9, 6, PIN_D7),
+	LED( 9, 7, PIN_D6), LED( 9, 8, PIN_D5),
+	// cycle  9, sink pin D11
+	LED( 0, 2, PIN_D2) , LED( 2, 2, PIN_D3), LED( 4, 2, PIN_D4),
+	LED( 7, 0, PIN_D13), LED( 7, 1, PIN_D12), LED( 8, 3, PIN_D10),
+	LED( 8, 4, PIN_D9), LED( 8, 5, PIN_D8), LED( 8, 6, PIN_D7),
+	LED( 8, 7, PIN_D6), LED( 8, 8, PIN_D5),
+	// cycle 10, sink pin D12
+	LED( 0, 1, PIN_D2) , LED( 2, 1, PIN_D3), LED( 4, 1, PIN_D4),
+	LED( 6, 0, PIN_D13), LED( 7, 2, PIN_D11), LED( 7, 3, PIN_D10),
+	LED( 7, 4, PIN_D9), LED( 7, 5, PIN_D8), LED( 7, 6, PIN_D7),
+	LED( 7, 7, PIN_D6), LED( 7, 8, PIN_D5),
+	// cycle 11, sink pin D13
+	LED( 0, 0, PIN_D2) , LED( 2, 0, PIN_D3), LED( 4, 0, PIN_D4),
+	LED( 6, 1, PIN_D12), LED( 6, 2, PIN_D11), LED( 6, 3, PIN_D10),
+	LED( 6, 4, PIN_D9), LED( 6, 5, PIN_D8), LED( 6, 6, PIN_D7),
+	LED( 6, 7, PIN_D6), LED( 6, 8, PIN_D5),
+};
+
+/** Index of the first LED of each cycle within the LED table. */
+static uint8_t const PROGMEM cycle_start[12 + 1] = {0, 9, 18, 27, 38, 49, 60, 71, 82, 93, 104, 115, 126};
+
+/** Port images (sink and source pins) of the planes of the current cycle. */
+static uint8_t cycle_image[NUMPLANE + 1][SOURCE_PORTS];
+
+/** Sink pins of the current cycle. */
+static uint8_t cycle_sink[SOURCE_PORTS];
+
+
+/**
+ * Distributes the framebuffer content among the port images of a cycle. This
+ * happens once per cycle while the dark plane is shown, so the planes which
+ * are actually lit only need to output their precomposed image.
+ * @param cycle The cycle whose port images should to be composed.
+ */
+static void compose_cycle(uint8_t const cycle) {
+	uint8_t const sink_port = pgm_read_byte(&sinks[cycle].port);
+	uint8_t const sink_mask = pgm_read_byte(&sinks[cycle].mask);
+	for (uint8_t port = 0; port < SOURCE_PORTS; ++port) {
+		uint8_t const sink = (port == sink_port) ? sink_mask : 0;
+		cycle_sink[port] = sink;
+		for (uint8_t plane = 0; plane < (NUMPLANE + 1); ++plane) {
+			cycle_image[plane][port] = sink;
+		}
+	}
+
+	uint8_t const end = pgm_read_byte(&cycle_start[cycle + 1]);
+	for (uint8_t i = pgm_read_byte(&cycle_start[cycle]); i < end; ++i) {
+		uint8_t const *p = &pixmap[0][0][pgm_read_byte(&leds[i].offset)];
+		uint8_t const mask = pgm_read_byte(&leds[i].mask);
+		uint8_t const port = pgm_read_byte(&leds[i].source.port);
+		uint8_t const pin = pgm_read_byte(&leds[i].source.mask);
+		for (uint8_t plane = 0; plane < NUMPLANE; ++plane) {
+			if (*p & mask) {
+				cycle_image[plane][port] |= pin;
+			}
+			p += NUM_ROWS * LINEBYTES;
+		}
+	}
+}
+
+
 /**
- * Distributes the framebuffer content among current cycle pins.
- * @param cycle The cycle whose pattern should to be composed.
+ * Outputs the precomposed port image of a plane of the current cycle.
  * @param plane The plane ("page" in LoL Shield lingo) to be drawn.
  */
-static void compose_cycle(uint8_t const cycle, uint8_t plane) {
-	// pointer to corresponding bitmap
-	uint8_t *const p = &pixmap[plane][0][0];
+static void show_plane(uint8_t const plane) {
+	uint8_t const *const image = cycle_image[plane];
 
 #if defined (__AVR_ATmega1280__) || defined (__AVR_ATmega2560__)
 	// Set sink pin to Vcc/source, turning off current.
@@ -277,176 +477,14 @@ static void compose_cycle(uint8_t const cycle, uint8_t plane) {
 	DDRG &= ~0x20;
 	DDRH &= ~0x78;
 
-	static uint8_t const PROGMEM sink_b_cycle[] =
-		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x40, 0x80};
-	static uint8_t const PROGMEM sink_e_cycle[] =
-		{0x10, 0x20, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-	static uint8_t const PROGMEM sink_g_cycle[] =
-		{0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-	static uint8_t const PROGMEM sink_h_cycle[] =
-		{0x00, 0x00, 0x00, 0x00, 0x08, 0x10, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00};
-
-	uint8_t pins_b = sink_b = pgm_read_byte(&sink_b_cycle[cycle]);
-	uint8_t pins_e = sink_e = pgm_read_byte(&sink_e_cycle[cycle]);
-	uint8_t pins_g = sink_g = pgm_read_byte(&sink_g_cycle[cycle]);
-	uint8_t pins_h = sink_h = pgm_read_byte(&sink_h_cycle[cycle]);
-
-	// convert framebuffer to LoL Shield cycles on Arduino Mega 1280/2560
-	// NOTE: (0,0) is UPPER RIGHT in the Borgware realm
-	if (plane < NUMPLANE) {
-		switch(cycle) {
-		case 0:
-			if (0x02u & p[ 0]) pins_b |= 0x80; // x= 1, y= 0, mapped pin D13
-			if (0x02u & p[ 2]) pins_b |= 0x40; // x= 1, y= 1, mapped pin D12
-			if (0x02u & p[ 4]) pins_b |= 0x20; // x= 1, y= 2, mapped pin D11
-			if (0x02u & p[ 6]) pins_b |= 0x10; // x= 1, y= 3, mapped pin D10
-			if (0x02u & p[ 8]) pins_h |= 0x40; // x= 1, y= 4, mapped pin D9
-			if (0x02u & p[10]) pins_h |= 0x20; // x= 1, y= 5, mapped pin D8
-			if (0x02u & p[12]) pins_h |= 0x10; // x= 1, y= 6, mapped pin D7
-			if (0x02u & p[14]) pins_h |= 0x08; // x= 1, y= 7, mapped pin D6
-			if (0x02u & p[16]) pins_e |= 0x08; // x= 1, y= 8, mapped pin D5
-			break;
-		case 1:
-			if (0x08u & p[ 0]) pins_b |= 0x80; // x= 3, y= 0, mapped pin D13
-			if (0x08u & p[ 2]) pins_b |= 0x40; // x= 3, y= 1, mapped pin D12
-			if (0x08u & p[ 4]) pins_b |= 0x20; // x= 3, y= 2, mapped pin D11
-			if (0x08u & p[ 6]) pins_b |= 0x10; // x= 3, y= 3, mapped pin D10
-			if (0x08u & p[ 8]) pins_h |= 0x40; // x= 3, y= 4, mapped pin D9
-			if (0x08u & p[10]) pins_h |= 0x20; // x= 3, y= 5, mapped pin D8
-			if (0x08u & p[12]) pins_h |= 0x10; // x= 3, y= 6, mapped pin D7
-			pins_e |= (0x08u & p[16]);         // x= 3, y= 8, mapped pin D5
-			pins_h |= (0x08u & p[14]);         // x= 3, y= 7, mapped pin D6
-			break;
-		case 2:
-			if (0x20u & p[ 0]) pins_b |= 0x80; // x= 5, y= 0, mapped pin D13
-			if (0x20u & p[ 2]) pins_b |= 0x40; // x= 5, y= 1, mapped pin D12
-			if (0x20u & p[ 6]) pins_b |= 0x10; // x= 5, y= 3, mapped pin D10
-			if (0x20u & p[ 8]) pins_h |= 0x40; // x= 5, y= 4, mapped pin D9
-			if (0x20u & p[12]) pins_h |= 0x10; // x= 5, y= 6, mapped pin D7
-			if (0x20u & p[14]) pins_h |= 0x08; // x= 5, y= 7, mapped pin D6
-			if (0x20u & p[16]) pins_e |= 0x08; // x= 5, y= 8, mapped pin D5
-			pins_b |= (0x20u & p[ 4]);         // x= 5, y= 2, mapped pin D11
-			pins_h |= (0x20u & p[10]);         // x= 5, y= 5, mapped pin D8
-			break;
-		case 3:
-			if (0x01u & p[16]) pins_e |= 0x10; // x= 0, y= 8, mapped pin D2
-			if (0x04u & p[16]) pins_e |= 0x20; // x= 2, y= 8, mapped pin D3
-			if (0x10u & p[16]) pins_g |= 0x20; // x= 4, y= 8, mapped pin D4
-			if (0x20u & p[ 1]) pins_b |= 0x80; // x=13, y= 0, mapped pin D13
-			if (0x20u & p[ 3]) pins_b |= 0x40; // x=13, y= 1, mapped pin D12
-			if (0x20u & p[ 7]) pins_b |= 0x10; // x=13, y= 3, mapped pin D10
-			if (0x20u & p[ 9]) pins_h |= 0x40; // x=13, y= 4, mapped pin D9
-			if (0x20u & p[13]) pins_h |= 0x10; // x=13, y= 6, mapped pin D7
-			if (0x20u & p[15]) pins_h |= 0x08; // x=13, y= 7, mapped pin D6
-			pins_b |= (0x20u & p[ 5]);         // x=13, y= 2, mapped pin D11
-			pins_h |= (0x20u & p[11]);         // x=13, y= 5, mapped pin D8
-			break;
-		case 4:
-			if (0x01u & p[14]) pins_e |= 0x10; // x= 0, y= 7, mapped pin D2
-			if (0x04u & p[14]) pins_e |= 0x20; // x= 2, y= 7, mapped pin D3
-			if (0x10u & p[ 1]) pins_b |= 0x80; // x=12, y= 0, mapped pin D13
-			if (0x10u & p[ 3]) pins_b |= 0x40; // x=12, y= 1, mapped pin D12
-			if (0x10u & p[ 5]) pins_b |= 0x20; // x=12, y= 2, mapped pin D11
-			if (0x10u & p[ 9]) pins_h |= 0x40; // x=12, y= 4, mapped pin D9
-			if (0x10u & p[11]) pins_h |= 0x20; // x=12, y= 5, mapped pin D8
-			if (0x10u & p[14]) pins_g |= 0x20; // x= 4, y= 7, mapped pin D4
-			if (0x20u & p[17]) pins_e |= 0x08; // x=13, y= 8, mapped pin D5
-			pins_b |= (0x10u & p[ 7]);         // x=12, y= 3, mapped pin D10
-			pins_h |= (0x10u & p[13]);         // x=12, y= 6, mapped pin D7
-			break;
-		case 5:
-			if (0x01u & p[12]) pins_e |= 0x10; // x= 0, y= 6, mapped pin D2
-			if (0x04u & p[12]) pins_e |= 0x20; // x= 2, y= 6, mapped pin D3
-			if (0x08u & p[ 1]) pins_b |= 0x80; // x=11, y= 0, mapped pin D13
-			if (0x08u & p[ 3]) pins_b |= 0x40; // x=11, y= 1, mapped pin D12
-			if (0x08u & p[ 5]) pins_b |= 0x20; // x=11, y= 2, mapped pin D11
-			if (0x08u & p[ 7]) pins_b |= 0x10; // x=11, y= 3, mapped pin D10
-			if (0x08u & p[ 9]) pins_h |= 0x40; // x=11, y= 4, mapped pin D9
-			if (0x08u & p[11]) pins_h |= 0x20; // x=11, y= 5, mapped pin D8
-			if (0x10u & p[12]) pins_g |= 0x20; // x= 4, y= 6, mapped pin D4
-			if (0x10u & p[15]) pins_h |= 0x08; // x=12, y= 7, mapped pin D6
-			if (0x10u & p[17]) pins_e |= 0x08; // x=12, y= 8, mapped pin D5
-			break;
-		case 6:
-			if (0x01u & p[10]) pins_e |= 0x10; // x= 0, y= 5, mapped pin D2
-			if (0x04u & p[ 1]) pins_b |= 0x80; // x=10, y= 0, mapped pin D13
-			if (0x04u & p[ 3]) pins_b |= 0x40; // x=10, y= 1, mapped pin D12
-			if (0x04u & p[ 5]) pins_b |= 0x20; // x=10, y= 2, mapped pin D11
-			if (0x04u & p[ 7]) pins_b |= 0x10; // x=10, y= 3, mapped pin D10
-			if (0x04u & p[ 9]) pins_h |= 0x40; // x=10, y= 4, mapped pin D9
-			if (0x04u & p[10]) pins_e |= 0x20; // x= 2, y= 5, mapped pin D3
-			if (0x08u & p[13]) pins_h |= 0x10; // x=11, y= 6, mapped pin D7
-			if (0x10u & p[10]) pins_g |= 0x20; // x= 4, y= 5, mapped pin D4
-			pins_e |= (0x08u & p[17]);         // x=11, y= 8, mapped pin D5
-			pins_h |= (0x08u & p[15]);         // x=11, y= 7, mapped pin D6
-			break;
-		case 7:
-			if (0x01u & p[ 8]) pins_e |= 0x10; // x= 0, y= 4, mapped pin D2
-			if (0x02u & p[ 1]) pins_b |= 0x80; // x= 9, y= 0, mapped pin D13
-			if (0x02u & p[ 3]) pins_b |= 0x40; // x= 9, y= 1, mapped pin D12
-			if (0x02u & p[ 5]) pins_b |= 0x20; // x= 9, y= 2, mapped pin D11
-			if (0x02u & p[ 7]) pins_b |= 0x10; // x= 9, y= 3, mapped pin D10
-			if (0x04u & p[ 8]) pins_e |= 0x20; // x= 2, y= 4, mapped pin D3
-			if (0x04u & p[11]) pins_h |= 0x20; // x=10, y= 5, mapped pin D8
-			if (0x04u & p[13]) pins_h |= 0x10; // x=10, y= 6, mapped pin D7
-			if (0x04u & p[15]) pins_h |= 0x08; // x=10, y= 7, mapped pin D6
-			if (0x04u & p[17]) pins_e |= 0x08; // x=10, y= 8, mapped pin D5
-			if (0x10u & p[ 8]) pins_g |= 0x20; // x= 4, y= 4, mapped pin D4
-			break;
-		case 8:
-			if (0x01u & p[ 1]) pins_b |= 0x80; // x= 8, y= 0, mapped pin D13
-			if (0x01u & p[ 3]) pins_b |= 0x40; // x= 8, y= 1, mapped pin D12
-			if (0x01u & p[ 5]) pins_b |= 0x20; // x= 8, y= 2, mapped pin D11
-			if (0x01u & p[ 6]) pins_e |= 0x10; // x= 0, y= 3, mapped pin D2
-			if (0x02u & p[ 9]) pins_h |= 0x40; // x= 9, y= 4, mapped pin D9
-			if (0x02u & p[11]) pins_h |= 0x20; // x= 9, y= 5, mapped pin D8
-			if (0x02u & p[13]) pins_h |= 0x10; // x= 9, y= 6, mapped pin D7
-			if (0x02u & p[15]) pins_h |= 0x08; // x= 9, y= 7, mapped pin D6
-			if (0x02u & p[17]) pins_e |= 0x08; // x= 9, y= 8, mapped pin D5
-			if (0x04u & p[ 6]) pins_e |= 0x20; // x= 2, y= 3, mapped pin D3
-			if (0x10u & p[ 6]) pins_g |= 0x20; // x= 4, y= 3, mapped pin D4
-			break;
-		case 9:
-			if (0x01u & p[ 4]) pins_e |= 0x10; // x= 0, y= 2, mapped pin D2
-			if (0x01u & p[ 7]) pins_b |= 0x10; // x= 8, y= 3, mapped pin D10
-			if (0x01u & p[ 9]) pins_h |= 0x40; // x= 8, y= 4, mapped pin D9
-			if (0x01u & p[11]) pins_h |= 0x20; // x= 8, y= 5, mapped pin D8
-			if (0x01u & p[13]) pins_h |= 0x10; // x= 8, y= 6, mapped pin D7
-			if (0x01u & p[15]) pins_h |= 0x08; // x= 8, y= 7, mapped pin D6
-			if (0x01u & p[17]) pins_e |= 0x08; // x= 8, y= 8, mapped pin D5
-			if (0x04u & p[ 4]) pins_e |= 0x20; // x= 2, y= 2, mapped pin D3
-			if (0x10u & p[ 4]) pins_g |= 0x20; // x= 4, y= 2, mapped pin D4
-			if (0x80u & p[ 2]) pins_b |= 0x40; // x= 7, y= 1, mapped pin D12
-			pins_b |= (0x80u & p[ 0]);         // x= 7, y= 0, mapped pin D13
-			break;
-		case 10:
-			if (0x01u & p[ 2]) pins_e |= 0x10; // x= 0, y= 1, mapped pin D2
-			if (0x04u & p[ 2]) pins_e |= 0x20; // x= 2, y= 1, mapped pin D3
-			if (0x10u & p[ 2]) pins_g |= 0x20; // x= 4, y= 1, mapped pin D4
-			if (0x40u & p[ 0]) pins_b |= 0x80; // x= 6, y= 0, mapped pin D13
-			if (0x80u & p[ 4]) pins_b |= 0x20; // x= 7, y= 2, mapped pin D11
-			if (0x80u & p[ 6]) pins_b |= 0x10; // x= 7, y= 3, mapped pin D10
-			if (0x80u & p[ 8]) pins_h |= 0x40; // x= 7, y= 4, mapped pin D9
-			if (0x80u & p[10]) pins_h |= 0x20; // x= 7, y= 5, mapped pin D8
-			if (0x80u & p[12]) pins_h |= 0x10; // x= 7, y= 6, mapped pin D7
-			if (0x80u & p[14]) pins_h |= 0x08; // x= 7, y= 7, mapped pin D6
-			if (0x80u & p[16]) pins_e |= 0x08; // x= 7, y= 8, mapped pin D5
-			break;
-		case 11:
-			if (0x01u & p[ 0]) pins_e |= 0x10; // x= 0, y= 0, mapped pin D2
-			if (0x04u & p[ 0]) pins_e |= 0x20; // x= 2, y= 0, mapped pin D3
-			if (0x10u & p[ 0]) pins_g |= 0x20; // x= 4, y= 0, mapped pin D4
-			if (0x40u & p[ 4]) pins_b |= 0x20; // x= 6, y= 2, mapped pin D11
-			if (0x40u & p[ 6]) pins_b |= 0x10; // x= 6, y= 3, mapped pin D10
-			if (0x40u & p[10]) pins_h |= 0x20; // x= 6, y= 5, mapped pin D8
-			if (0x40u & p[12]) pins_h |= 0x10; // x= 6, y= 6, mapped pin D7
-			if (0x40u & p[14]) pins_h |= 0x08; // x= 6, y= 7, mapped pin D6
-			if (0x40u & p[16]) pins_e |= 0x08; // x= 6, y= 8, mapped pin D5
-			pins_b |= (0x40u & p[ 2]);         // x= 6, y= 1, mapped pin D12
-			pins_h |= (0x40u & p[ 8]);         // x= 6, y= 4, mapped pin D9
-			break;
-		}
-	}
+	uint8_t const pins_b = image[PORT_B];
+	uint8_t const pins_e = image[PORT_E];
+	uint8_t const pins_g = image[PORT_G];
+	uint8_t const pins_h = image[PORT_H];
+	sink_b = cycle_sink[PORT_B];
+	sink_e = cycle_sink[PORT_E];
+	sink_g = cycle_sink[PORT_G];
+	sink_h = cycle_sink[PORT_H];
 
 	// Enable pullups (by toggling) on new output pins.
 	PINB = PORTB ^ pins_b;
@@ -478,176 +516,14 @@ static void compose_cycle(uint8_t const cycle, uint8_t plane) {
 	DDRD &= ~0xD3;
 	DDRE &= ~0x40;
 
-	static uint8_t const PROGMEM sink_b_cycle[] =
-		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00};
-	static uint8_t const PROGMEM sink_c_cycle[] =
-		{0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80};
-	static uint8_t const PROGMEM sink_d_cycle[] =
-		{0x02, 0x01, 0x10, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00};
-	static uint8_t const PROGMEM sink_e_cycle[] =
-		{0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-	uint8_t pins_b = sink_b = pgm_read_byte(&sink_b_cycle[cycle]);
-	uint8_t pins_c = sink_c = pgm_read_byte(&sink_c_cycle[cycle]);
-	uint8_t pins_d = sink_d = pgm_read_byte(&sink_d_cycle[cycle]);
-	uint8_t pins_e = sink_e = pgm_read_byte(&sink_e_cycle[cycle]);
-
-	// convert Borgware-2D framebuffer to LoL Shield cycles on Arduino Leonardo
-	// NOTE: (0,0) is UPPER RIGHT in the Borgware realm
-	if (plane < NUMPLANE) {
-		switch(cycle) {
-		case 0:
-			if (0x02u & p[ 0]) pins_c |= 0x80; // x= 1, y= 0, mapped pin D13
-			if (0x02u & p[ 2]) pins_d |= 0x40; // x= 1, y= 1, mapped pin D12
-			if (0x02u & p[ 4]) pins_b |= 0x80; // x= 1, y= 2, mapped pin D11
-			if (0x02u & p[ 6]) pins_b |= 0x40; // x= 1, y= 3, mapped pin D10
-			if (0x02u & p[ 8]) pins_b |= 0x20; // x= 1, y= 4, mapped pin D9
-			if (0x02u & p[10]) pins_b |= 0x10; // x= 1, y= 5, mapped pin D8
-			if (0x02u & p[12]) pins_e |= 0x40; // x= 1, y= 6, mapped pin D7
-			if (0x02u & p[14]) pins_d |= 0x80; // x= 1, y= 7, mapped pin D6
-			if (0x02u & p[16]) pins_c |= 0x40; // x= 1, y= 8, mapped pin D5
-			break;
-		case 1:
-			if (0x08u & p[ 0]) pins_c |= 0x80; // x= 3, y= 0, mapped pin D13
-			if (0x08u & p[ 2]) pins_d |= 0x40; // x= 3, y= 1, mapped pin D12
-			if (0x08u & p[ 4]) pins_b |= 0x80; // x= 3, y= 2, mapped pin D11
-			if (0x08u & p[ 6]) pins_b |= 0x40; // x= 3, y= 3, mapped pin D10
-			if (0x08u & p[ 8]) pins_b |= 0x20; // x= 3, y= 4, mapped pin D9
-			if (0x08u & p[10]) pins_b |= 0x10; // x= 3, y= 5, mapped pin D8
-			if (0x08u & p[12]) pins_e |= 0x40; // x= 3, y= 6, mapped pin D7
-			if (0x08u & p[14]) pins_d |= 0x80; // x= 3, y= 7, mapped pin D6
-			if (0x08u & p[16]) pins_c |= 0x40; // x= 3, y= 8, mapped pin D5
-			break;
-		case 2:
-			if (0x20u & p[ 0]) pins_c |= 0x80; // x= 5, y= 0, mapped pin D13
-			if (0x20u & p[ 2]) pins_d |= 0x40; // x= 5, y= 1, mapped pin D12
-			if (0x20u & p[ 4]) pins_b |= 0x80; // x= 5, y= 2, mapped pin D11
-			if (0x20u & p[ 6]) pins_b |= 0x40; // x= 5, y= 3, mapped pin D10
-			if (0x20u & p[10]) pins_b |= 0x10; // x= 5, y= 5, mapped pin D8
-			if (0x20u & p[12]) pins_e |= 0x40; // x= 5, y= 6, mapped pin D7
-			if (0x20u & p[14]) pins_d |= 0x80; // x= 5, y= 7, mapped pin D6
-			if (0x20u & p[16]) pins_c |= 0x40; // x= 5, y= 8, mapped pin D5
-			pins_b |= (0x20u & p[ 8]);         // x= 5, y= 4, mapped pin D9
-			break;
-		case 3:
-			if (0x01u & p[16]) pins_d |= 0x02; // x= 0, y= 8, mapped pin D2
-			if (0x04u & p[16]) pins_d |= 0x01; // x= 2, y= 8, mapped pin D3
-			if (0x20u & p[ 1]) pins_c |= 0x80; // x=13, y= 0, mapped pin D13
-			if (0x20u & p[ 3]) pins_d |= 0x40; // x=13, y= 1, mapped pin D12
-			if (0x20u & p[ 5]) pins_b |= 0x80; // x=13, y= 2, mapped pin D11
-			if (0x20u & p[ 7]) pins_b |= 0x40; // x=13, y= 3, mapped pin D10
-			if (0x20u & p[11]) pins_b |= 0x10; // x=13, y= 5, mapped pin D8
-			if (0x20u & p[13]) pins_e |= 0x40; // x=13, y= 6, mapped pin D7
-			if (0x20u & p[15]) pins_d |= 0x80; // x=13, y= 7, mapped pin D6
-			pins_b |= (0x20u & p[ 9]);         // x=13, y= 4, mapped pin D9
-			pins_d |= (0x10u & p[16]);         // x= 4, y= 8, mapped pin D4
-			break;
-		case 4:
-			if (0x01u & p[14]) pins_d |= 0x02; // x= 0, y= 7, mapped pin D2
-			if (0x04u & p[14]) pins_d |= 0x01; // x= 2, y= 7, mapped pin D3
-			if (0x10u & p[ 1]) pins_c |= 0x80; // x=12, y= 0, mapped pin D13
-			if (0x10u & p[ 3]) pins_d |= 0x40; // x=12, y= 1, mapped pin D12
-			if (0x10u & p[ 5]) pins_b |= 0x80; // x=12, y= 2, mapped pin D11
-			if (0x10u & p[ 7]) pins_b |= 0x40; // x=12, y= 3, mapped pin D10
-			if (0x10u & p[ 9]) pins_b |= 0x20; // x=12, y= 4, mapped pin D9
-			if (0x10u & p[13]) pins_e |= 0x40; // x=12, y= 6, mapped pin D7
-			if (0x20u & p[17]) pins_c |= 0x40; // x=13, y= 8, mapped pin D5
-			pins_b |= (0x10u & p[11]);         // x=12, y= 5, mapped pin D8
-			pins_d |= (0x10u & p[14]);         // x= 4, y= 7, mapped pin D4
-			break;
-		case 5:
-			if (0x01u & p[12]) pins_d |= 0x02; // x= 0, y= 6, mapped pin D2
-			if (0x04u & p[12]) pins_d |= 0x01; // x= 2, y= 6, mapped pin D3
-			if (0x08u & p[ 1]) pins_c |= 0x80; // x=11, y= 0, mapped pin D13
-			if (0x08u & p[ 3]) pins_d |= 0x40; // x=11, y= 1, mapped pin D12
-			if (0x08u & p[ 5]) pins_b |= 0x80; // x=11, y= 2, mapped pin D11
-			if (0x08u & p[ 7]) pins_b |= 0x40; // x=11, y= 3, mapped pin D10
-			if (0x08u & p[ 9]) pins_b |= 0x20; // x=11, y= 4, mapped pin D9
-			if (0x08u & p[11]) pins_b |= 0x10; // x=11, y= 5, mapped pin D8
-			if (0x10u & p[15]) pins_d |= 0x80; // x=12, y= 7, mapped pin D6
-			if (0x10u & p[17]) pins_c |= 0x40; // x=12, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[12]);         // x= 4, y= 6, mapped pin D4
-			break;
-		case 6:
-			if (0x01u & p[10]) pins_d |= 0x02; // x= 0, y= 5, mapped pin D2
-			if (0x04u & p[ 1]) pins_c |= 0x80; // x=10, y= 0, mapped pin D13
-			if (0x04u & p[ 3]) pins_d |= 0x40; // x=10, y= 1, mapped pin D12
-			if (0x04u & p[ 5]) pins_b |= 0x80; // x=10, y= 2, mapped pin D11
-			if (0x04u & p[ 7]) pins_b |= 0x40; // x=10, y= 3, mapped pin D10
-			if (0x04u & p[ 9]) pins_b |= 0x20; // x=10, y= 4, mapped pin D9
-			if (0x04u & p[10]) pins_d |= 0x01; // x= 2, y= 5, mapped pin D3
-			if (0x08u & p[13]) pins_e |= 0x40; // x=11, y= 6, mapped pin D7
-			if (0x08u & p[15]) pins_d |= 0x80; // x=11, y= 7, mapped pin D6
-			if (0x08u & p[17]) pins_c |= 0x40; // x=11, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[10]);         // x= 4, y= 5, mapped pin D4
-			break;
-		case 7:
-			if (0x01u & p[ 8]) pins_d |= 0x02; // x= 0, y= 4, mapped pin D2
-			if (0x02u & p[ 1]) pins_c |= 0x80; // x= 9, y= 0, mapped pin D13
-			if (0x02u & p[ 3]) pins_d |= 0x40; // x= 9, y= 1, mapped pin D12
-			if (0x02u & p[ 5]) pins_b |= 0x80; // x= 9, y= 2, mapped pin D11
-			if (0x02u & p[ 7]) pins_b |= 0x40; // x= 9, y= 3, mapped pin D10
-			if (0x04u & p[ 8]) pins_d |= 0x01; // x= 2, y= 4, mapped pin D3
-			if (0x04u & p[11]) pins_b |= 0x10; // x=10, y= 5, mapped pin D8
-			if (0x04u & p[13]) pins_e |= 0x40; // x=10, y= 6, mapped pin D7
-			if (0x04u & p[15]) pins_d |= 0x80; // x=10, y= 7, mapped pin D6
-			if (0x04u & p[17]) pins_c |= 0x40; // x=10, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[ 8]);         // x= 4, y= 4, mapped pin D4
-			break;
-		case 8:
-			if (0x01u & p[ 1]) pins_c |= 0x80; // x= 8, y= 0, mapped pin D13
-			if (0x01u & p[ 3]) pins_d |= 0x40; // x= 8, y= 1, mapped pin D12
-			if (0x01u & p[ 5]) pins_b |= 0x80; // x= 8, y= 2, mapped pin D11
-			if (0x01u & p[ 6]) pins_d |= 0x02; // x= 0, y= 3, mapped pin D2
-			if (0x02u & p[ 9]) pins_b |= 0x20; // x= 9, y= 4, mapped pin D9
-			if (0x02u & p[11]) pins_b |= 0x10; // x= 9, y= 5, mapped pin D8
-			if (0x02u & p[13]) pins_e |= 0x40; // x= 9, y= 6, mapped pin D7
-			if (0x02u & p[15]) pins_d |= 0x80; // x= 9, y= 7, mapped pin D6
-			if (0x02u & p[17]) pins_c |= 0x40; // x= 9, y= 8, mapped pin D5
-			if (0x04u & p[ 6]) pins_d |= 0x01; // x= 2, y= 3, mapped pin D3
-			pins_d |= (0x10u & p[ 6]);         // x= 4, y= 3, mapped pin D4
-			break;
-		case 9:
-			if (0x01u & p[ 4]) pins_d |= 0x02; // x= 0, y= 2, mapped pin D2
-			if (0x01u & p[ 7]) pins_b |= 0x40; // x= 8, y= 3, mapped pin D10
-			if (0x01u & p[ 9]) pins_b |= 0x20; // x= 8, y= 4, mapped pin D9
-			if (0x01u & p[11]) pins_b |= 0x10; // x= 8, y= 5, mapped pin D8
-			if (0x01u & p[13]) pins_e |= 0x40; // x= 8, y= 6, mapped pin D7
-			if (0x01u & p[15]) pins_d |= 0x80; // x= 8, y= 7, mapped pin D6
-			if (0x01u & p[17]) pins_c |= 0x40; // x= 8, y= 8, mapped pin D5
-			if (0x04u & p[ 4]) pins_d |= 0x01; // x= 2, y= 2, mapped pin D3
-			if (0x80u & p[ 2]) pins_d |= 0x40; // x= 7, y= 1, mapped pin D12
-			pins_c |= (0x80u & p[ 0]);         // x= 7, y= 0, mapped pin D13
-			pins_d |= (0x10u & p[ 4]);         // x= 4, y= 2, mapped pin D4
-			break;
-		case 10:
-			if (0x01u & p[ 2]) pins_d |= 0x02; // x= 0, y= 1, mapped pin D2
-			if (0x04u & p[ 2]) pins_d |= 0x01; // x= 2, y= 1, mapped pin D3
-			if (0x40u & p[ 0]) pins_c |= 0x80; // x= 6, y= 0, mapped pin D13
-			if (0x80u & p[ 6]) pins_b |= 0x40; // x= 7, y= 3, mapped pin D10
-			if (0x80u & p[ 8]) pins_b |= 0x20; // x= 7, y= 4, mapped pin D9
-			if (0x80u & p[10]) pins_b |= 0x10; // x= 7, y= 5, mapped pin D8
-			if (0x80u & p[12]) pins_e |= 0x40; // x= 7, y= 6, mapped pin D7
-			if (0x80u & p[16]) pins_c |= 0x40; // x= 7, y= 8, mapped pin D5
-			pins_b |= (0x80u & p[ 4]);         // x= 7, y= 2, mapped pin D11
-			pins_d |= (0x10u & p[ 2]);         // x= 4, y= 1, mapped pin D4
-			pins_d |= (0x80u & p[14]);         // x= 7, y= 7, mapped pin D6
-			break;
-		case 11:
-			if (0x01u & p[ 0]) pins_d |= 0x02; // x= 0, y= 0, mapped pin D2
-			if (0x04u & p[ 0]) pins_d |= 0x01; // x= 2, y= 0, mapped pin D3
-			if (0x40u & p[ 4]) pins_b |= 0x80; // x= 6, y= 2, mapped pin D11
-			if (0x40u & p[ 8]) pins_b |= 0x20; // x= 6, y= 4, mapped pin D9
-			if (0x40u & p[10]) pins_b |= 0x10; // x= 6, y= 5, mapped pin D8
-			if (0x40u & p[14]) pins_d |= 0x80; // x= 6, y= 7, mapped pin D6
-			pins_b |= (0x40u & p[ 6]);         // x= 6, y= 3, mapped pin D10
-			pins_c |= (0x40u & p[16]);         // x= 6, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[ 0]);         // x= 4, y= 0, mapped pin D4
-			pins_d |= (0x40u & p[ 2]);         // x= 6, y= 1, mapped pin D12
-			pins_e |= (0x40u & p[12]);         // x= 6, y= 6, mapped pin D7
-			break;
-		}
-	}
+	uint8_t const pins_b = image[PORT_B];
+	uint8_t const pins_c = image[PORT_C];
+	uint8_t const pins_d = image[PORT_D];
+	uint8_t const pins_e = image[PORT_E];
+	sink_b = cycle_sink[PORT_B];
+	sink_c = cycle_sink[PORT_C];
+	sink_d = cycle_sink[PORT_D];
+	sink_e = cycle_sink[PORT_E];
 
 	// Enable pullups (by toggling) on new output pins.
 	PINB = PORTB ^ pins_b;
@@ -676,170 +552,10 @@ static void compose_cycle(uint8_t const cycle, uint8_t plane) {
 	DDRD = 0;
 	DDRB = 0;
 
-	static uint8_t const PROGMEM sink_d_cycle[] =
-		{0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-	static uint8_t const PROGMEM sink_b_cycle[] =
-		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20};
-
-	uint8_t pins_d = sink_d = pgm_read_byte(&sink_d_cycle[cycle]);
-	uint8_t pins_b = sink_b = pgm_read_byte(&sink_b_cycle[cycle]);
-
-	// convert Borgware-2D framebuffer to LoL Shield cycles on Diavolino
-	// NOTE: (0,0) is UPPER RIGHT in the Borgware realm
-	if (plane < NUMPLANE) {
-		switch(cycle) {
-		case 0:
-			if (0x02u & p[ 0]) pins_b |= 0x20; // x= 1, y= 0, mapped pin D13
-			if (0x02u & p[ 2]) pins_b |= 0x10; // x= 1, y= 1, mapped pin D12
-			if (0x02u & p[ 4]) pins_b |= 0x08; // x= 1, y= 2, mapped pin D11
-			if (0x02u & p[ 6]) pins_b |= 0x04; // x= 1, y= 3, mapped pin D10
-			if (0x02u & p[10]) pins_b |= 0x01; // x= 1, y= 5, mapped pin D8
-			if (0x02u & p[12]) pins_d |= 0x80; // x= 1, y= 6, mapped pin D7
-			if (0x02u & p[14]) pins_d |= 0x40; // x= 1, y= 7, mapped pin D6
-			if (0x02u & p[16]) pins_d |= 0x20; // x= 1, y= 8, mapped pin D5
-			pins_b |= (0x02u & p[ 8]);         // x= 1, y= 4, mapped pin D9
-			break;
-		case 1:
-			if (0x08u & p[ 0]) pins_b |= 0x20; // x= 3, y= 0, mapped pin D13
-			if (0x08u & p[ 2]) pins_b |= 0x10; // x= 3, y= 1, mapped pin D12
-			if (0x08u & p[ 6]) pins_b |= 0x04; // x= 3, y= 3, mapped pin D10
-			if (0x08u & p[ 8]) pins_b |= 0x02; // x= 3, y= 4, mapped pin D9
-			if (0x08u & p[10]) pins_b |= 0x01; // x= 3, y= 5, mapped pin D8
-			if (0x08u & p[12]) pins_d |= 0x80; // x= 3, y= 6, mapped pin D7
-			if (0x08u & p[14]) pins_d |= 0x40; // x= 3, y= 7, mapped pin D6
-			if (0x08u & p[16]) pins_d |= 0x20; // x= 3, y= 8, mapped pin D5
-			pins_b |= (0x08u & p[ 4]);         // x= 3, y= 2, mapped pin D11
-			break;
-		case 2:
-			if (0x20u & p[ 2]) pins_b |= 0x10; // x= 5, y= 1, mapped pin D12
-			if (0x20u & p[ 4]) pins_b |= 0x08; // x= 5, y= 2, mapped pin D11
-			if (0x20u & p[ 6]) pins_b |= 0x04; // x= 5, y= 3, mapped pin D10
-			if (0x20u & p[ 8]) pins_b |= 0x02; // x= 5, y= 4, mapped pin D9
-			if (0x20u & p[10]) pins_b |= 0x01; // x= 5, y= 5, mapped pin D8
-			if (0x20u & p[12]) pins_d |= 0x80; // x= 5, y= 6, mapped pin D7
-			if (0x20u & p[14]) pins_d |= 0x40; // x= 5, y= 7, mapped pin D6
-			pins_b |= (0x20u & p[ 0]);         // x= 5, y= 0, mapped pin D13
-			pins_d |= (0x20u & p[16]);         // x= 5, y= 8, mapped pin D5
-			break;
-		case 3:
-			if (0x01u & p[16]) pins_d |= 0x04; // x= 0, y= 8, mapped pin D2
-			if (0x04u & p[16]) pins_d |= 0x08; // x= 2, y= 8, mapped pin D3
-			if (0x20u & p[ 3]) pins_b |= 0x10; // x=13, y= 1, mapped pin D12
-			if (0x20u & p[ 5]) pins_b |= 0x08; // x=13, y= 2, mapped pin D11
-			if (0x20u & p[ 7]) pins_b |= 0x04; // x=13, y= 3, mapped pin D10
-			if (0x20u & p[ 9]) pins_b |= 0x02; // x=13, y= 4, mapped pin D9
-			if (0x20u & p[11]) pins_b |= 0x01; // x=13, y= 5, mapped pin D8
-			if (0x20u & p[13]) pins_d |= 0x80; // x=13, y= 6, mapped pin D7
-			if (0x20u & p[15]) pins_d |= 0x40; // x=13, y= 7, mapped pin D6
-			pins_b |= (0x20u & p[ 1]);         // x=13, y= 0, mapped pin D13
-			pins_d |= (0x10u & p[16]);         // x= 4, y= 8, mapped pin D4
-			break;
-		case 4:
-			if (0x01u & p[14]) pins_d |= 0x04; // x= 0, y= 7, mapped pin D2
-			if (0x04u & p[14]) pins_d |= 0x08; // x= 2, y= 7, mapped pin D3
-			if (0x10u & p[ 1]) pins_b |= 0x20; // x=12, y= 0, mapped pin D13
-			if (0x10u & p[ 5]) pins_b |= 0x08; // x=12, y= 2, mapped pin D11
-			if (0x10u & p[ 7]) pins_b |= 0x04; // x=12, y= 3, mapped pin D10
-			if (0x10u & p[ 9]) pins_b |= 0x02; // x=12, y= 4, mapped pin D9
-			if (0x10u & p[11]) pins_b |= 0x01; // x=12, y= 5, mapped pin D8
-			if (0x10u & p[13]) pins_d |= 0x80; // x=12, y= 6, mapped pin D7
-			pins_b |= (0x10u & p[ 3]);         // x=12, y= 1, mapped pin D12
-			pins_d |= (0x10u & p[14]);         // x= 4, y= 7, mapped pin D4
-			pins_d |= (0x20u & p[17]);         // x=13, y= 8, mapped pin D5
-			break;
-		case 5:
-			if (0x01u & p[12]) pins_d |= 0x04; // x= 0, y= 6, mapped pin D2
-			if (0x04u & p[12]) pins_d |= 0x08; // x= 2, y= 6, mapped pin D3
-			if (0x08u & p[ 1]) pins_b |= 0x20; // x=11, y= 0, mapped pin D13
-			if (0x08u & p[ 3]) pins_b |= 0x10; // x=11, y= 1, mapped pin D12
-			if (0x08u & p[ 7]) pins_b |= 0x04; // x=11, y= 3, mapped pin D10
-			if (0x08u & p[ 9]) pins_b |= 0x02; // x=11, y= 4, mapped pin D9
-			if (0x08u & p[11]) pins_b |= 0x01; // x=11, y= 5, mapped pin D8
-			if (0x10u & p[15]) pins_d |= 0x40; // x=12, y= 7, mapped pin D6
-			if (0x10u & p[17]) pins_d |= 0x20; // x=12, y= 8, mapped pin D5
-			pins_b |= (0x08u & p[ 5]);         // x=11, y= 2, mapped pin D11
-			pins_d |= (0x10u & p[12]);         // x= 4, y= 6, mapped pin D4
-			break;
-		case 6:
-			if (0x01u & p[10]) pins_d |= 0x04; // x= 0, y= 5, mapped pin D2
-			if (0x04u & p[ 1]) pins_b |= 0x20; // x=10, y= 0, mapped pin D13
-			if (0x04u & p[ 3]) pins_b |= 0x10; // x=10, y= 1, mapped pin D12
-			if (0x04u & p[ 5]) pins_b |= 0x08; // x=10, y= 2, mapped pin D11
-			if (0x04u & p[ 9]) pins_b |= 0x02; // x=10, y= 4, mapped pin D9
-			if (0x04u & p[10]) pins_d |= 0x08; // x= 2, y= 5, mapped pin D3
-			if (0x08u & p[13]) pins_d |= 0x80; // x=11, y= 6, mapped pin D7
-			if (0x08u & p[15]) pins_d |= 0x40; // x=11, y= 7, mapped pin D6
-			if (0x08u & p[17]) pins_d |= 0x20; // x=11, y= 8, mapped pin D5
-			pins_b |= (0x04u & p[ 7]);         // x=10, y= 3, mapped pin D10
-			pins_d |= (0x10u & p[10]);         // x= 4, y= 5, mapped pin D4
-			break;
-		case 7:
-			if (0x01u & p[ 8]) pins_d |= 0x04; // x= 0, y= 4, mapped pin D2
-			if (0x02u & p[ 1]) pins_b |= 0x20; // x= 9, y= 0, mapped pin D13
-			if (0x02u & p[ 3]) pins_b |= 0x10; // x= 9, y= 1, mapped pin D12
-			if (0x02u & p[ 5]) pins_b |= 0x08; // x= 9, y= 2, mapped pin D11
-			if (0x02u & p[ 7]) pins_b |= 0x04; // x= 9, y= 3, mapped pin D10
-			if (0x04u & p[ 8]) pins_d |= 0x08; // x= 2, y= 4, mapped pin D3
-			if (0x04u & p[11]) pins_b |= 0x01; // x=10, y= 5, mapped pin D8
-			if (0x04u & p[13]) pins_d |= 0x80; // x=10, y= 6, mapped pin D7
-			if (0x04u & p[15]) pins_d |= 0x40; // x=10, y= 7, mapped pin D6
-			if (0x04u & p[17]) pins_d |= 0x20; // x=10, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[ 8]);         // x= 4, y= 4, mapped pin D4
-			break;
-		case 8:
-			if (0x01u & p[ 1]) pins_b |= 0x20; // x= 8, y= 0, mapped pin D13
-			if (0x01u & p[ 3]) pins_b |= 0x10; // x= 8, y= 1, mapped pin D12
-			if (0x01u & p[ 5]) pins_b |= 0x08; // x= 8, y= 2, mapped pin D11
-			if (0x01u & p[ 6]) pins_d |= 0x04; // x= 0, y= 3, mapped pin D2
-			if (0x02u & p[11]) pins_b |= 0x01; // x= 9, y= 5, mapped pin D8
-			if (0x02u & p[13]) pins_d |= 0x80; // x= 9, y= 6, mapped pin D7
-			if (0x02u & p[15]) pins_d |= 0x40; // x= 9, y= 7, mapped pin D6
-			if (0x02u & p[17]) pins_d |= 0x20; // x= 9, y= 8, mapped pin D5
-			if (0x04u & p[ 6]) pins_d |= 0x08; // x= 2, y= 3, mapped pin D3
-			pins_b |= (0x02u & p[ 9]);         // x= 9, y= 4, mapped pin D9
-			pins_d |= (0x10u & p[ 6]);         // x= 4, y= 3, mapped pin D4
-			break;
-		case 9:
-			if (0x01u & p[ 4]) pins_d |= 0x04; // x= 0, y= 2, mapped pin D2
-			if (0x01u & p[ 7]) pins_b |= 0x04; // x= 8, y= 3, mapped pin D10
-			if (0x01u & p[ 9]) pins_b |= 0x02; // x= 8, y= 4, mapped pin D9
-			if (0x01u & p[13]) pins_d |= 0x80; // x= 8, y= 6, mapped pin D7
-			if (0x01u & p[15]) pins_d |= 0x40; // x= 8, y= 7, mapped pin D6
-			if (0x01u & p[17]) pins_d |= 0x20; // x= 8, y= 8, mapped pin D5
-			if (0x04u & p[ 4]) pins_d |= 0x08; // x= 2, y= 2, mapped pin D3
-			if (0x80u & p[ 0]) pins_b |= 0x20; // x= 7, y= 0, mapped pin D13
-			if (0x80u & p[ 2]) pins_b |= 0x10; // x= 7, y= 1, mapped pin D12
-			pins_b |= (0x01u & p[11]);         // x= 8, y= 5, mapped pin D8
-			pins_d |= (0x10u & p[ 4]);         // x= 4, y= 2, mapped pin D4
-			break;
-		case 10:
-			if (0x01u & p[ 2]) pins_d |= 0x04; // x= 0, y= 1, mapped pin D2
-			if (0x04u & p[ 2]) pins_d |= 0x08; // x= 2, y= 1, mapped pin D3
-			if (0x40u & p[ 0]) pins_b |= 0x20; // x= 6, y= 0, mapped pin D13
-			if (0x80u & p[ 4]) pins_b |= 0x08; // x= 7, y= 2, mapped pin D11
-			if (0x80u & p[ 6]) pins_b |= 0x04; // x= 7, y= 3, mapped pin D10
-			if (0x80u & p[ 8]) pins_b |= 0x02; // x= 7, y= 4, mapped pin D9
-			if (0x80u & p[10]) pins_b |= 0x01; // x= 7, y= 5, mapped pin D8
-			if (0x80u & p[14]) pins_d |= 0x40; // x= 7, y= 7, mapped pin D6
-			if (0x80u & p[16]) pins_d |= 0x20; // x= 7, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[ 2]);         // x= 4, y= 1, mapped pin D4
-			pins_d |= (0x80u & p[12]);         // x= 7, y= 6, mapped pin D7
-			break;
-		case 11:
-			if (0x01u & p[ 0]) pins_d |= 0x04; // x= 0, y= 0, mapped pin D2
-			if (0x04u & p[ 0]) pins_d |= 0x08; // x= 2, y= 0, mapped pin D3
-			if (0x40u & p[ 2]) pins_b |= 0x10; // x= 6, y= 1, mapped pin D12
-			if (0x40u & p[ 4]) pins_b |= 0x08; // x= 6, y= 2, mapped pin D11
-			if (0x40u & p[ 6]) pins_b |= 0x04; // x= 6, y= 3, mapped pin D10
-			if (0x40u & p[ 8]) pins_b |= 0x02; // x= 6, y= 4, mapped pin D9
-			if (0x40u & p[10]) pins_b |= 0x01; // x= 6, y= 5, mapped pin D8
-			if (0x40u & p[12]) pins_d |= 0x80; // x= 6, y= 6, mapped pin D7
-			if (0x40u & p[16]) pins_d |= 0x20; // x= 6, y= 8, mapped pin D5
-			pins_d |= (0x10u & p[ 0]);         // x= 4, y= 0, mapped pin D4
-			pins_d |= (0x40u & p[14]);         // x= 6, y= 7, mapped pin D6
-			break;
-		}
-	}
+	uint8_t const pins_d = image[PORT_D];
+	uint8_t const pins_b = image[PORT_B];
+	sink_d = cycle_sink[PORT_D];
+	sink_b = cycle_sink[PORT_B];
 
 	// Enable pullups on new output pins.
 	PORTD = pins_d;
@@ -892,15 +608,20 @@ ISR(TIMER1_COMPA_vect) {
 	TCNT1 = counts[plane];
 #endif
 
-	// distribute framebuffer contents among current cycle pins
-	compose_cycle(cycle, plane++);
+	// output the precomposed port image of the current plane
+	show_plane(plane++);
 
 	if (plane >= (NUMPLANE + 1)) {
 		plane = 0;
 		cycle++;
 		if (cycle >= 12) {
 			cycle = 0;
+			BORG_HW_FRAME_FLIP();
 		}
+		// the dark plane has just been switched on, it lasts at least
+		// COMPOSE_TICKS to distribute the framebuffer contents among the pins
+		// of the next cycle
+		compose_cycle(cycle);
 	}
 	wdt_reset();
 }
@@ -940,6 +661,8 @@ void borg_hw_init() {
 	setBrightness();
 #endif
 
+	compose_cycle(0);
+
 	// Then start the display
 #if defined (__AVR_ATmega48__)   || \
     defined (__AVR_ATmega48P__)  || \
@@ -15,10 +15,46 @@
 #endif
 
 #include <string.h>
+#include "../util.h"
+#include "../random/prng.h"
 
 can_addr_t myaddr;
 extern jmp_buf newmode_jmpbuf;
 
+// number of frame data messages which fit into the receive queue
+#if !defined(__AVR__)
+#	define BCAN_FRAME_WINDOW 16
+#elif defined(CAN_INTERRUPT)
+#	define BCAN_FRAME_WINDOW CAN_RX_BUFFER_SIZE
+#else
+#	define BCAN_FRAME_WINDOW 1
+#endif
+
+// stream mode is left if no frame message arrived for this many milliseconds
+#define BCAN_FRAME_TIMEOUT 2000
+
+//back buffer for frames which are transferred via FKT_BORG_FRAME_*
+static unsigned char bcan_framebuf[NUMPLANE][NUM_ROWS][LINEBYTES];
+static uint8_t bcan_frame_seq, bcan_frame_count;
+static volatile uint8_t bcan_frame_streaming;
+static tick_t bcan_frame_last;
+
+//synchronized playback
+#define BCAN_SYNC_PERIOD  500  //master broadcasts its tick that often
+#define BCAN_SYNC_TIMEOUT 2000 //slaves run on their own after this silence
+#define BCAN_SYNC_LEAD    100  //the master announces modes that early
+#define BCAN_SYNC_STEP    20   //larger clock errors are corrected at once
+
+static tick_t bcan_sync_offset;  //master tick minus local tick
+static tick_t bcan_sync_last;    //local tick of the last sync message
+#ifndef CAN_SYNC_MASTER
+static uint8_t bcan_sync_locked; //set once a master tick has been received
+static uint8_t bcan_sync_go;     //set if the next mode was started in sync
+static uint8_t bcan_sync_mode;   //mode announced by the master
+static tick_t bcan_sync_start;
+static uint16_t bcan_sync_seed;
+#endif
+
 #ifdef LAP_TIME_EXTENSION
 //variables to save the last received hours and  minutes
 //(accessible via lap.h)
@@ -27,10 +63,21 @@ uint8_t lap_time_h, lap_time_m, lap_time_update = 0;
 
 void bcan_init()
 {
+#ifdef __AVR__
 	spi_init();
+#endif
 	can_init();
 
 	myaddr = eeprom_read_byte(0x00);
+
+	//keep unrelated bus traffic away from the receive queue
+	can_filter_t filters[] = {
+		{myaddr, PORT_BORG},
+		{myaddr, PORT_MGT},
+		{0xff, PORT_BORG}
+	};
+	can_setfilter_dst(filters, sizeof(filters) / sizeof(filters[0]));
+
 	pdo_message *msg = (pdo_message *)can_buffer_get();
 	msg->addr_src = myaddr;
 	msg->addr_dst = 0xff;
@@ -67,6 +114,30 @@ void process_mgt_msg(pdo_message *msg)
 		rmsg->dlc = 1;
 		can_transmit((can_message *)rmsg);
 		break;
+	case FKT_MGT_STATSREQUEST:
+	{
+		can_stats_t stats;
+		can_get_stats(&stats);
+		rmsg = (pdo_message *)can_buffer_get();
+		rmsg->addr_dst = msg->addr_src;
+		rmsg->addr_src = myaddr;
+		rmsg->port_dst = msg->port_src;
+		rmsg->port_src = msg->port_dst;
+		rmsg->cmd = FKT_MGT_STATSREPLY;
+		rmsg->dlc = 8;
+		rmsg->data[0] = stats.rx_dropped & 0xff;
+		rmsg->data[1] = stats.rx_dropped >> 8;
+		rmsg->data[2] = stats.rx_overruns & 0xff;
+		rmsg->data[3] = stats.rx_overruns >> 8;
+		rmsg->data[4] = stats.tec;
+		rmsg->data[5] = stats.rec;
+		rmsg->data[6] = stats.eflg;
+		can_transmit((can_message *)rmsg);
+		if (msg->dlc > 1 && msg->data[0]) {
+			can_clear_stats();
+		}
+		break;
+	}
 
 	#ifdef LAP_TIME_EXTENSION
 	//if we get a time reply, save it
@@ -79,6 +150,177 @@ void process_mgt_msg(pdo_message *msg)
 	}
 }
 
+static void bcan_frame_ack(pdo_message *msg, uint8_t status)
+{
+	pdo_message *rmsg = (pdo_message *)can_buffer_get();
+	rmsg->addr_dst = msg->addr_src;
+	rmsg->addr_src = myaddr;
+	rmsg->port_dst = msg->port_src;
+	rmsg->port_src = msg->port_dst;
+	rmsg->cmd      = FKT_BORG_FRAME_ACK;
+	rmsg->dlc      = 5;
+	rmsg->data[0]  = bcan_frame_seq;
+	rmsg->data[1]  = status;
+	rmsg->data[2]  = bcan_frame_count;
+	rmsg->data[3]  = BCAN_FRAME_WINDOW;
+	can_transmit((can_message *)rmsg);
+}
+
+static void bcan_frame_data(pdo_message *msg)
+{
+	uint8_t row    = msg->data[1];
+	uint8_t plane  = msg->data[2] >> 4;
+	uint8_t offset = msg->data[2] & 0x0f;
+	uint8_t len    = msg->dlc - 4;
+
+	if (msg->dlc < 5 || len > BORG_FRAME_DATA_BYTES || row >= NUM_ROWS ||
+			plane >= NUMPLANE || offset + len > LINEBYTES) {
+		return;
+	}
+
+	memcpy(&bcan_framebuf[plane][row][offset], &msg->data[3], len);
+
+	//renew the sender's credit after each window
+	if ((++bcan_frame_count % BCAN_FRAME_WINDOW) == 0) {
+		bcan_frame_ack(msg, BORG_FRAME_OK);
+	}
+}
+
+//shows frames received via FKT_BORG_FRAME_* until the sender falls silent
+void bcan_frame_stream()
+{
+	bcan_frame_last = get_tick();
+	bcan_frame_streaming = 1;
+	while ((tick_t)(get_tick() - bcan_frame_last) < BCAN_FRAME_TIMEOUT) {
+		wait(5);
+	}
+	bcan_frame_streaming = 0;
+}
+
+//ends stream mode after a mode jump out of bcan_frame_stream()
+void bcan_frame_stop()
+{
+	bcan_frame_streaming = 0;
+}
+
+//========== synchronized playback
+
+//current tick of the sync master (the local tick if there is none)
+tick_t bcan_sync_now()
+{
+	return get_tick() + bcan_sync_offset;
+}
+
+//waits until the master tick reaches start and seeds the random generator
+static void bcan_sync_begin(tick_t start, uint16_t seed)
+{
+	int16_t delay = (int16_t)(start - bcan_sync_now());
+
+	if (delay > 0 && delay <= BCAN_SYNC_TIMEOUT) {
+		while ((int16_t)(start - bcan_sync_now()) > 0) {
+			wait(1);
+		}
+	}
+	random_restart(seed);
+}
+
+#ifdef CAN_SYNC_MASTER
+static void bcan_sync_send(unsigned char cmd, unsigned char len,
+		unsigned char const *data)
+{
+	pdo_message *msg = (pdo_message *)can_buffer_get();
+	msg->addr_src = myaddr;
+	msg->addr_dst = 0xff;
+	msg->port_src = PORT_BORG;
+	msg->port_dst = PORT_BORG;
+	msg->cmd      = cmd;
+	msg->dlc      = len + 1;
+	memcpy(msg->data, data, len);
+	can_transmit((can_message *)msg);
+}
+
+//broadcasts the master tick every BCAN_SYNC_PERIOD milliseconds
+static void bcan_sync_master()
+{
+	tick_t now = get_tick();
+
+	if ((tick_t)(now - bcan_sync_last) >= BCAN_SYNC_PERIOD) {
+		unsigned char data[2] = {now & 0xff, now >> 8};
+		bcan_sync_last = now;
+		bcan_sync_send(FKT_BORG_SYNC_TICK, sizeof(data), data);
+	}
+}
+
+//announces mode to the slaves and starts it at the same tick as they do
+void bcan_sync_next(unsigned char mode)
+{
+	tick_t start = get_tick() + BCAN_SYNC_LEAD;
+	uint16_t seed = random8() | (random8() << 8);
+	unsigned char data[5] = {mode, start & 0xff, start >> 8,
+			seed & 0xff, seed >> 8};
+
+	bcan_sync_send(FKT_BORG_SYNC_START, sizeof(data), data);
+	bcan_sync_begin(start, seed);
+}
+#else
+//corrects the local clock towards a master tick
+static void bcan_sync_adjust(tick_t master)
+{
+	int16_t err = (int16_t)(master - bcan_sync_now());
+
+	if (!bcan_sync_locked || err > BCAN_SYNC_STEP || err < -BCAN_SYNC_STEP) {
+		bcan_sync_offset += err;
+	} else {
+		//slew, so the clock doesn't jitter with the bus latency
+		bcan_sync_offset += err / 2 + err % 2;
+	}
+	bcan_sync_locked = 1;
+}
+
+static void process_sync_msg(pdo_message *msg)
+{
+	switch (msg->cmd) {
+	case FKT_BORG_SYNC_TICK:
+		bcan_sync_adjust(msg->data[0] | (msg->data[1] << 8));
+		bcan_sync_last = get_tick();
+		break;
+
+	case FKT_BORG_SYNC_START:
+		bcan_sync_mode  = msg->data[0];
+		bcan_sync_start = msg->data[1] | (msg->data[2] << 8);
+		bcan_sync_seed  = msg->data[3] | (msg->data[4] << 8);
+		bcan_sync_last  = get_tick();
+		if (bcan_sync_locked) {
+			longjmp(newmode_jmpbuf, BCAN_SYNC_MODE);
+		}
+		break;
+	}
+}
+
+//lets a slave wait for the master to announce the next mode
+void bcan_sync_next(unsigned char mode)
+{
+	(void)mode;
+
+	if (bcan_sync_go) {
+		bcan_sync_go = 0;
+		return;
+	}
+	while (bcan_sync_locked &&
+			(tick_t)(get_tick() - bcan_sync_last) < BCAN_SYNC_TIMEOUT) {
+		wait(5);
+	}
+}
+
+//starts the mode announced by the master, returns the mode to be shown
+unsigned char bcan_sync_wait()
+{
+	bcan_sync_begin(bcan_sync_start, bcan_sync_seed);
+	bcan_sync_go = 1;
+	return bcan_sync_mode;
+}
+#endif
+
 void process_borg_msg(pdo_message *msg)
 {
 	unsigned char i, j;
@@ -106,35 +348,39 @@ void process_borg_msg(pdo_message *msg)
 		scrolltext_text[i + j] = 0;
 		break;
 
-#ifdef Hansi_hat_gelernt_Werte_vorher_zu_definieren
+	//========== bulk frame transfer
 
-	//========== blinkenstuff
-
-	//clear the blinkenbackbuffer to color
-	case FKT_BLINK_CLEARBUF:
-			blink_clearbuf(msg->data[0]);
-		break;
-
-	//set auto position increment flag
-	case FKT_BLINK_SETAUTOPOS:
-			blink_setautopos(msg->data[0]);
-		break;
-
-	//set the current blinkenbuffer offset position
-	case FKT_BLINK_SETPOS:
-			blink_setpos(msg->data[0]);
+	//start a new frame, switching to stream mode if necessary
+	case FKT_BORG_FRAME_BEGIN:
+		bcan_frame_seq = msg->data[0];
+		bcan_frame_count = 0;
+		bcan_frame_last = get_tick();
+		bcan_frame_ack(msg, BORG_FRAME_OK);
+		if (!bcan_frame_streaming) {
+			longjmp(newmode_jmpbuf, BCAN_STREAM_MODE);
+		}
 		break;
 
-	//puts the current blinkenbuffer to the frontbuffer
-	case FKT_BLINK_SHOW:
-			blink_show();
+	//row-addressed data for the back buffer
+	case FKT_BORG_FRAME_DATA:
+		if (msg->data[0] == bcan_frame_seq) {
+			bcan_frame_last = get_tick();
+			bcan_frame_data(msg);
+		}
 		break;
 
-	//puts data into the blinkenbuffer
-	case FKT_BLINK_DATA:
-			blink_data(msg->data, msg->dlc - 1);
+	//flip the back buffer into the frame buffer if it is complete
+	case FKT_BORG_FRAME_SHOW:
+		if (msg->data[0] != bcan_frame_seq) {
+			bcan_frame_ack(msg, BORG_FRAME_BAD_SEQ);
+		} else if (msg->data[1] != bcan_frame_count) {
+			bcan_frame_ack(msg, BORG_FRAME_INCOMPLETE);
+		} else {
+			memcpy(pixmap, bcan_framebuf, sizeof(bcan_framebuf));
+			bcan_frame_last = get_tick();
+			bcan_frame_ack(msg, BORG_FRAME_SHOWN);
+		}
 		break;
-#endif
 	}
 }
 
@@ -142,15 +388,26 @@ void bcan_process_messages() {
 	pdo_message *msg = (pdo_message*) can_get_nb();
 
 	while (msg) {
-		if (!msg)
-			return;
+		//work on a copy, so the receive buffer can be reused right away
+		pdo_message rmsg = *msg;
+		can_free((can_message *)msg);
+
+		if (rmsg.addr_dst == myaddr && rmsg.port_dst == PORT_MGT)
+			process_mgt_msg(&rmsg);
 
-		if (msg->addr_dst == myaddr && msg->port_dst == PORT_MGT)
-			process_mgt_msg(msg);
+		if (rmsg.addr_dst == myaddr && rmsg.port_dst == PORT_BORG)
+			process_borg_msg(&rmsg);
 
-		if (msg->addr_dst == myaddr && msg->port_dst == PORT_BORG)
-			process_borg_msg(msg);
+#ifndef CAN_SYNC_MASTER
+		if (rmsg.addr_dst == 0xff && rmsg.port_dst == PORT_BORG &&
+				rmsg.addr_src != myaddr)
+			process_sync_msg(&rmsg);
+#endif
 
 		msg = (pdo_message*) can_get_nb();
 	}
+
+#ifdef CAN_SYNC_MASTER
+	bcan_sync_master();
+#endif
 }
@@ -1,11 +1,27 @@
 #ifndef BORG_CAN_H_
 #define BORG_CAN_H_
 
+#include "../util.h"
+
+// display_loop() mode which shows frames received via CAN
+#define BCAN_STREAM_MODE 0xFCu
+
+// display_loop() mode which starts the mode announced by the sync master
+#define BCAN_SYNC_MODE 0xFBu
+
 extern unsigned char borg_mode;
 extern char scrolltext_text[];
 
 void bcan_init();
 unsigned char bcan_mode();
 void bcan_process_messages();
+void bcan_frame_stream();
+void bcan_frame_stop();
+
+tick_t bcan_sync_now();
+void bcan_sync_next(unsigned char mode);
+#ifndef CAN_SYNC_MASTER
+unsigned char bcan_sync_wait();
+#endif
 
 #endif /* BORG_CAN_H */
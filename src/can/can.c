@@ -74,6 +74,8 @@
 	#define RX1IF 1
 	#define RX0IF 0
 #define EFLG 0x2D
+	#define RX1OVR 7
+	#define RX0OVR 6
 #define TXB0CTRL 0x30
 	#define TXREQ 3
 #define TXB0SIDH 0x31
@@ -88,6 +90,7 @@
 	#define RXM1 6
 	#define RXM0 5
 	#define RXRTR 3
+	#define BUKT 2
 	// Bits 2:0 FILHIT2:0
 #define RXB0SIDH 0x61
 #define RXB0SIDL 0x62
@@ -95,14 +98,20 @@
 #define RXB0EID0 0x64
 #define RXB0DLC 0x65
 #define RXB0D0 0x66 
+#define RXB1CTRL 0x70
+#define RXB1SIDH 0x71
 
 //Command Bytes
 #define RESET 0xC0
 #define READ 0x03
 #define READ_RX_BUFFER 0x90
+	#define READ_RXB0SIDH 0x00
+	#define READ_RXB1SIDH 0x04
 #define WRITE 0x02
 #define LOAD_TX_BUFFER 0x40
+	#define LOAD_TXB0SIDH 0x00
 #define RTS 0x80
+	#define RTS_TXB0 0x01
 #define READ_STATUS 0xA0
 #define RX_STATUS 0xB0
 #define BIT_MODIFY 0x05
@@ -112,6 +121,19 @@ typedef struct{
 	volatile unsigned char flags;
 }can_message_x;
 
+#if (CAN_RX_BUFFER_SIZE & (CAN_RX_BUFFER_SIZE - 1)) || \
+	(CAN_TX_BUFFER_SIZE & (CAN_TX_BUFFER_SIZE - 1))
+	#error CAN_RX_BUFFER_SIZE and CAN_TX_BUFFER_SIZE must be powers of two
+#endif
+#define CAN_RX_MASK (CAN_RX_BUFFER_SIZE - 1)
+#define CAN_TX_MASK (CAN_TX_BUFFER_SIZE - 1)
+
+//statistics (see can_get_stats())
+static volatile uint16_t can_rx_dropped, can_rx_overruns;
+
+//increments a statistics counter unless it is saturated
+#define CAN_COUNT(c) do { if ((uint16_t)((c) + 1)) ++(c); } while (0)
+
 
 /* MCP */
 void mcp_reset();
@@ -155,96 +177,139 @@ unsigned char mcp_status();
 	}
 
 	//load a message to mcp2515 and start transmission
+	//LOAD TX BUFFER addresses TXB0SIDH without a register byte and the
+	//identifier gets packed while the instruction is shifted out
 	void message_load(can_message_x * msg) {
-		unsigned char x;
+		unsigned char sidh, sidl, dlc, x;
 
 		spi_set_ss();
-		spi_data(WRITE);
-		spi_data(TXB0SIDH);
-
-		spi_data(((unsigned char)(msg->msg.port_src << 2)) |
-				(msg->msg.port_dst >> 4));
-		spi_data((unsigned char)((msg->msg.port_dst & 0x0C) << 3) |
-				(1<<EXIDE) | (msg->msg.port_dst & 0x03));
-		spi_data(msg->msg.addr_src);
-		spi_data(msg->msg.addr_dst);
-		spi_data(msg->msg.dlc);
-		for(x=0;x<msg->msg.dlc;x++) {
-			spi_data(msg->msg.data[x]);
+		spi_start(LOAD_TX_BUFFER | LOAD_TXB0SIDH);
+		sidh = ((unsigned char)(msg->msg.port_src << 2)) |
+				(msg->msg.port_dst >> 4);
+		sidl = (unsigned char)((msg->msg.port_dst & 0x0C) << 3) |
+				(1<<EXIDE) | (msg->msg.port_dst & 0x03);
+		dlc = msg->msg.dlc;
+		spi_wait();
+		spi_start(sidh);
+		spi_wait();
+		spi_start(sidl);
+		spi_wait();
+		spi_start(msg->msg.addr_src);
+		spi_wait();
+		spi_start(msg->msg.addr_dst);
+		spi_wait();
+		spi_start(dlc);
+		for(x=0;x<dlc;x++) {
+			spi_wait();
+			spi_start(msg->msg.data[x]);
 		}
+		spi_wait();
 		spi_clear_ss();
+
 		spi_set_ss();
-		spi_data(WRITE);
-		spi_data(TXB0CTRL);
-		spi_data((1<<TXREQ));
+		spi_data(RTS | RTS_TXB0);
 		spi_clear_ss();
 	}
 	
-	//get a message from mcp2515 and disable RX interrupt Condition
-	void message_fetch(can_message_x * msg) {
-		unsigned char tmp1, tmp2, tmp3;
-		unsigned char x;
+	//get a message from receive buffer rxb (0 or 1) of the mcp2515
+	//READ RX BUFFER clears the RX interrupt Condition when SS is released, and
+	//each received byte gets unpacked while the next one is shifted in
+	void message_fetch(can_message_x * msg, unsigned char rxb) {
+		unsigned char sidh, sidl, dlc, x;
 
 		spi_set_ss();
-		spi_data(READ);
-		spi_data(RXB0SIDH);
-		tmp1 = spi_data(0);
-		msg->msg.port_src = tmp1 >> 2;
-		tmp2 = spi_data(0);
-		tmp3 = (unsigned char)((unsigned char)(tmp2 >> 3) & 0x0C);
-		msg->msg.port_dst = ((unsigned char)(tmp1 <<4 ) & 0x30) | tmp3 |
-				(unsigned char)(tmp2 & 0x03);
-		msg->msg.addr_src = spi_data(0);
-		msg->msg.addr_dst = spi_data(0);
-		msg->msg.dlc = spi_data(0) & 0x0F;
-		for(x=0;x<msg->msg.dlc;x++) {
-			msg->msg.data[x] = spi_data(0);
+		spi_start(READ_RX_BUFFER | (rxb ? READ_RXB1SIDH : READ_RXB0SIDH));
+		spi_wait();
+		spi_start(0);
+		sidh = spi_wait();
+		spi_start(0);
+		msg->msg.port_src = sidh >> 2;
+		sidl = spi_wait();
+		spi_start(0);
+		msg->msg.port_dst = ((unsigned char)(sidh << 4) & 0x30) |
+				((unsigned char)(sidl >> 3) & 0x0C) | (sidl & 0x03);
+		msg->msg.addr_src = spi_wait();
+		spi_start(0);
+		msg->msg.addr_dst = spi_wait();
+		spi_start(0);
+		dlc = spi_wait() & 0x0F;
+		if (dlc > 8) {
+			dlc = 8;
+		}
+		msg->msg.dlc = dlc;
+		for(x=0;x<dlc;x++) {
+			spi_start(0);
+			msg->msg.data[x] = spi_wait();
 		}
 		spi_clear_ss();
+	}
 
-		mcp_bitmod(CANINTF, (1<<RX0IF), 0x00);
+	//counts and clears overflows of the mcp2515's receive buffers
+	static void can_check_errors() {
+		unsigned char eflg = mcp_read(EFLG);
+
+		if (eflg & (1<<RX0OVR)) CAN_COUNT(can_rx_overruns);
+		if (eflg & (1<<RX1OVR)) CAN_COUNT(can_rx_overruns);
+		if (eflg & ((1<<RX0OVR) | (1<<RX1OVR))) {
+			mcp_bitmod(EFLG, (1<<RX0OVR) | (1<<RX1OVR), 0x00);
+		}
+
+		#ifdef CAN_HANDLEERROR
+			if (eflg) { // we've got a error condition
+				can_error = eflg;
+			}
+		#endif // CAN_HANDLEERROR
 	}
 
 	#ifdef CAN_INTERRUPT
 		static can_message_x RX_BUFFER[CAN_RX_BUFFER_SIZE],
 			TX_BUFFER[CAN_TX_BUFFER_SIZE];
-		unsigned char RX_HEAD=0;volatile unsigned char RX_TAIL=0;
+		volatile unsigned char RX_HEAD=0;volatile unsigned char RX_TAIL=0;
 		unsigned char TX_HEAD= 0;volatile unsigned char TX_TAIL=0;
 		static volatile unsigned char TX_INT;
-		
+
+		//move a message from receive buffer rxb of the mcp2515 to the queue
+		static void can_receive(unsigned char rxb) {
+			if ( !(RX_BUFFER[RX_HEAD].flags & 0x01) ) {
+				message_fetch(&RX_BUFFER[RX_HEAD], rxb);
+				RX_BUFFER[RX_HEAD].flags |= 0x01;//mark buffer as used
+				RX_HEAD = (RX_HEAD + 1) & CAN_RX_MASK;
+			}else{
+				//queue overflow
+				//clear the Interrupt condition, and count the lost message
+				mcp_bitmod(CANINTF, (1<<RX0IF) << rxb, 0x00);
+				CAN_COUNT(can_rx_dropped);
+			}
+		}
+
 		ISR(INT0_vect) {
-			unsigned char status = mcp_status();
-
-			if ( status & 0x01 ) {	// Message in RX0
-				if ( !(((can_message_x*)&RX_BUFFER[RX_HEAD])->flags & 0x01) ) {
-					message_fetch(&RX_BUFFER[RX_HEAD]);
-					RX_BUFFER[RX_HEAD].flags |= 0x01;//mark buffer as used
-					if( ++RX_HEAD == CAN_RX_BUFFER_SIZE) RX_HEAD = 0;
-				}else{
-					//buffer overflow
-					//just clear the Interrupt condition, and lose the message
-					mcp_bitmod(CANINTF, (1<<RX0IF), 0x00);
+			unsigned char status;
+
+			//INT0 triggers on the falling edge, so all pending conditions have
+			//to be handled before the mcp2515 releases its interrupt line
+			while ( (status = mcp_status()) & 0x0B ) {
+				if ( status & 0x01 ) {	// Message in RX0
+					can_receive(0);
 				}
-			} else if ( status & 0x08 ) {	// TX1 empty
-				if(((can_message_x*)&TX_BUFFER[TX_TAIL])->flags & 0x01) {
-					((can_message_x*)&TX_BUFFER[TX_TAIL])->flags &= ~0x01;
-					TX_INT = 1;
-					message_load(&TX_BUFFER[TX_TAIL]);
-					if(++TX_TAIL == CAN_TX_BUFFER_SIZE) TX_TAIL = 0;
-				}else{
-					TX_INT = 0;
+				if ( status & 0x02 ) {	// Message in RX1 (rolled over)
+					can_receive(1);
 				}
-				mcp_bitmod(CANINTF, (1<<TX0IF), 0x00);
-			} else {
-				#ifdef CAN_HANDLEERROR
-					status = mcp_read(EFLG);
-
-					if(status) { // we've got a error condition
-						can_error = status;
-
-						mcp_write(EFLG, 0);
+				if ( status & 0x08 ) {	// TX0 empty
+					if(TX_BUFFER[TX_TAIL].flags & 0x01) {
+						TX_BUFFER[TX_TAIL].flags &= ~0x01;
+						TX_INT = 1;
+						message_load(&TX_BUFFER[TX_TAIL]);
+						TX_TAIL = (TX_TAIL + 1) & CAN_TX_MASK;
+					}else{
+						TX_INT = 0;
 					}
-				#endif // CAN_HANDLEERROR
+					mcp_bitmod(CANINTF, (1<<TX0IF), 0x00);
+				}
+			}
+
+			if ( mcp_read(CANINTF) & (1<<ERRIF) ) {
+				can_check_errors();
+				mcp_bitmod(CANINTF, (1<<ERRIF), 0x00);
 			}
 		}
 	#endif
@@ -315,7 +380,77 @@ unsigned char mcp_status();
 		//  0      1     " only 11bit Identifier
 		//  1      0     " only 29bit Identifier
 		//  1      1     any
-		mcp_write(RXB0CTRL, (1<<RXM1) | (1<<RXM0));
+		//BUKT: messages roll over to RXB1 if RXB0 is still occupied
+		mcp_write(RXB0CTRL, (1<<RXM1) | (1<<RXM0) | (1<<BUKT));
+		mcp_write(RXB1CTRL, (1<<RXM1) | (1<<RXM0));
+	}
+
+	//writes an identifier (or mask) for addr_dst and port_dst to the four
+	//registers starting at reg, see message_load() for the layout
+	static void can_write_id(unsigned char reg, can_addr_t addr_dst,
+			can_port_t port_dst) {
+		mcp_write(reg,     port_dst >> 4);
+		mcp_write(reg + 1, (unsigned char)((port_dst & 0x0C) << 3) |
+				(1<<EXIDE) | (port_dst & 0x03));
+		mcp_write(reg + 2, 0);
+		mcp_write(reg + 3, addr_dst);
+	}
+
+	void can_setfilter_dst(can_filter_t const *filters, unsigned char count) {
+		//RXF0-1 belong to RXB0, RXF2-5 to RXB1
+		static const unsigned char regs[6] = {
+			RXF0SIDH, RXF1SIDH, RXF2SIDH, RXF3SIDH, RXF4SIDH, RXF5SIDH
+		};
+		unsigned char sreg = SREG, x;
+
+		if (!count) {
+			return;
+		}
+
+		//filters are only writable in configuration mode and the interrupt
+		//handler must not interfere with the mode change
+		cli();
+		can_setmode(config);
+		while ((mcp_read(CANSTAT) & 0xE0) != (config << 5)) {};
+
+		//the masks compare port_dst and addr_dst only (EXIDE is unimplemented
+		//in the mask registers)
+		can_write_id(RXM0SIDH, 0xFF, 0x3F);
+		can_write_id(RXM1SIDH, 0xFF, 0x3F);
+
+		//RXB1 gets all filters as well, so rolled over messages are accepted
+		for (x = 0; x < 6; x++) {
+			can_filter_t const *f = &filters[(x < 2 ? x : x - 2) % count];
+			can_write_id(regs[x], f->addr_dst, f->port_dst);
+		}
+
+		mcp_write(RXB0CTRL, (1<<BUKT));
+		mcp_write(RXB1CTRL, 0);
+
+		can_setmode(normal);
+		SREG = sreg;
+	}
+
+	void can_get_stats(can_stats_t *stats) {
+		unsigned char sreg = SREG;
+
+		cli();
+		can_check_errors();
+		stats->rx_dropped = can_rx_dropped;
+		stats->rx_overruns = can_rx_overruns;
+		stats->tec = mcp_read(TEC);
+		stats->rec = mcp_read(REC);
+		stats->eflg = mcp_read(EFLG);
+		SREG = sreg;
+	}
+
+	void can_clear_stats() {
+		unsigned char sreg = SREG;
+
+		cli();
+		can_rx_dropped = 0;
+		can_rx_overruns = 0;
+		SREG = sreg;
 	}
 	
 	void can_setled(unsigned char led, unsigned char state) {
@@ -376,7 +511,7 @@ unsigned char mcp_status();
 	
 		// configure IRQ: this only configures the INT Output of the mcp2515, not
 		// the int on the Atmel
-		mcp_write( CANINTE, (1<<RX0IE) | (1<<TX0IE) );
+		mcp_write( CANINTE, (1<<RX0IE) | (1<<RX1IE) | (1<<TX0IE) );
 	
 		can_setfilter();
 		can_setmode(normal);
@@ -385,7 +520,8 @@ unsigned char mcp_status();
 
 			// configure IRQ: this only configures the INT Output of the mcp2515,
 			// not the int on the Atmel
-			mcp_write( CANINTE, (1<<RX0IE) | (1<<TX0IE) );
+			mcp_write( CANINTE, (1<<RX0IE) | (1<<RX1IE) | (1<<TX0IE) |
+				(1<<ERRIE) );
 
 			#ifdef __C64__
 				#error not implemented yet
@@ -406,7 +542,8 @@ unsigned char mcp_status();
 		#else  //CAN_INTERRUPT
 			// configure IRQ: this only configures the INT Output of the mcp2515,
 			// not the int on the Atmel
-			mcp_write( CANINTE, (1<<RX0IE) ); //only turn RX int on
+			//only turn RX ints on
+			mcp_write( CANINTE, (1<<RX0IE) | (1<<RX1IE) );
 		#endif //CAN_INTERRUPT
 	}
 
@@ -418,7 +555,7 @@ unsigned char mcp_status();
 				return 0;
 			} else {
 				p = &RX_BUFFER[RX_TAIL];
-				if(++RX_TAIL == CAN_RX_BUFFER_SIZE) RX_TAIL = 0;
+				RX_TAIL = (RX_TAIL + 1) & CAN_RX_MASK;
 				return &(p->msg);
 			}
 		}
@@ -429,7 +566,7 @@ unsigned char mcp_status();
 			while(RX_HEAD == RX_TAIL) {};
 
 			p = &RX_BUFFER[RX_TAIL];
-			if(++RX_TAIL == CAN_RX_BUFFER_SIZE) RX_TAIL = 0;
+			RX_TAIL = (RX_TAIL + 1) & CAN_RX_MASK;
 
 			return &(p->msg);
 		}
@@ -445,7 +582,7 @@ unsigned char mcp_status();
 			can_message_x *p;
 			p = &TX_BUFFER[TX_HEAD];
 			while (p->flags&0x01); //wait until buffer is free
-			if(++TX_HEAD == CAN_TX_BUFFER_SIZE) TX_HEAD = 0;
+			TX_HEAD = (TX_HEAD + 1) & CAN_TX_MASK;
 			return &(p->msg);
 		}
 
@@ -456,11 +593,11 @@ unsigned char mcp_status();
 				msg->flags |= 0x01;
 			}
 			if(!TX_INT) {
-				if(((can_message_x*)&TX_BUFFER[TX_TAIL])->flags & 0x01) {
-					((can_message_x*)&TX_BUFFER[TX_TAIL])->flags &= ~0x01;
+				if(TX_BUFFER[TX_TAIL].flags & 0x01) {
+					TX_BUFFER[TX_TAIL].flags &= ~0x01;
 					TX_INT = 1;
 					message_load(&TX_BUFFER[TX_TAIL]);
-					if(++TX_TAIL == CAN_TX_BUFFER_SIZE) TX_TAIL = 0;
+					TX_TAIL = (TX_TAIL + 1) & CAN_TX_MASK;
 				}
 			}
 		}
@@ -468,22 +605,32 @@ unsigned char mcp_status();
 		can_message_x RX_MESSAGE, TX_MESSAGE;
 
 		can_message * can_get_nb() {
+			unsigned char status;
+
 			//check the pin, that the MCP's interrupt output connects to
 			if(SPI_REG_PIN_MCP_INT & (1<<SPI_PIN_MCP_INT)) {
 				return 0;
+			}
+
+			//So the MCP Generates an RX Interrupt, RXB0 holds the older message
+			status = mcp_status();
+			if (status & 0x01) {
+				message_fetch(&RX_MESSAGE, 0);
+			} else if (status & 0x02) {
+				message_fetch(&RX_MESSAGE, 1);
 			} else {
-				//So the MCP Generates an RX Interrupt
-				message_fetch(&RX_MESSAGE);
-				return &(RX_MESSAGE.msg);
+				return 0;
 			}
+			return &(RX_MESSAGE.msg);
 		}
 
 		can_message * can_get() {
+			can_message *msg;
+
 			//wait while the MCP doesn't generate an RX Interrupt
-			while(SPI_REG_PIN_MCP_INT & (1<<SPI_PIN_MCP_INT)) {};
+			while((msg = can_get_nb()) == 0) {};
 
-			message_fetch(&RX_MESSAGE);
-			return &(RX_MESSAGE.msg);
+			return msg;
 		}
 
 		//only for compatibility with Interrupt driven Version
@@ -499,23 +646,112 @@ unsigned char mcp_status();
 		}
 	#endif /* CAN_INTERRUPT */
 #else /* ifdef __AVR__ */
-	/* stubs for simulator */
-	static can_message null_msg = {0};
+	/* loopback stand-in for the simulator: every transmitted message is
+	 * received again, so the LAP handlers can be exercised without a bus */
+	#define CAN_LOOPBACK_SIZE 64
+
+	static can_message_x loopback_buffer[CAN_LOOPBACK_SIZE];
+	static unsigned char loopback_head, loopback_tail;
+	static can_message_x loopback_tx;
+	static can_filter_t loopback_filters[6];
+	static unsigned char loopback_filter_count;
+
+	void (*can_loopback_monitor)(can_message const *msg);
+
+	//mimics the acceptance filters of the mcp2515
+	static unsigned char loopback_accept(can_message const *msg) {
+		unsigned char x;
+		if (!loopback_filter_count) {
+			return 1;
+		}
+		for (x = 0; x < loopback_filter_count; x++) {
+			if (msg->addr_dst == loopback_filters[x].addr_dst &&
+					msg->port_dst == loopback_filters[x].port_dst) {
+				return 1;
+			}
+		}
+		return 0;
+	}
+
 	unsigned char mcp_status() {return 0;}
 	void mcp_bitmod(unsigned char reg, unsigned char mask, unsigned char val){}
 	void message_load(can_message_x * msg){}
-	void message_fetch(can_message_x * msg){}
+	void message_fetch(can_message_x * msg, unsigned char rxb){}
 	void mcp_reset(){}
 	void mcp_write(unsigned char reg, unsigned char data){}
 	unsigned char mcp_read(unsigned char reg){return 0;}
 	void can_setmode(can_mode_t mode) {}
-	void can_setfilter() {}
+	void can_setfilter() {
+		loopback_filter_count = 0;
+	}
+
+	void can_setfilter_dst(can_filter_t const *filters, unsigned char count) {
+		unsigned char x;
+		if (count > 6) {
+			count = 6;
+		}
+		for (x = 0; x < count; x++) {
+			loopback_filters[x] = filters[x];
+		}
+		loopback_filter_count = count;
+	}
+
+	void can_get_stats(can_stats_t *stats) {
+		stats->rx_dropped = can_rx_dropped;
+		stats->rx_overruns = can_rx_overruns;
+		stats->tec = stats->rec = stats->eflg = 0;
+	}
+
+	void can_clear_stats() {
+		can_rx_dropped = can_rx_overruns = 0;
+	}
 	void can_setled(unsigned char led, unsigned char state){}
 	void delayloop(){}
-	void can_init(){}
-	can_message * can_get_nb(){return &null_msg;}
-	can_message * can_get(){return &null_msg;}
-	can_message * can_buffer_get(){return &null_msg;}
-	void can_transmit(can_message * msg){}
+
+	void can_init(){
+		loopback_head = loopback_tail = 0;
+		can_setfilter();
+	}
+
+	can_message * can_get_nb(){
+		can_message_x *p;
+		if (loopback_head == loopback_tail) {
+			return 0;
+		}
+		p = &loopback_buffer[loopback_tail];
+		loopback_tail = (loopback_tail + 1) % CAN_LOOPBACK_SIZE;
+		return &(p->msg);
+	}
+
+	can_message * can_get(){
+		can_message *msg;
+		while ((msg = can_get_nb()) == 0) {};
+		return msg;
+	}
+
+	can_message * can_buffer_get(){
+		return &(loopback_tx.msg);
+	}
+
+	void can_transmit(can_message * msg){
+		can_message copy = *msg;
+		unsigned char head = (loopback_head + 1) % CAN_LOOPBACK_SIZE;
+
+		if (loopback_accept(&copy)) {
+			//the message is lost if nobody fetched the older ones
+			if (head != loopback_tail) {
+				loopback_buffer[loopback_head].msg = copy;
+				loopback_head = head;
+			} else {
+				CAN_COUNT(can_rx_dropped);
+			}
+		}
+
+		//let the simulator act as further node on the bus
+		if (can_loopback_monitor) {
+			can_loopback_monitor(&copy);
+		}
+	}
+
 	void can_free(can_message * msg){}
 #endif
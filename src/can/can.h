@@ -6,8 +6,8 @@
  *
  * #define CAN_INTERRUPT 1	     // set this to enable interrupt driven
  *                               // and buffering version
- * #define CAN_RX_BUFFER_SIZE 2	 // only used for Interrupt
- * #define CAN_TX_BUFFER_SIZE 2	 // only used for Interrupt
+ * #define CAN_RX_BUFFER_SIZE 8	 // only used for Interrupt, power of two
+ * #define CAN_TX_BUFFER_SIZE 4	 // only used for Interrupt, power of two
  */
 
 /*****************************************************************************
@@ -49,6 +49,21 @@ typedef enum {
 	normal, mode_sleep, loopback, listenonly, config
 } can_mode_t;
 
+// acceptance filter for the destination of a message
+typedef struct {
+	can_addr_t addr_dst;
+	can_port_t port_dst;
+} can_filter_t;
+
+// receive statistics, counters saturate instead of wrapping around
+typedef struct {
+	uint16_t rx_dropped;  // lost because the receive queue was full
+	uint16_t rx_overruns; // lost because both MCP2515 buffers were full
+	uint8_t tec;          // transmit error counter of the MCP2515
+	uint8_t rec;          // receive error counter of the MCP2515
+	uint8_t eflg;         // error flags of the MCP2515
+} can_stats_t;
+
 /*****************************************************************************
  * Global variables
  */
@@ -62,9 +77,14 @@ extern unsigned char can_error;
 
 void can_init();
 void can_setfilter();
+// only accept messages matching one of the filters (at most 6)
+void can_setfilter_dst(can_filter_t const *filters, unsigned char count);
 void can_setmode( can_mode_t);
 void can_setled(unsigned char led, unsigned char state);
 
+void can_get_stats(can_stats_t *stats);
+void can_clear_stats();
+
 /*****************************************************************************
  * Sending
  */
@@ -123,4 +143,13 @@ can_message_v2 *can_get_v2_nb();
 
 void can_free_v2(can_message_v2 *msg);
 
+/*****************************************************************************
+ * Simulator
+ */
+
+#ifndef __AVR__
+// gets called for every transmitted message of the loopback stand-in
+extern void (*can_loopback_monitor)(can_message const *msg);
+#endif
+
 #endif
@@ -36,74 +36,56 @@ void lap_reset(can_addr_t dst) {
 	can_transmit((can_message *) msg);
 }
 
-/*
-char *sdo_readbuf(lap_message *first_msg, 
-		unsigned char int length, unsigned char &reallength)
-{
-	unsigned char len = first_message->data[0];
-	char *buf = malloc(length);
-	char *cur = buf;
-
-	reallength = 0;
-	while( reallength < length ) {
-		can_message *msg = can_get();
-		
-		if ( msg->addr_src  != first_msg->addr_src  ||
-		     msg->addr_dest != fisrt_msg->addr_dest ||
-		     msg->port_src  != fisrt_msg->port_src  ||
-		     msg->port_dest != fisrt_msg->port_dest )
-		{
-			return buf;
-		}
-
-		memcpy(cur, msg->data, msg->dlc);
-		reallength+=msg->dlc;
-		msg->flags = 0x00;
-	}
+// start the transfer of a frame to dst
+void lap_borg_frame_begin(can_addr_t dst, uint8_t seq) {
+	pdo_message *msg = (pdo_message *) can_buffer_get();
+
+	msg->addr_src = 0;
+	msg->addr_dst = dst;
+	msg->port_src = PORT_BORG;
+	msg->port_dst = PORT_BORG;
+	msg->dlc = 2;
+	msg->cmd = FKT_BORG_FRAME_BEGIN;
+	msg->data[0] = seq;
 
-	return buf;
+	can_transmit((can_message *) msg);
 }
 
-// unsigned char sdo_sendpacket(lap_message *msg)
-// {
-// }
-// 
-// unsigned char sdo_sendpacket_nb(lap_message *msg)
-// {
-// }
-
-unsigned char sdo_sendbuf(lap_message *fst_msg, unsigned char *buf, unsigned char len)
-{
-	while(len > 0) {
-		can_message *msg = can_buffer_get();
-		msg->addr_src  = fst_msg->addr_src;
-		msg->addr_dest = fst_msg->addr_dest;
-		msg->port_src  = fst_msg->port_src;
-		msg->port_dest = fst_msg->port_dest;
-
-		msg->dlc = len > 8 ? 8 : len;
-		memcpy(msg->data, buf, msg->dlc);
-		msg->flags = 0x01;
-		can_transmit();
+// send up to BORG_FRAME_DATA_BYTES bytes of a row of a plane to dst
+void lap_borg_frame_data(can_addr_t dst, uint8_t seq, uint8_t row,
+		uint8_t plane, uint8_t offset, uint8_t const *data, uint8_t len) {
+	pdo_message *msg = (pdo_message *) can_buffer_get();
+
+	if (len > BORG_FRAME_DATA_BYTES) {
+		len = BORG_FRAME_DATA_BYTES;
 	}
-	// XXX wait for ACK
+
+	msg->addr_src = 0;
+	msg->addr_dst = dst;
+	msg->port_src = PORT_BORG;
+	msg->port_dst = PORT_BORG;
+	msg->dlc = 4 + len;
+	msg->cmd = FKT_BORG_FRAME_DATA;
+	msg->data[0] = seq;
+	msg->data[1] = row;
+	msg->data[2] = (plane << 4) | (offset & 0x0f);
+	memcpy(&msg->data[3], data, len);
+
+	can_transmit((can_message *) msg);
 }
 
+// ask dst to show the frame after count data messages
+void lap_borg_frame_show(can_addr_t dst, uint8_t seq, uint8_t count) {
+	pdo_message *msg = (pdo_message *) can_buffer_get();
 
-unsigned char sdo_sendbuf_nb(lap_message *fst_msg, unsigned char *buf, unsigned char len)
-{
-	while(len > 0) {
-		can_message *msg = can_buffer_get();
-		msg->addr_src  = fst_msg->addr_src;
-		msg->addr_dest = fst_msg->addr_dest;
-		msg->port_src  = fst_msg->port_src;
-		msg->port_dest = fst_msg->port_dest;
+	msg->addr_src = 0;
+	msg->addr_dst = dst;
+	msg->port_src = PORT_BORG;
+	msg->port_dst = PORT_BORG;
+	msg->dlc = 3;
+	msg->cmd = FKT_BORG_FRAME_SHOW;
+	msg->data[0] = seq;
+	msg->data[1] = count;
 
-		msg->dlc = len > 8 ? 8 : len;
-		memcpy(msg->data, buf, msg->dlc);
-		msg->flags = 0x01;
-		can_transmit();
-	}
-	// XXX wait for ACK
+	can_transmit((can_message *) msg);
 }
-*/
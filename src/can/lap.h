@@ -55,14 +55,29 @@ typedef enum {
 } ports;
 
 typedef enum {
-	FKT_MGT_PING        = 0x00,
-	FKT_MGT_PONG        = 0x01,
-	FKT_MGT_RESET       = 0x02,
-	FKT_MGT_AWAKE       = 0x03,
-	FKT_MGT_TIMEREQUEST = 0x04,
-	FKT_MGT_TIMEREPLY   = 0x05
+	FKT_MGT_PING         = 0x00,
+	FKT_MGT_PONG         = 0x01,
+	FKT_MGT_RESET        = 0x02,
+	FKT_MGT_AWAKE        = 0x03,
+	FKT_MGT_TIMEREQUEST  = 0x04,
+	FKT_MGT_TIMEREPLY    = 0x05,
+	FKT_MGT_STATSREQUEST = 0x06,
+	FKT_MGT_STATSREPLY   = 0x07
 } lap_mgt_fkts;
 
+/****************************************************************************
+ * CAN statistics on PORT_MGT
+ *
+ * FKT_MGT_STATSREQUEST  data[0]: clear the counters after replying if not 0
+ * FKT_MGT_STATSREPLY    data[0..1]: messages dropped by the receive queue
+ *                       data[2..3]: messages lost inside the CAN controller
+ *                       data[4]: transmit error counter
+ *                       data[5]: receive error counter
+ *                       data[6]: error flags of the CAN controller
+ *
+ * 16 bit values are sent little endian and saturate at 0xFFFF.
+ */
+
 typedef enum {
 	FKT_LAMPE_SET      = 0x00,
 	FKT_LAMPE_SETMASK  = 0x01,
@@ -74,9 +89,55 @@ typedef enum {
 	FKT_BORG_INFO              = 0x00,
 	FKT_BORG_MODE              = 0x01,
 	FKT_BORG_SCROLLTEXT_RESET  = 0x02,
-	FKT_BORG_SCROLLTEXT_APPEND = 0x03
+	FKT_BORG_SCROLLTEXT_APPEND = 0x03,
+	FKT_BORG_FRAME_BEGIN       = 0x10,
+	FKT_BORG_FRAME_DATA        = 0x11,
+	FKT_BORG_FRAME_SHOW        = 0x12,
+	FKT_BORG_FRAME_ACK         = 0x13,
+	FKT_BORG_SYNC_TICK         = 0x14,
+	FKT_BORG_SYNC_START        = 0x15
 } lap_borg_fkts;
 
+/****************************************************************************
+ * Bulk frame transfer on PORT_BORG
+ *
+ * FKT_BORG_FRAME_BEGIN  data[0]: sequence number of the frame
+ * FKT_BORG_FRAME_DATA   data[0]: sequence number
+ *                       data[1]: row
+ *                       data[2]: plane (high nibble), byte offset (low nibble)
+ *                       data[3..6]: up to BORG_FRAME_DATA_BYTES plane bytes
+ * FKT_BORG_FRAME_SHOW   data[0]: sequence number
+ *                       data[1]: number of data messages sent (modulo 256)
+ * FKT_BORG_FRAME_ACK    data[0]: sequence number
+ *                       data[1]: status (see below)
+ *                       data[2]: number of data messages received (mod 256)
+ *                       data[3]: window, i.e. the number of data messages the
+ *                                sender may send before waiting for an ack
+ *
+ * The borg acknowledges BEGIN and SHOW as well as every window-th data
+ * message, so a sender never overruns its receive queue.
+ */
+
+#define BORG_FRAME_DATA_BYTES   4
+
+#define BORG_FRAME_OK           0x00
+#define BORG_FRAME_SHOWN        0x01
+#define BORG_FRAME_INCOMPLETE   0x02
+#define BORG_FRAME_BAD_SEQ      0x03
+
+/****************************************************************************
+ * Synchronized playback on PORT_BORG, broadcast (addr_dst 0xff) by the
+ * sync master
+ *
+ * FKT_BORG_SYNC_TICK    data[0..1]: millisecond tick of the master
+ * FKT_BORG_SYNC_START   data[0]: display_loop() mode to be started
+ *                       data[1..2]: master tick at which the mode starts
+ *                       data[3..4]: seed for the random number generator
+ *
+ * Ticks and seeds are sent little endian. All borgs need the same set of
+ * animations, so that the mode numbers refer to the same animation.
+ */
+
 typedef enum {
 	FKT_ONOFF_INFO = 0,
 	FKT_ONOFF_SET  = 1,
@@ -126,16 +187,20 @@ void lap_reset(can_addr_t dst);
 extern uint8_t lap_time_h, lap_time_m, lap_time_update;
 #endif
 
-/**
- * ServiceDataObject routinen
- *
-unsigned char *sdo_readbuf(sdo_message *first_message,
-		unsigned char length, unsigned char *actuallength);
+/****************************************************************************
+ * Bulk frame transfer (sender side)
+ */
 
-unsigned char sdo_sendbuf(sdo_message *fst_msg, unsigned char *buf, unsigned char len);
-unsigned char sdo_sendbuf_nb(sdo_message *fst_msg, unsigned char *buf, unsigned char len);
+// start the transfer of a frame to dst
+void lap_borg_frame_begin(can_addr_t dst, uint8_t seq);
+
+// send up to BORG_FRAME_DATA_BYTES bytes of a row of a plane to dst
+void lap_borg_frame_data(can_addr_t dst, uint8_t seq, uint8_t row,
+		uint8_t plane, uint8_t offset, uint8_t const *data, uint8_t len);
+
+// ask dst to show the frame after count data messages
+void lap_borg_frame_show(can_addr_t dst, uint8_t seq, uint8_t count);
 
-*/
 /////////////////////////////////////////////////////////////////////////////
 /* Usage
 
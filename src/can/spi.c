@@ -4,6 +4,10 @@
 
 #include "spi.h"
 
+#if !defined(__AVR__) || !defined(SPI_HARDWARE)
+unsigned char spi_rx;
+#endif
+
 #ifdef __AVR__
 
 void spi_init(){
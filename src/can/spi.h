@@ -7,4 +7,30 @@ void spi_init();
 
 unsigned char spi_data(unsigned char c);
 
+#if defined(__AVR__) && defined(SPI_HARDWARE)
+#include <avr/io.h>
+
+// starts shifting out a byte, code up to spi_wait() overlaps the transfer
+inline static void spi_start(unsigned char c) {
+	SPDR = c;
+}
+
+// waits for the transfer started by spi_start() and returns the received byte
+inline static unsigned char spi_wait() {
+	while(!(SPSR & (1<<SPIF)));
+	return SPDR;
+}
+#else
+// software SPI can't overlap, so the byte is transferred right away
+extern unsigned char spi_rx;
+
+inline static void spi_start(unsigned char c) {
+	spi_rx = spi_data(c);
+}
+
+inline static unsigned char spi_wait() {
+	return spi_rx;
+}
+#endif
+
 #endif
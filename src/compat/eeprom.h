@@ -6,11 +6,16 @@
 #else
 	#include <stdint.h>
 	
+	#include <stddef.h>
+
 	void 	eeprom_write_byte (uint8_t *p, uint8_t value);
 	void 	eeprom_write_word (uint16_t *p, uint16_t value);
+	void 	eeprom_update_byte (uint8_t *p, uint8_t value);
+	void 	eeprom_update_block (const void *src, void *dst, size_t n);
 	
 	uint8_t  eeprom_read_byte (const uint8_t *p);
 	uint16_t eeprom_read_word (const uint16_t *p);
+	void 	eeprom_read_block (void *dst, const void *src, size_t n);
 	
 	#define eeprom_busy_wait()
 	#define 	EEMEM   __attribute__((section(".eeprom")))
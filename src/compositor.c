@@ -0,0 +1,268 @@
+/**
+ * @file compositor.c
+ * @brief Implementation of the intensity buffer compositor.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "compositor.h"
+#include "pixel.h"
+#include "compat/pgmspace.h"
+
+
+/** 4x4 Bayer matrix for ordered dithering. */
+static uint8_t const compositor_bayer[4][4] PROGMEM =
+{
+	{ 0,  8,  2, 10},
+	{12,  4, 14,  6},
+	{ 3, 11,  1,  9},
+	{15,  7, 13,  5}
+};
+
+
+#ifdef TEMPORAL_DITHER_SUPPORT
+#	if (TEMPORAL_DITHER_PHASES < 2) || (TEMPORAL_DITHER_PHASES > 8)
+#		error TEMPORAL_DITHER_PHASES must be in the range of 2..8
+#	endif
+
+volatile unsigned char borg_hw_frame_count;
+
+/** Planes which are lit during every phase. */
+static uint8_t compositor_frcBase[NUMPLANE][NUM_ROWS][LINEBYTES];
+
+/** Pixels which get lit one level brighter during a given phase. */
+static uint8_t compositor_frcBump[TEMPORAL_DITHER_PHASES][NUM_ROWS][LINEBYTES];
+
+/** Phase which is currently shown. */
+static uint8_t compositor_frcPhase;
+
+/** Value of the frame counter when the current phase was shown. */
+static unsigned char compositor_frcFrame;
+
+/** False if the frame buffer has been modified behind our back. */
+static bool compositor_frcActive;
+
+
+/**
+ * Writes the image of a phase to the frame buffer.
+ * @param nPhase The phase to be shown.
+ * @param bVerify If true, the frame buffer is expected to contain the previous
+ *                phase, otherwise it is left untouched and false is returned.
+ * @return true if the frame buffer has been written.
+ */
+static bool compositor_frcShow(uint8_t const nPhase,
+                               bool const bVerify)
+{
+	uint8_t const nPrevPhase = nPhase ? nPhase - 1 : TEMPORAL_DITHER_PHASES - 1;
+	for (uint8_t y = 0; y < NUM_ROWS; ++y)
+	{
+		for (uint8_t nByte = 0; nByte < LINEBYTES; ++nByte)
+		{
+			uint8_t const nBump = compositor_frcBump[nPhase][y][nByte];
+			uint8_t const nPrevBump = compositor_frcBump[nPrevPhase][y][nByte];
+			// a bump lights the lowest plane which isn't already lit
+			uint8_t nLower = 0xFF;
+			for (uint8_t nPlane = 0; nPlane < NUMPLANE; ++nPlane)
+			{
+				uint8_t const nBase = compositor_frcBase[nPlane][y][nByte];
+				if (bVerify && (pixmap[nPlane][y][nByte] !=
+						(nBase | (nPrevBump & nLower))))
+				{
+					return false;
+				}
+				pixmap[nPlane][y][nByte] = nBase | (nBump & nLower);
+				nLower = nBase;
+			}
+		}
+	}
+	return true;
+}
+
+
+void compositor_tick(void)
+{
+	unsigned char const nFrame = borg_hw_frame_count;
+	if (compositor_frcActive && (nFrame != compositor_frcFrame))
+	{
+		compositor_frcFrame = nFrame;
+		uint8_t const nPhase = (compositor_frcPhase + 1) % TEMPORAL_DITHER_PHASES;
+		// someone else drew to the frame buffer, so we must not interfere
+		compositor_frcActive = compositor_frcShow(nPhase, true);
+		compositor_frcPhase = nPhase;
+	}
+}
+#endif /* TEMPORAL_DITHER_SUPPORT */
+
+
+/**
+ * Calculates the minimum intensity for each plane. The thresholds lie halfway
+ * between the intensities of neighbouring brightness levels so that
+ * COMPOSITOR_LEVEL() values stay stable even if dithering is applied.
+ * @param pThresholds Array which receives the thresholds.
+ */
+#ifndef TEMPORAL_DITHER_SUPPORT
+static void compositor_getThresholds(uint8_t pThresholds[NUMPLANE])
+{
+	for (uint8_t nPlane = 0; nPlane < NUMPLANE; ++nPlane)
+	{
+		pThresholds[nPlane] = ((2u * nPlane + 1u) * 255u + 2u * NUMPLANE - 1u)
+				/ (2u * NUMPLANE);
+	}
+}
+
+
+/**
+ * Calculates the dithering offsets for the positions of the Bayer matrix,
+ * scaled to the distance between two brightness levels.
+ * @param pOffsets Array which receives the offsets.
+ */
+static void compositor_getDitherOffsets(int16_t pOffsets[4][4])
+{
+	for (uint8_t y = 0; y < 4; ++y)
+	{
+		for (uint8_t x = 0; x < 4; ++x)
+		{
+			int16_t const nBayer = pgm_read_byte(&compositor_bayer[y][x]);
+			pOffsets[y][x] = ((2 * nBayer - 15) * (255 / NUMPLANE)) / 32;
+		}
+	}
+}
+#endif /* TEMPORAL_DITHER_SUPPORT */
+
+
+/**
+ * The actual transcription of intensities into planes, shared by both buffer
+ * layouts.
+ * @param pBuf Start of the intensity buffer.
+ * @param nStride Number of bytes per row of the intensity buffer.
+ * @param bPacked true if two pixels are packed into one byte.
+ * @param bDither Apply ordered dithering if true.
+ */
+static void compositor_transcribe(uint8_t const *pBuf,
+                                  uint8_t const nStride,
+                                  bool const bPacked,
+                                  bool const bDither)
+{
+#ifdef TEMPORAL_DITHER_SUPPORT
+	// temporal dithering supersedes the ordered one
+	(void)bDither;
+	compositor_frcActive = false;
+#else
+	uint8_t nThresholds[NUMPLANE];
+	compositor_getThresholds(nThresholds);
+
+	int16_t nOffsets[4][4];
+	if (bDither)
+	{
+		compositor_getDitherOffsets(nOffsets);
+	}
+#endif
+
+	for (uint8_t y = 0; y < NUM_ROWS; ++y, pBuf += nStride)
+	{
+		uint8_t x = 0;
+		for (uint8_t nByte = 0; nByte < LINEBYTES; ++nByte)
+		{
+			// assemble eight pixels per plane before touching the frame buffer
+			uint8_t nPlaneBits[NUMPLANE] = {0};
+#ifdef TEMPORAL_DITHER_SUPPORT
+			uint8_t nBumpBits[TEMPORAL_DITHER_PHASES] = {0};
+#endif
+			for (uint8_t nMask = 0x01; nMask && (x < NUM_COLS); nMask <<= 1, ++x)
+			{
+				int16_t nIntensity;
+				if (bPacked)
+				{
+					uint8_t const nPair = pBuf[x / 2u];
+					nIntensity = ((x & 0x01u) ? (nPair >> 4) : (nPair & 0x0Fu))
+							* 17;
+				}
+				else
+				{
+					nIntensity = pBuf[x];
+				}
+
+#ifdef TEMPORAL_DITHER_SUPPORT
+				// split the intensity into a base level and the number of
+				// phases during which the next level is shown
+				uint16_t const nScaled = (uint16_t)nIntensity * NUMPLANE;
+				uint8_t nLevel = nScaled / 255u;
+				uint8_t nOn = ((nScaled % 255u) * TEMPORAL_DITHER_PHASES + 127u)
+						/ 255u;
+				if (nOn == TEMPORAL_DITHER_PHASES)
+				{
+					++nLevel;
+					nOn = 0;
+				}
+
+				for (uint8_t nPlane = 0; nPlane < nLevel; ++nPlane)
+				{
+					nPlaneBits[nPlane] |= nMask;
+				}
+
+				// error accumulator, its start value is staggered by the Bayer
+				// matrix so that neighbouring pixels don't flicker in unison
+				uint8_t nAcc = (pgm_read_byte(&compositor_bayer[y % 4u][x % 4u])
+						* TEMPORAL_DITHER_PHASES) / 16u;
+				for (uint8_t nPhase = 0; nPhase < TEMPORAL_DITHER_PHASES; ++nPhase)
+				{
+					nAcc += nOn;
+					if (nAcc >= TEMPORAL_DITHER_PHASES)
+					{
+						nAcc -= TEMPORAL_DITHER_PHASES;
+						nBumpBits[nPhase] |= nMask;
+					}
+				}
+#else
+				if (bDither)
+				{
+					nIntensity += nOffsets[y % 4u][x % 4u];
+				}
+
+				// planes are lit in ascending order (like setpixel() does)
+				for (uint8_t nPlane = 0; (nPlane < NUMPLANE) &&
+						(nIntensity >= nThresholds[nPlane]); ++nPlane)
+				{
+					nPlaneBits[nPlane] |= nMask;
+				}
+#endif
+			}
+
+			for (uint8_t nPlane = 0; nPlane < NUMPLANE; ++nPlane)
+			{
+#ifdef TEMPORAL_DITHER_SUPPORT
+				compositor_frcBase[nPlane][y][nByte] = nPlaneBits[nPlane];
+#else
+				pixmap[nPlane][y][nByte] = nPlaneBits[nPlane];
+#endif
+			}
+#ifdef TEMPORAL_DITHER_SUPPORT
+			for (uint8_t nPhase = 0; nPhase < TEMPORAL_DITHER_PHASES; ++nPhase)
+			{
+				compositor_frcBump[nPhase][y][nByte] = nBumpBits[nPhase];
+			}
+#endif
+		}
+	}
+
+#ifdef TEMPORAL_DITHER_SUPPORT
+	compositor_frcShow(compositor_frcPhase, false);
+	compositor_frcFrame = borg_hw_frame_count;
+	compositor_frcActive = true;
+#endif
+}
+
+
+void compositor_flush(intensity_buf_t pBuf,
+                      bool const bDither)
+{
+	compositor_transcribe(&pBuf[0][0], NUM_COLS, false, bDither);
+}
+
+
+void compositor_flush4(intensity4_buf_t pBuf,
+                       bool const bDither)
+{
+	compositor_transcribe(&pBuf[0][0], (NUM_COLS + 1) / 2, true, bDither);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file compositor.h
+ * @brief Converts per-pixel intensities to the bit planes of the frame buffer.
+ *
+ * Animations which want real shades draw into an intensity buffer (either one
+ * byte per pixel or two pixels packed into one byte) and hand it over to the
+ * compositor, which distributes the intensities to the planes of the frame
+ * buffer in a single pass. An intensity of 0 means off, the maximum intensity
+ * means full brightness. Optionally, ordered dithering is applied to smooth
+ * the steps between the available brightness levels.
+ *
+ * If TEMPORAL_DITHER_SUPPORT is enabled, intensities between two levels are
+ * shown by alternating between both levels over TEMPORAL_DITHER_PHASES frames
+ * instead, which yields extra grey levels without additional planes. The
+ * phases are advanced by compositor_tick() as long as nobody else writes to
+ * the frame buffer.
+ */
+
+#ifndef COMPOSITOR_H_
+#define COMPOSITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+/** Intensity buffer with one byte (0..255) per pixel. */
+typedef uint8_t intensity_buf_t[NUM_ROWS][NUM_COLS];
+
+/**
+ * Intensity buffer with four bits (0..15) per pixel. Even columns are kept in
+ * the low nibble, odd columns in the high nibble of a byte.
+ */
+typedef uint8_t intensity4_buf_t[NUM_ROWS][(NUM_COLS + 1) / 2];
+
+/** Maps a brightness level (0..NUMPLANE) to an 8 bit intensity. */
+#define COMPOSITOR_LEVEL(level) ((uint8_t)(((level) * 255u) / NUMPLANE))
+
+/** Maps a brightness level (0..NUMPLANE) to the nearest 4 bit intensity. */
+#define COMPOSITOR_LEVEL4(level) \
+	((uint8_t)((((level) * 30u) / NUMPLANE + 1u) / 2u))
+
+
+/**
+ * Reads a pixel from a packed 4 bit intensity buffer.
+ * @param pBuf The intensity buffer.
+ * @param x x-coordinate
+ * @param y y-coordinate
+ * @return The intensity (0..15) of the given pixel.
+ */
+inline static uint8_t intensity4_get(intensity4_buf_t pBuf,
+                                     uint8_t const x,
+                                     uint8_t const y)
+{
+	uint8_t const nPair = pBuf[y][x / 2u];
+	return (x & 0x01u) ? (nPair >> 4) : (nPair & 0x0Fu);
+}
+
+
+/**
+ * Writes a pixel to a packed 4 bit intensity buffer.
+ * @param pBuf The intensity buffer.
+ * @param x x-coordinate
+ * @param y y-coordinate
+ * @param nIntensity The new intensity (0..15) of the given pixel.
+ */
+inline static void intensity4_set(intensity4_buf_t pBuf,
+                                  uint8_t const x,
+                                  uint8_t const y,
+                                  uint8_t const nIntensity)
+{
+	uint8_t *const pPair = &pBuf[y][x / 2u];
+	if (x & 0x01u)
+	{
+		*pPair = (*pPair & 0x0Fu) | (nIntensity << 4);
+	}
+	else
+	{
+		*pPair = (*pPair & 0xF0u) | (nIntensity & 0x0Fu);
+	}
+}
+
+
+/**
+ * Transcribes an 8 bit intensity buffer to the frame buffer.
+ * @param pBuf The intensity buffer.
+ * @param bDither Apply ordered dithering if true.
+ */
+void compositor_flush(intensity_buf_t pBuf,
+                      bool const bDither);
+
+
+/**
+ * Transcribes a packed 4 bit intensity buffer to the frame buffer.
+ * @param pBuf The intensity buffer.
+ * @param bDither Apply ordered dithering if true.
+ */
+void compositor_flush4(intensity4_buf_t pBuf,
+                       bool const bDither);
+
+
+#ifdef TEMPORAL_DITHER_SUPPORT
+/** Frame counter which gets incremented by the display driver. */
+extern volatile unsigned char borg_hw_frame_count;
+
+
+/**
+ * Shows the next temporal dithering phase if the display has finished a frame
+ * since the last call. Gets called from wait(), so animations don't have to
+ * care about it.
+ */
+void compositor_tick(void);
+#endif
+
+#endif /* COMPOSITOR_H_ */
@@ -27,8 +27,12 @@
 #endif
 
 // can.[ch] defines
-#define CAN_RX_BUFFER_SIZE 2	//only used for Interrupt
-#define CAN_TX_BUFFER_SIZE 2	//only used for Interrupt
+#ifndef CAN_RX_BUFFER_SIZE
+	#define CAN_RX_BUFFER_SIZE 8	//only used for Interrupt
+#endif
+#ifndef CAN_TX_BUFFER_SIZE
+	#define CAN_TX_BUFFER_SIZE 4	//only used for Interrupt
+#endif
 #endif
 
 #define INIT_EEPROM
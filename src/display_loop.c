@@ -30,7 +30,7 @@
 #include "borg_hw/borg_hw.h"
 #include "can/borg_can.h"
 #include "random/prng.h"
-#include "random/persistentCounter.h"
+#include "kvstore.h"
 #include "mcuf/mcuf.h"
 #include "menu/menu.h"
 #include "pixel.h"
@@ -76,6 +76,16 @@ void display_loop(){
 	waitForFire = 1;
 #endif
 
+#ifdef JOYSTICK_REPLAY_SUPPORT
+	// a mode jump ends any recording or replay
+	replay_stop();
+#endif
+
+#ifdef CAN_SUPPORT
+	// a mode jump may have left bcan_frame_stream() behind
+	bcan_frame_stop();
+#endif
+
 	oldOldmode = oldMode;
 
 #ifdef JOYSTICK_SUPPORT
@@ -88,6 +98,13 @@ void display_loop(){
 #endif
 		oldMode = mode;
 
+#ifdef CAN_SUPPORT
+		// start the mode in step with the other borgs on the bus
+		if (mode < BCAN_SYNC_MODE) {
+			bcan_sync_next(mode);
+		}
+#endif
+
 		switch(mode++) {
 
 #ifdef ANIMATION_SCROLLTEXT
@@ -97,8 +114,9 @@ void display_loop(){
 	#ifdef RANDOM_SUPPORT
 			{
 				char a[28];
-				sprintf(a,"</# counter == %lu  ",
-					(unsigned long)percnt_get(&g_reset_counter, &g_reset_counter_idx));
+				uint32_t nResets = 0;
+				kv_get(KV_RESET_COUNTER, &nResets, sizeof(nResets));
+				sprintf(a,"</# counter == %lu  ", (unsigned long)nResets);
 				scrolltext(a);
 			}
 	#endif
@@ -322,8 +340,27 @@ void display_loop(){
 		  break;
 #endif
 
+#ifdef JOYSTICK_REPLAY_SUPPORT
+		case 40:
+			menu_demo();
+			break;
+#endif
+
 #include "user/user_loop.c"
 
+#ifdef CAN_SUPPORT
+		case BCAN_STREAM_MODE:
+			bcan_frame_stream();
+			mode = oldOldmode;
+			break;
+
+#  ifndef CAN_SYNC_MASTER
+		case BCAN_SYNC_MODE:
+			mode = bcan_sync_wait();
+			break;
+#  endif
+#endif
+
 #ifdef MENU_SUPPORT
 		case 0xFDu:
 			mode = 1;
@@ -9,6 +9,24 @@
 #include <avr/eeprom.h>
 #include <stdint.h>
 
+#include "config.h"
+#include "kvstore.h"
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#	include "joystick/replay.h"
+#endif
+
 uint8_t EEMEM do_not_use;
 
+// The linker doesn't know the EEPROM size of the part, so all EEMEM users
+// (do_not_use, kvstore.c and joystick/replay.c) get summed up here.
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#	define EEPROM_USED (1ul + KVSTORE_SIZE + REPLAY_EEPROM_SIZE)
+#else
+#	define EEPROM_USED (1ul + KVSTORE_SIZE)
+#endif
+
+#if EEPROM_USED > (E2END + 1ul)
+#	error EEMEM variables exceed the EEPROM, reduce KVSTORE_SIZE or JOYSTICK_REPLAY_LOG_SIZE
+#endif
+
 
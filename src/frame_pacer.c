@@ -0,0 +1,54 @@
+/**
+ * @file frame_pacer.c
+ * @brief Implementation of the frame pacer.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include "frame_pacer.h"
+#include "util.h"
+
+
+void frame_pacer_init(frame_pacer_t *pPacer,
+                      tick_t const nPeriod)
+{
+	assert(pPacer != NULL);
+
+	pPacer->nPeriod = nPeriod;
+	pPacer->nRenderTime = 0;
+	pPacer->nMaxRenderTime = 0;
+	pPacer->nOverruns = 0;
+	begin_frame(pPacer);
+}
+
+
+void begin_frame(frame_pacer_t *pPacer)
+{
+	assert(pPacer != NULL);
+
+	pPacer->nFrameStart = get_tick();
+}
+
+
+void end_frame(frame_pacer_t *pPacer)
+{
+	assert(pPacer != NULL);
+
+	tick_t const nRenderTime = get_tick() - pPacer->nFrameStart;
+	pPacer->nRenderTime = nRenderTime;
+	if (nRenderTime > pPacer->nMaxRenderTime)
+	{
+		pPacer->nMaxRenderTime = nRenderTime;
+	}
+
+	if (nRenderTime < pPacer->nPeriod)
+	{
+		wait(pPacer->nPeriod - nRenderTime);
+	}
+	else
+	{
+		++pPacer->nOverruns;
+		// keep the message handlers and the joystick query alive
+		wait(0);
+	}
+}
@@ -0,0 +1,67 @@
+/**
+ * @file frame_pacer.h
+ * @brief Frame-time-compensated pacing for animation and game loops.
+ *
+ * Instead of rendering a frame and then waiting a fixed amount of time (which
+ * makes the frame period depend on the render time), a loop brackets its
+ * rendering with begin_frame() and end_frame(). The latter only sleeps for the
+ * remainder of the target period and records frames which took longer.
+ */
+
+#ifndef FRAME_PACER_H_
+#define FRAME_PACER_H_
+
+#include <stdint.h>
+#include "util.h"
+
+/**
+ * State of a frame pacer. All time values are given in milliseconds.
+ */
+typedef struct frame_pacer_s
+{
+	tick_t nPeriod;          /**< target frame period */
+	tick_t nFrameStart;      /**< tick at which the current frame began */
+	tick_t nRenderTime;      /**< render time of the last finished frame */
+	tick_t nMaxRenderTime;   /**< longest render time seen so far */
+	uint16_t nOverruns;      /**< number of frames exceeding the period */
+}
+frame_pacer_t;
+
+
+/**
+ * Initializes a frame pacer and begins its first frame.
+ * @param pPacer The frame pacer to be initialized.
+ * @param nPeriod The target frame period.
+ */
+void frame_pacer_init(frame_pacer_t *pPacer,
+                      tick_t const nPeriod);
+
+
+/**
+ * Marks the beginning of a frame.
+ * @param pPacer The frame pacer in question.
+ */
+void begin_frame(frame_pacer_t *pPacer);
+
+
+/**
+ * Marks the end of a frame and waits for the remainder of the target period.
+ * If the frame took longer than that, it gets counted as an overrun and the
+ * function returns immediately (after servicing the wait() handlers once).
+ * @param pPacer The frame pacer in question.
+ */
+void end_frame(frame_pacer_t *pPacer);
+
+
+/**
+ * Convenience function for loops which just run frame after frame: ends the
+ * current frame and immediately begins the next one.
+ * @param pPacer The frame pacer in question.
+ */
+inline static void next_frame(frame_pacer_t *pPacer)
+{
+	end_frame(pPacer);
+	begin_frame(pPacer);
+}
+
+#endif /* FRAME_PACER_H_ */
@@ -36,6 +36,7 @@ static void ball_die (ball_t *in_b)
 	if (in_b->strength)
 	{
 		print_ballsleft(in_b);
+		playfield_invalidate();
 		ball_spawn_default (in_b);
 	}
 }
@@ -79,36 +80,9 @@ static void bounce_rand_vector (ball_t *in_b, int8_t in_bouncetype)
 }
 
 
-/* interface functions */
-
-void ball_think (ball_t *b)
+/* reflect the ball after it hit something */
+static void ball_bounce (ball_t *b, int8_t bounce, int8_t in_x)
 {
-	int8_t proj_x, proj_y, bounce, tmp;
-	
-	/* projection of the new coordinates */
-	proj_x = (b->x + (b->dir_x)) / 256;
-	proj_y = (b->y + (b->dir_y)) / 256;
-	
-	/* falling out of the field */
-	if (proj_y >= NUM_ROWS)
-		ball_die (b);
-
-	bounce = check_bounce (proj_x, b->y / 256);
-
-	/* bouncing on bricks needs special handling */
-	if (bounce & (BOUNCE_BRICK))
-		bounce |= BOUNCE_X;
-
-	tmp = check_bounce (b->x / 256, proj_y);
-	if (tmp & (BOUNCE_BRICK))
-		bounce |= BOUNCE_Y;
-	bounce |= tmp;
-	
-	tmp = check_bounce (proj_x, proj_y);
-	if (tmp & (BOUNCE_BRICK))
-		bounce |= BOUNCE_X | BOUNCE_Y;
-	bounce |= tmp;
-
 	bounce_rand_vector (b, bounce);
 
 	/* bounce in x direction */
@@ -146,7 +120,7 @@ void ball_think (ball_t *b)
 
 	if (bounce & BOUNCE_REBOUND)
 	{
-		rebound_reflect(b, proj_x);
+		rebound_reflect(b, in_x);
 	}
 
 	if (b->dir_x > BALL_MAXSPEED)
@@ -160,10 +134,41 @@ void ball_think (ball_t *b)
 
 	if (b->dir_y < -BALL_MAXSPEED)
 		b->dir_y = -BALL_MAXSPEED;
+}
+
+
+/* interface functions */
 
+void ball_think (ball_t *b)
+{
+	int8_t bounce, hit_x, hit_y;
+	uint8_t pass;
+
+	/* the ball only moves if its way is free, so it can't tunnel through
+	 * bricks at any speed; after a bounce the reflected way is checked once
+	 * more and if that is blocked as well, the ball waits for the next tick */
+	for (pass = 0; pass < 2; pass++)
+	{
+		bounce = playfield_sweep (b->x, b->y, b->dir_x, b->dir_y,
+		                          &hit_x, &hit_y);
+
+		if (bounce == BOUNCE_NONE)
+		{
+			b->y += b->dir_y;
+			b->x += b->dir_x;
+			return;
+		}
 
-	b->y += b->dir_y;
-	b->x += b->dir_x;
+		/* falling out of the field */
+		if (bounce & BOUNCE_LOST)
+		{
+			ball_die (b);
+			return;
+		}
+
+		/* damages bricks and tells what kind of object was hit */
+		ball_bounce (b, bounce | check_bounce (hit_x, hit_y), hit_x);
+	}
 }
 
 void ball_draw (ball_t *b)
@@ -173,6 +178,9 @@ void ball_draw (ball_t *b)
 	p.y = (uint8_t) abs(b->y / 256);
 
 	setpixel (p, 3);
+
+	/* the ball gets erased by the next redraw of the field */
+	playfield_invalidate_row (p.y % NUM_ROWS);
 }
 
 void ball_spawn_default (ball_t *in_b)
@@ -39,8 +39,8 @@ void borg_breakout_game()
 
 void borg_breakout(uint8_t demomode)
 {
-	game_field_t my_playfield[NUM_COLS][NUM_ROWS];
-	playfield = &my_playfield;
+	playfield_t my_playfield;
+	playfield_init(&my_playfield);
 
 	uint16_t cycles = DEMO_CYCLES;
 	uint8_t level = demomode ? random8() % 5 : 0;
@@ -54,18 +54,24 @@ void borg_breakout(uint8_t demomode)
 	uint8_t tick_divider = 1;
 	rebound_init();
 
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, 25);
+
 	while (cycles != 0)
 	{
-		wait(25);
+		next_frame(&pacer);
 
 		if (tick_divider || JOYISFIRE)
 			rebound_tick(demomode ? &balls[0] : NULL);
 
 		if (tick_divider)
 		{
-			ball_think(&(balls[0]));
+			uint8_t i;
+			for (i = 0; i < sizeof(balls) / sizeof(balls[0]); ++i)
+				ball_think(&(balls[i]));
 			playfield_draw();
-			ball_draw(&(balls[0]));
+			for (i = 0; i < sizeof(balls) / sizeof(balls[0]); ++i)
+				ball_draw(&(balls[i]));
 			if (!balls[0].strength)
 			{
 				print_score();
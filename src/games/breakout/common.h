@@ -28,6 +28,7 @@
 #include "../../random/prng.h"
 #include "../../compat/pgmspace.h"
 #include "../../util.h"
+#include "../../frame_pacer.h"
 #include "../../menu/menu.h"
 #include "../../pixel.h"
 #include "../../scrolltext/scrolltext.h"
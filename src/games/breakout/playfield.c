@@ -16,54 +16,68 @@
  *
  */
 
+#include <string.h>
 #include "playfield.h"
-game_field_t (*playfield)[NUM_COLS][NUM_ROWS];
+playfield_t *playfield;
 
 /* internal functions */
 
-/* this is the actual draw function for a single field
- */
-static void draw_single_field (uint8_t in_x, uint8_t in_y, game_field_t in_f)
-{
-	pixel tmp;
-	uint8_t b;
-	switch (in_f)
-	{
-		case b1:
-			b = 1;
-		break;
-
-		case rb:
-		case b2:
-			b = 2;
-		break;
+/* bit mask of column x within its byte */
+#define PLAYFIELD_MASK(x) ((uint8_t)(1u << ((x) % 8u)))
 
-		case b3:
-		case bl:
-		case bs:
-			b = 3;
-		break;
+static void brick_damage (int8_t in_x, int8_t in_y)
+{
+	uint8_t const i = in_x / 8u;
+	uint8_t const mask = PLAYFIELD_MASK(in_x);
+	uint8_t *const bit0 = &playfield->bits[0][in_y][i];
+	uint8_t *const bit1 = &playfield->bits[1][in_y][i];
 
-		default: /* this includes freespace */
-			b = 0;
-		break;
+	/* only b1..b3 (bit 2 cleared) can be damaged */
+	if ((playfield->bits[2][in_y][i] & mask) || !((*bit0 | *bit1) & mask))
+		return;
 
+	/* decrement the two low bits: 3 -> 2, 2 -> 1, 1 -> 0 */
+	if (*bit0 & mask)
+	{
+		*bit0 &= ~mask;
 	}
-	tmp.x = in_x;
-	tmp.y = in_y;
-	setpixel (tmp, b);
+	else
+	{
+		*bit1 &= ~mask;
+		*bit0 |= mask;
+	}
+	playfield_invalidate_row (in_y);
+	score_add (1);
 }
 
-static void brick_damage (int8_t in_x, int8_t in_y)
+/* interface functions */
+
+void playfield_init (playfield_t *in_playfield)
 {
-	if ((*playfield)[in_x][in_y] >= bs || (*playfield)[in_x][in_y] == 0)
-		return;
+	playfield = in_playfield;
+	memset (playfield->bits, 0, sizeof(playfield->bits));
+	playfield_invalidate ();
+}
 
-	(*playfield)[in_x][in_y] -= 1;
-	score_add (1);
+void playfield_invalidate ()
+{
+	memset (playfield->dirty, 0xFF, sizeof(playfield->dirty));
 }
 
-/* interface functions */
+game_field_t playfield_get (uint8_t in_x, uint8_t in_y)
+{
+	uint8_t const i = in_x / 8u;
+	uint8_t const mask = PLAYFIELD_MASK(in_x);
+	uint8_t f = 0;
+
+	if (playfield->bits[0][in_y][i] & mask)
+		f |= 0x01;
+	if (playfield->bits[1][in_y][i] & mask)
+		f |= 0x02;
+	if (playfield->bits[2][in_y][i] & mask)
+		f |= 0x04;
+	return f;
+}
 
 void playfield_set (uint8_t in_x, uint8_t in_y, game_field_t in_field)
 {
@@ -71,7 +85,22 @@ void playfield_set (uint8_t in_x, uint8_t in_y, game_field_t in_field)
 	{
 		return;
 	}
-	(*playfield)[in_x][in_y] = in_field;
+	if (playfield_get (in_x, in_y) == in_field)
+	{
+		return;
+	}
+
+	uint8_t const i = in_x / 8u;
+	uint8_t const mask = PLAYFIELD_MASK(in_x);
+	uint8_t b;
+	for (b = 0; b < 3; b++)
+	{
+		if (in_field & (1u << b))
+			playfield->bits[b][in_y][i] |= mask;
+		else
+			playfield->bits[b][in_y][i] &= ~mask;
+	}
+	playfield_invalidate_row (in_y);
 }
 
 int8_t check_bounce (int8_t in_x, int8_t in_y)
@@ -90,7 +119,7 @@ int8_t check_bounce (int8_t in_x, int8_t in_y)
 	}
 
 	/* collisions with real objects */
-	switch ((*playfield)[abs(in_x)][abs(in_y)])
+	switch (playfield_get (abs(in_x), abs(in_y)))
 	{
 		case b2:
 		case b3:
@@ -115,15 +144,109 @@ int8_t check_bounce (int8_t in_x, int8_t in_y)
 	return ov;
 }
 
+/* tells whether a ball would bounce when entering the given cell */
+static uint8_t playfield_blocks (int8_t in_x, int8_t in_y)
+{
+	if (in_x < 0 || in_x >= NUM_COLS || in_y < 0)
+		return 1;
+	if (in_y >= NUM_ROWS)
+		return 0;
+
+	game_field_t const f = playfield_get (in_x, in_y);
+	return f != sp && f != bl;
+}
+
+int8_t playfield_sweep (int16_t in_x, int16_t in_y, int16_t in_dx,
+                        int16_t in_dy, int8_t *out_x, int8_t *out_y)
+{
+	int8_t x = in_x >> 8, y = in_y >> 8;
+	int8_t const end_x = (in_x + in_dx) >> 8, end_y = (in_y + in_dy) >> 8;
+	int8_t const step_x = in_dx < 0 ? -1 : 1, step_y = in_dy < 0 ? -1 : 1;
+	uint16_t const len_x = abs(in_dx), len_y = abs(in_dy);
+
+	/* distances to the next cell borders */
+	uint16_t border_x = in_dx < 0 ? (in_x & 0xFF) + 1 : 256 - (in_x & 0xFF);
+	uint16_t border_y = in_dy < 0 ? (in_y & 0xFF) + 1 : 256 - (in_y & 0xFF);
+
+	while (x != end_x || y != end_y)
+	{
+		/* cross the border which the ball reaches first, i.e. compare
+		 * border_x / len_x with border_y / len_y */
+		int32_t const t_x = (int32_t)border_x * len_y;
+		int32_t const t_y = (int32_t)border_y * len_x;
+		int8_t side;
+
+		if (t_x < t_y)
+		{
+			x += step_x;
+			border_x += 256;
+			side = BOUNCE_X;
+		}
+		else if (t_x > t_y)
+		{
+			y += step_y;
+			border_y += 256;
+			side = BOUNCE_Y;
+		}
+		else
+		{
+			/* exactly through a corner, the cells beside it come first */
+			uint8_t const block_x = playfield_blocks (x + step_x, y);
+			uint8_t const block_y = playfield_blocks (x, y + step_y);
+			if (block_x || block_y)
+			{
+				*out_x = block_x ? x + step_x : x;
+				*out_y = block_x ? y : y + step_y;
+				return (block_x ? BOUNCE_X : 0) | (block_y ? BOUNCE_Y : 0);
+			}
+			x += step_x;
+			y += step_y;
+			border_x += 256;
+			border_y += 256;
+			side = BOUNCE_X | BOUNCE_Y;
+		}
+
+		if (y >= NUM_ROWS)
+			return BOUNCE_LOST;
+
+		if (playfield_blocks (x, y))
+		{
+			*out_x = x;
+			*out_y = y;
+			return side;
+		}
+	}
+	return BOUNCE_NONE;
+}
+
 void playfield_draw ()
 {
-	uint8_t x,y;
+	uint8_t y, i, plane;
 
-	for (x=0;x<NUM_COLS;x++)
+	for (y = 0; y < NUM_ROWS; y++)
 	{
-		for (y=0;y<NUM_ROWS;y++)
+		if (!(playfield->dirty[y / 8u] & (1u << (y % 8u))))
+			continue;
+		playfield->dirty[y / 8u] &= ~(1u << (y % 8u));
+
+		for (i = 0; i < LINEBYTES; i++)
 		{
-			draw_single_field (x,y, (*playfield)[x][y]);
+			uint8_t const v0 = playfield->bits[0][y][i];
+			uint8_t const v1 = playfield->bits[1][y][i];
+			uint8_t const v2 = playfield->bits[2][y][i];
+
+			/* brightness planes: b1 -> 1, b2/rb -> 2, b3/bs/bl -> 3 */
+			uint8_t const planes[3] =
+			{
+				v0 | v1 | v2,
+				v1 | v2,
+				(v0 & v1) | (v2 & ~v1)
+			};
+
+			for (plane = 0; plane < NUMPLANE; plane++)
+			{
+				pixmap[plane][y][i] = plane < 3 ? planes[plane] : 0;
+			}
 		}
 	}
 }
@@ -26,6 +26,7 @@
 #define BOUNCE_UNDEF   0x04
 #define BOUNCE_BRICK   0x08
 #define BOUNCE_REBOUND 0x10
+#define BOUNCE_LOST    0x20
 
 /* entries for the playing field */
 enum game_field
@@ -42,13 +43,44 @@ enum game_field
 	typedef enum game_field game_field_t;
 #endif
 
+/* bytes which are needed for the dirty flags of all rows */
+#define PLAYFIELD_DIRTY_BYTES ((NUM_ROWS + 7) / 8)
 
-extern game_field_t (*playfield)[NUM_COLS][NUM_ROWS];
+/* the playing field, bit n of every entry is kept in its own bit plane which
+ * is laid out like the lines of the frame buffer (bit x%8 of byte x/8) */
+typedef struct
+{
+	uint8_t bits[3][NUM_ROWS][LINEBYTES];
+	uint8_t dirty[PLAYFIELD_DIRTY_BYTES]; /* rows which need to be redrawn */
+} playfield_t;
+
+extern playfield_t *playfield;
+
+/* @description clear the given field, make it the current one and schedule
+ * a complete redraw
+ */
+void playfield_init (playfield_t *in_playfield);
 
-/* @description draw the current field
+/* @description draw all rows of the current field which have changed
  */
 void playfield_draw();
 
+/* @description schedule a redraw of a row, e.g. because something else was
+ * drawn over it
+ */
+inline static void playfield_invalidate_row (uint8_t in_y)
+{
+	playfield->dirty[in_y / 8u] |= 1u << (in_y % 8u);
+}
+
+/* @description schedule a redraw of the whole field
+ */
+void playfield_invalidate ();
+
+/* @description get the entry of a field
+ */
+game_field_t playfield_get (uint8_t in_x, uint8_t in_y);
+
 /* @description set a field with given property.
  */
 void playfield_set (uint8_t in_x, uint8_t in_y, game_field_t in_field);
@@ -57,4 +89,14 @@ void playfield_set (uint8_t in_x, uint8_t in_y, game_field_t in_field);
  */
 int8_t check_bounce (int8_t in_x, int8_t in_y);
 
+/* @description Walks the cells which a ball crosses while moving from
+ * (in_x, in_y) by (in_dx, in_dy), all in 8.8 fixed point, and stops at the
+ * first one which would make it bounce. Returns the side(s) the ball hit that
+ * cell from (BOUNCE_X and/or BOUNCE_Y) and stores the cell in out_x/out_y,
+ * BOUNCE_LOST if the ball falls out of the field or BOUNCE_NONE if the way is
+ * free. Unlike check_bounce(), the field is not modified.
+ */
+int8_t playfield_sweep (int16_t in_x, int16_t in_y, int16_t in_dx,
+                        int16_t in_dy, int8_t *out_x, int8_t *out_y);
+
 #endif /* PLAYFIELD_H */
@@ -47,7 +47,11 @@ void rebound_tick(ball_t *ball)
 {
 	if (ball != NULL)
 	{
+		/* keep the ball above the second field, so the rebound catches it
+		 * even if it drifts a column to the left before dropping down */
 		rbpos = (uint8_t) abs(ball->x / 256);
+		if (rbpos)
+			rbpos--;
 		if (rbpos > (NUM_COLS - REBOUND_SIZE))
 			rbpos = NUM_COLS - REBOUND_SIZE;
 		rebound_draw();
@@ -8,11 +8,13 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <string.h>
 #include "../../config.h"
 #include "../../compat/pgmspace.h"
 #include "../../pixel.h"
 #include "../../random/prng.h"
 #include "../../util.h"
+#include "../../frame_pacer.h"
 #include "../../joystick/joystick.h"
 #include "../../menu/menu.h"
 #include "../../scrolltext/scrolltext.h"
@@ -67,26 +69,39 @@ game_descriptor_t kart_game_descriptor __attribute__((section(".game_descriptors
 #define NUM_FLASHES 3
 #define BLINK_TIME 300
 
-// borders = (middle, width, obstacle_pos)
+// borders = (middle, width, obstacle_pos), ring buffer whose entry
+// street_head belongs to the top line
 uint8_t borders[NUM_ROWS][3];
+uint8_t street_head = 0;
 uint32_t extra_score = 0;
 
 void kart_game(){
 
 	// Initialisation
-	uint32_t decrease_width_div = DECREASE_WIDTH_DIV;
-	uint16_t accelerate_div = ACCELERATE_DIV;
+	// The street gets narrower and the kart faster right at the start and
+	// then after about DECREASE_WIDTH_DIV * 2^n and ACCELERATE_DIV * 2^n
+	// (n > 0) cycles respectively. Instead of checking the cycle count with
+	// modulo operations, every event counts down to its next deadline.
+	uint32_t decrease_width_period = DECREASE_WIDTH_DIV * 2;
+	uint32_t decrease_width_in = DECREASE_WIDTH_DIV * 2;
+	uint32_t accelerate_period = ACCELERATE_DIV * 2;
+	uint32_t accelerate_in = ACCELERATE_DIV * 2;
 	uint8_t key_ignore[2];
-	uint8_t drive_div = DRIVE_DIV;
+	uint8_t drive_div = DRIVE_DIV - 1;
+	uint8_t drive_in = 1;
+	uint8_t direction_in = 1;
+	// counted in drive steps
+	uint8_t toggle_border_in = 1;
+	uint8_t obstacle_in = 1;
 	uint8_t carpos = NUM_COLS / 2;
 	uint32_t cycle = 0;
 	uint8_t light_border = 1;
-	uint8_t width = NUM_COLS - 2;
+	uint8_t width = NUM_COLS - 3;
 	uint8_t middle = NUM_COLS / 2;
 	// obstacle_pos == 0 --> no obstacle
 	uint8_t obstacle_pos = 0;
 	char game_over[100] = "";
-	uint32_t boost_till = 0;
+	uint8_t boost_in = 0;
 	uint8_t boost_multiplier = 1;
 
 	key_ignore[0] = 0;
@@ -95,6 +110,7 @@ void kart_game(){
 	clear_screen(0);
 
 	// init street memory
+	street_head = 0;
 	for(uint8_t row = 0; row < NUM_ROWS; row++){
 		borders[row][0] = middle;
 		borders[row][1] = NUM_COLS;
@@ -107,19 +123,26 @@ void kart_game(){
 
 	setpixel((pixel){carpos, NUM_ROWS-1}, CARCOLOR);
 
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, WAIT);
+
 	// main loop
 	while(1){
 
 		// DECREASE WIDTH
-		if(cycle % decrease_width_div == 0){
+		if(--decrease_width_in == 0){
 			width--;
-			decrease_width_div *= 2;
+			decrease_width_in = decrease_width_period;
+			decrease_width_period *= 2;
 		}
 
 		// INCREASE SPEED
-		if(cycle % accelerate_div == 0 ){
-			drive_div--;
-			accelerate_div *= 2;
+		if(--accelerate_in == 0){
+			if(drive_div > 1){
+				drive_div--;
+			}
+			accelerate_in = accelerate_period;
+			accelerate_period *= 2;
 		}
 
 		// MOVE
@@ -147,10 +170,11 @@ void kart_game(){
 
 			key_ignore[1] = KEY_IGNORE_INITIAL;
 			key_ignore[0] = 0;
-		}else if(JOYISFIRE && boost_till == 0){
+		}else if(JOYISFIRE && boost_multiplier == 1){
 			blink();
-			boost_till = cycle + BOOST_CYCLES;
+			boost_in = BOOST_CYCLES + 1;
 			boost_multiplier = BOOST_MULTIPLIER;
+			drive_in = 1;
 		}else if(!(JOYISRIGHT || JOYISLEFT)){
 			key_ignore[1] = 0;
 			key_ignore[0] = 0;
@@ -160,17 +184,19 @@ void kart_game(){
 			break;
 		}
 
-		if(boost_till <= cycle && boost_multiplier > 1){
-			boost_till = cycle + BOOST_CYCLES;
-			boost_multiplier--;
-		}else if(boost_multiplier == 1){
-			boost_till = 0;
+		if(boost_multiplier > 1){
+			if(--boost_in == 0){
+				boost_in = BOOST_CYCLES;
+				boost_multiplier--;
+			}
+		}else{
 			extra_score += BOOST_CYCLES * BOOST_MULTIPLIER;
 		}
 
 
 		// DIRECTION-STEP
-		if(cycle % DIRECTION_DIV == 0){
+		if(--direction_in == 0){
+			direction_in = DIRECTION_DIV;
 			// generate a route
 			int rnd = random8();
 			if(rnd < CURVE_PROP && middle-(width/2) > 1){
@@ -181,7 +207,13 @@ void kart_game(){
 		}
 
 		// DRIVE-STEP
-		if(cycle % (drive_div / boost_multiplier) == 0){
+		if(--drive_in == 0){
+			// at full boost, the kart drives one line per frame
+			drive_in = drive_div / boost_multiplier;
+			if(drive_in == 0){
+				drive_in = 1;
+			}
+
 			// shift pixmap down
 			drive();
 
@@ -189,25 +221,19 @@ void kart_game(){
 			save_street(middle, width, obstacle_pos);
 
 			// draw new first line
-			unsigned int px;
-			for(px=0; px < NUM_COLS; px++){
-				if(px<middle-(width/2) || px >= middle+(width/2)){
-					if(light_border){
-						setpixel((pixel){px, 0}, BORDER_LIGHT);
-					}else{
-						setpixel((pixel){px, 0}, BORDER_DARK);
-					}
-				}
-			}
+			draw_street_line(middle - (width / 2), middle + (width / 2),
+					light_border ? BORDER_LIGHT : BORDER_DARK);
 
 			// toggle border color
-			if(cycle % ((drive_div / boost_multiplier)*4) == 0){
+			if(--toggle_border_in == 0){
+				toggle_border_in = 4;
 				light_border = 1-light_border;
 			}
 
 			// set obstacle
 			obstacle_pos = 0;
-			if(cycle % OBSTACLE_DIV == 0 ){
+			if(--obstacle_in == 0){
+				obstacle_in = OBSTACLE_DIV;
 				int rnd = random8();
 				if(rnd < OBSTACLE_PROP){
 					obstacle_pos = (random8() % width) + (middle - width/2);
@@ -227,7 +253,7 @@ void kart_game(){
 		if(key_ignore[1] > 0){
 			key_ignore[1]--;
 		}
-		wait(WAIT);
+		next_frame(&pacer);
 	}
 
 	snprintf(game_over, sizeof(game_over), "</#Game Over, Score: %lu",
@@ -240,35 +266,55 @@ void kart_game(){
  */
 void drive(void){
 
-	unsigned char plane, row, byte;
+	unsigned char plane;
 
+	// the lines of a plane are contiguous, so each plane is one block move
 	for(plane=0; plane<NUMPLANE; plane++){
-		for(row=NUM_ROWS-1;row>0; row--){
-			for(byte=0; byte < LINEBYTES; byte++){
-				pixmap[plane][row][byte] = pixmap[plane][row-1][byte];
-			}
-		}
-		for(byte=0; byte < LINEBYTES; byte++){
-			pixmap[plane][row][byte] = 0x00;
-		}
+		memmove(pixmap[plane][1], pixmap[plane][0],
+				(NUM_ROWS - 1) * LINEBYTES);
+		memset(pixmap[plane][0], 0x00, LINEBYTES);
+	}
+
+}
+
+/**
+ * Returns a byte whose lowest n bits are set (n gets clamped to 0..8).
+ */
+static uint8_t low_bits(int16_t n){
+	if(n <= 0){
+		return 0x00;
 	}
+	return n >= 8 ? 0xFF : (1u << n) - 1;
+}
 
+/**
+ * Draws the borders of the top line byte-wise, i.e. all pixels left of
+ * column left and from column right on get the given color.
+ */
+void draw_street_line(int16_t left, int16_t right, uint8_t color){
+	unsigned char plane, byte;
+
+	for(byte=0; byte < LINEBYTES; byte++){
+		int16_t const x = byte * 8;
+		uint8_t const street = low_bits(right - x) & ~low_bits(left - x);
+		uint8_t const border = ~street & low_bits(NUM_COLS - x);
+		for(plane=0; plane<NUMPLANE; plane++){
+			pixmap[plane][0][byte] = plane < color ? border : 0x00;
+		}
+	}
 }
 
 /**
  * Save the street state at the top line, so collision detection can
- * work in the last line (where the car is).
+ * work in the last line (where the car is). Instead of moving all lines,
+ * the head of the ring buffer moves up one entry, so the oldest entry (the
+ * last line) becomes the new top line.
  */
 void save_street(uint8_t middle, uint8_t width, uint8_t obstacle_pos){
-	uint8_t row;
-	for(row = NUM_ROWS-1; row > 0 ; row--){
-		borders[row][0] = borders[row-1][0];
-		borders[row][1] = borders[row-1][1];
-		borders[row][2] = borders[row-1][2];
-	}
-	borders[0][0] = middle;
-	borders[0][1] = width;
-	borders[0][2] = obstacle_pos;
+	street_head = street_head ? street_head - 1 : NUM_ROWS - 1;
+	borders[street_head][0] = middle;
+	borders[street_head][1] = width;
+	borders[street_head][2] = obstacle_pos;
 
 }
 
@@ -303,9 +349,11 @@ void blink(){
  * check if collision occours
  */
 uint8_t check_collision(uint8_t carpos){
-	uint8_t middle = borders[NUM_ROWS-1][0];
-	uint8_t width = borders[NUM_ROWS-1][1];
-	uint8_t obstacle_pos = borders[NUM_ROWS-1][2];
+	// the last line precedes the top line in the ring buffer
+	uint8_t const last = street_head ? street_head - 1 : NUM_ROWS - 1;
+	uint8_t middle = borders[last][0];
+	uint8_t width = borders[last][1];
+	uint8_t obstacle_pos = borders[last][2];
 
 	return ( carpos<middle-(width/2) || carpos >= middle+(width/2) || (obstacle_pos != 0 && carpos == obstacle_pos) );
 }
@@ -11,6 +11,7 @@
 void kart_game(void);
 
 void drive(void);
+void draw_street_line(int16_t left, int16_t right, uint8_t color);
 void save_street(uint8_t middle, uint8_t width, uint8_t obstacle_pos);
 uint8_t check_collision(uint8_t carpos);
 void blink();
@@ -13,11 +13,13 @@
 #include <assert.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "../../config.h"
 #include "../../compat/pgmspace.h"
 #include "../../pixel.h"
 #include "../../random/prng.h"
 #include "../../util.h"
+#include "../../frame_pacer.h"
 #include "../../joystick/joystick.h"
 #include "../../menu/menu.h"
 #include "../../scrolltext/scrolltext.h"
@@ -65,6 +67,24 @@ game_descriptor_t snake_game_descriptor __attribute__((section(".game_descriptor
 	#define SNAKE_ANIM_DELAY 100
 #endif
 
+#if !defined SNAKE_AUTOPILOT_BUDGET || defined DOXYGEN
+	/**
+	 * Maximum number of cells the autopilot examines per candidate move (it
+	 * examines up to three candidates per step).
+	 */
+	#define SNAKE_AUTOPILOT_BUDGET 96
+#endif
+
+// a search which runs out of budget has found more room than the snake needs
+#if SNAKE_AUTOPILOT_BUDGET <= USNAKE_MAX_LENGTH
+	#error SNAKE_AUTOPILOT_BUDGET has to exceed USNAKE_MAX_LENGTH
+#endif
+
+#if !defined SNAKE_ANIM_STEPS || defined DOXYGEN
+	/** Number of steps after which the demo ends. */
+	#define SNAKE_ANIM_STEPS 1200
+#endif
+
 #if !defined SNAKE_TERMINATION_DELAY || defined DOXYGEN
 	/** Delay (in ms) between every disappearing pixel of a dying snake. */
 	#define SNAKE_TERMINATION_DELAY 60
@@ -120,6 +140,50 @@ typedef struct snake_apples_s
 } snake_apples_t;
 
 
+/**
+ * Bit-packed occupancy grid of the playing field. A set bit marks a cell which
+ * is covered by either the border or the snake. Apples are not part of it.
+ */
+typedef uint8_t snake_grid_t[NUM_ROWS][(NUM_COLS + 7) / 8];
+
+
+/**
+ * Tells whether a cell of the playing field is occupied.
+ * @param grid The occupancy grid.
+ * @param px The cell in question.
+ * @return true if the cell is covered by the border or the snake.
+ */
+static bool snake_isOccupied(snake_grid_t grid,
+                             pixel const px)
+{
+	return grid[px.y][px.x / 8u] & (0x01u << (px.x % 8u));
+}
+
+
+/**
+ * Marks a cell of the playing field as occupied.
+ * @param grid The occupancy grid.
+ * @param px The cell in question.
+ */
+static void snake_occupy(snake_grid_t grid,
+                         pixel const px)
+{
+	grid[px.y][px.x / 8u] |= (0x01u << (px.x % 8u));
+}
+
+
+/**
+ * Marks a cell of the playing field as free.
+ * @param grid The occupancy grid.
+ * @param px The cell in question.
+ */
+static void snake_vacate(snake_grid_t grid,
+                         pixel const px)
+{
+	grid[px.y][px.x / 8u] &= ~(0x01u << (px.x % 8u));
+}
+
+
 /**
  * This function returns the next position which is calculated from a given
  * (current) position and a direction.
@@ -163,6 +227,57 @@ static void snake_drawBorder(void)
 #endif
 }
 
+/**
+ * Initializes the occupancy grid with the surrounding border.
+ * @param grid The occupancy grid to be initialized.
+ */
+static void snake_initGrid(snake_grid_t grid)
+{
+	memset(grid, 0, sizeof(snake_grid_t));
+	for (uint8_t x = NUM_COLS; x--;)
+	{
+		snake_occupy(grid, (pixel){x, 0});
+		snake_occupy(grid, (pixel){x, NUM_ROWS - 1});
+	}
+	for (uint8_t y = NUM_ROWS; y--;)
+	{
+		snake_occupy(grid, (pixel){0, y});
+		snake_occupy(grid, (pixel){NUM_COLS - 1, y});
+	}
+}
+
+
+/**
+ * Tells whether an apple is lying at a given position.
+ * @param pApples The set of apples which are lying on the playing field.
+ * @param px The position to be tested.
+ * @return true if there is an apple at the given position.
+ */
+static bool snake_isApple(snake_apples_t const *pApples,
+                          pixel const px)
+{
+	for (uint8_t i = pApples->nAppleCount; i--;)
+	{
+		if ((px.x == pApples->aApples[i].x) && (px.y == pApples->aApples[i].y))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Returns the number of segments of the snake.
+ * @param pprotSnake The snake in question.
+ * @return The length of the snake.
+ */
+static uint8_t snake_length(snake_protagonist_t const *pprotSnake)
+{
+	return (pprotSnake->nHeadIndex + USNAKE_MAX_LENGTH -
+			pprotSnake->nTailIndex) % USNAKE_MAX_LENGTH + 1u;
+}
+
 #ifdef GAME_SNAKE
 /**
  * This function translates hardware port information into joystick directions.
@@ -268,82 +383,166 @@ static void snake_userControl(snake_protagonist_t *pprotSnake,
 
 #ifdef ANIMATION_SNAKE
 /**
- * This function approximates the next direction which may lead to an apple
- * (with a particular probability).
- * @param pprotSnake A pointer to the hungry protagonist.
- * @param pApples A pointer to a bunch of apples.
+ * Result of a search of the autopilot.
  */
-static void snake_autoRoute(snake_protagonist_t *pprotSnake,
-                            snake_apples_t *pApples)
+typedef struct snake_search_s
 {
-	pixel pxHead = pprotSnake->aSegments[pprotSnake->nHeadIndex];
-	if (random8() < 80)
+	uint16_t nArea;      /**< Number of reachable cells (up to the budget). */
+	uint16_t nAppleDist; /**< Steps to the nearest apple (UINT16_MAX if none). */
+	bool bTailReachable; /**< The snake is able to follow its own tail. */
+} snake_search_t;
+
+
+/**
+ * Breadth-first search from a given cell over all free cells of the playing
+ * field. It determines the distance to the nearest apple, the size of the
+ * reachable area and whether the tail of the snake is within reach. No more
+ * than SNAKE_AUTOPILOT_BUDGET cells are examined.
+ * @param grid The occupancy grid (the start cell has to be marked already).
+ * @param pApples The apples which are lying on the playing field.
+ * @param pxStart The cell where the search begins.
+ * @param pxTail The (occupied) tail of the snake.
+ * @param pResult Receives the results of the search.
+ */
+static void snake_search(snake_grid_t grid,
+                         snake_apples_t const *pApples,
+                         pixel const pxStart,
+                         pixel const pxTail,
+                         snake_search_t *pResult)
+{
+	// occupied cells count as already visited
+	snake_grid_t visited;
+	memcpy(visited, grid, sizeof(visited));
+
+	pixel aQueue[SNAKE_AUTOPILOT_BUDGET];
+	uint16_t nFront = 0, nBack = 0, nLevelEnd = 1, nDist = 0;
+	aQueue[nBack++] = pxStart;
+
+	pResult->nAppleDist = UINT16_MAX;
+	pResult->bTailReachable = false;
+
+	while (nFront < nBack)
 	{
-		uint8_t nNextApple = 0;
-		if (pApples->nAppleCount)
+		// all cells of the current distance have been examined
+		if (nFront == nLevelEnd)
 		{
-			uint8_t nMinDist = UINT8_MAX;
-			for (uint8_t i = 0; i < pApples->nAppleCount; ++i)
-			{
-				uint8_t nDistX;
-				if (pxHead.x > pApples->aApples[i].x)
-				{
-					nDistX = pxHead.x - pApples->aApples[i].x;
-				}
-				else
-				{
-					nDistX = pApples->aApples[i].x - pxHead.x;
-				}
-
-				uint8_t nDistY;
-				if (pxHead.y > pApples->aApples[i].y)
-				{
-					nDistY = pxHead.y - pApples->aApples[i].y;
-				}
-				else
-				{
-					nDistY = pApples->aApples[i].y - pxHead.y;
-				}
-
-				if ((nDistX + nDistY) < nMinDist)
-				{
-					nMinDist = nDistX + nDistY;
-					nNextApple = i;
-				}
-			}
-			if (pprotSnake->dir ^ 0x01) // vertical direction?
+			++nDist;
+			nLevelEnd = nBack;
+		}
+
+		pixel const px = aQueue[nFront++];
+		if ((pResult->nAppleDist == UINT16_MAX) && snake_isApple(pApples, px))
+		{
+			pResult->nAppleDist = nDist;
+		}
+
+		for (uint8_t dir = 0; dir < 4; ++dir)
+		{
+			pixel const pxNext = snake_nextDirection(px, dir);
+			if ((pxNext.x == pxTail.x) && (pxNext.y == pxTail.y))
 			{
-				pprotSnake->dir = pApples->aApples[nNextApple].x > pxHead.x ?
-						SNAKE_DIR_LEFT : SNAKE_DIR_RIGHT;
+				pResult->bTailReachable = true;
 			}
-			else
+			else if (!snake_isOccupied(visited, pxNext) &&
+					(nBack < SNAKE_AUTOPILOT_BUDGET))
 			{
-				pprotSnake->dir = pApples->aApples[nNextApple].y > pxHead.y ?
-						SNAKE_DIR_DOWN : SNAKE_DIR_UP;
+				snake_occupy(visited, pxNext);
+				aQueue[nBack++] = pxNext;
 			}
 		}
 	}
+	pResult->nArea = nBack;
+}
+
+
+/**
+ * Chooses the next direction of the snake. Every possible move gets simulated
+ * on the occupancy grid and rated by a search from the new head position. A
+ * move is considered safe if the snake is still able to follow its own tail
+ * afterwards or if the search runs out of budget (the snake is shorter than
+ * the area it has found then). Safe moves towards the nearest apple are
+ * preferred, otherwise the move with the largest free area wins.
+ * @param pprotSnake A pointer to the hungry protagonist.
+ * @param pApples A pointer to a bunch of apples.
+ * @param grid The occupancy grid of the playing field.
+ */
+static void snake_autoRoute(snake_protagonist_t *pprotSnake,
+                            snake_apples_t *pApples,
+                            snake_grid_t grid)
+{
+	pixel const pxHead = pprotSnake->aSegments[pprotSnake->nHeadIndex];
+	pixel const pxTail = pprotSnake->aSegments[pprotSnake->nTailIndex];
+	pixel const pxNewTail = pprotSnake->aSegments[
+			(pprotSnake->nTailIndex + 1u) % USNAKE_MAX_LENGTH];
+
+	snake_dir_t dirBest = pprotSnake->dir;
+	bool bBestSafe = false;
+	snake_search_t best = {0, UINT16_MAX, false};
 
 	for (uint8_t i = 0; i < 4; ++i)
 	{
-		pixel pxTest = snake_nextDirection(pxHead, pprotSnake->dir);
-		if (get_pixel(pxTest))
+		// begin with the current direction so that it wins on a tie
+		snake_dir_t const dir = (pprotSnake->dir + i) % 4u;
+		pixel const pxNext = snake_nextDirection(pxHead, dir);
+
+		// simulate the move (the tail only stays if the snake grows)
+		bool const bGrow = snake_isApple(pApples, pxNext) &&
+				(snake_length(pprotSnake) < USNAKE_MAX_LENGTH);
+		if (!bGrow)
 		{
-			for (uint8_t j = 0; j < pApples->nAppleCount; ++j)
-			{
-				if ((pxTest.x == pApples->aApples[j].x) &&
-						(pxTest.y == pApples->aApples[j].y))
-				{
-					return;
-				}
-			}
-			pprotSnake->dir = (pprotSnake->dir + 1u) % 4u;
+			snake_vacate(grid, pxTail);
+		}
+
+		snake_search_t result;
+		bool const bFree = !snake_isOccupied(grid, pxNext);
+		if (bFree)
+		{
+			snake_occupy(grid, pxNext);
+			snake_search(grid, pApples, pxNext, bGrow ? pxTail : pxNewTail,
+					&result);
+			snake_vacate(grid, pxNext);
+		}
+
+		if (!bGrow)
+		{
+			snake_occupy(grid, pxTail);
+		}
+		if (!bFree)
+		{
+			continue;
+		}
+
+		bool const bSafe = result.bTailReachable ||
+				(result.nArea == SNAKE_AUTOPILOT_BUDGET);
+		bool bBetter;
+		if (best.nArea == 0)
+		{
+			bBetter = true;
+		}
+		else if (bSafe != bBestSafe)
+		{
+			bBetter = bSafe;
+		}
+		else if (bSafe)
+		{
+			bBetter = (result.nAppleDist < best.nAppleDist) ||
+					((result.nAppleDist == best.nAppleDist) &&
+					(result.nArea > best.nArea));
 		}
 		else
 		{
-			break;
+			bBetter = result.nArea > best.nArea;
+		}
+
+		if (bBetter)
+		{
+			best = result;
+			bBestSafe = bSafe;
+			dirBest = dir;
 		}
 	}
+
+	pprotSnake->dir = dirBest;
 }
 #endif
 
@@ -401,14 +600,17 @@ static bool snake_checkForApple(snake_apples_t *pApples, pixel pxHead)
 /**
  * Creates some new apples from time to time.
  * @param pApples Pointer to a set of apples.
+ * @param grid The occupancy grid of the playing field.
  */
-static void snake_spawnApples(snake_apples_t *pApples)
+static void snake_spawnApples(snake_apples_t *pApples,
+                              snake_grid_t grid)
 {
 	if ((pApples->nAppleCount < SNAKE_MAX_APPLES) && (random8() < 10))
 	{
 		pixel pxApple = (pixel){(random8() % (NUM_COLS-2)) + 1,
 								   (random8() % (NUM_ROWS - 2)) + 1};
-		if (!get_pixel(pxApple))
+		if (!snake_isOccupied(grid, pxApple) &&
+				!snake_isApple(pApples, pxApple))
 		{
 			pApples->aApples[pApples->nAppleCount++] = pxApple;
 		}
@@ -429,18 +631,36 @@ void snake_engine(uint8_t bDemoMode)
 	snake_apples_t apples;
 	snake_initApples(&apples);
 	snake_dir_t dirLast = SNAKE_DIR_NONE;
+	snake_grid_t grid;
+	snake_initGrid(grid);
+	snake_occupy(grid, protSnake.aSegments[protSnake.nTailIndex]);
+	snake_occupy(grid, protSnake.aSegments[protSnake.nHeadIndex]);
+#ifdef ANIMATION_SNAKE
+	uint16_t nSteps = SNAKE_ANIM_STEPS;
+#endif
 
 	// init screen
 	clear_screen(0);
 	snake_drawBorder();
 
+	// the time needed for a step gets deducted from the round delay
+	frame_pacer_t pacer;
+#if defined ANIMATION_SNAKE && defined GAME_SNAKE
+	frame_pacer_init(&pacer,
+			bDemoMode ? SNAKE_ANIM_DELAY : SNAKE_GAME_DELAY / 2);
+#elif defined ANIMATION_SNAKE
+	frame_pacer_init(&pacer, SNAKE_ANIM_DELAY);
+#else
+	frame_pacer_init(&pacer, SNAKE_GAME_DELAY / 2);
+#endif
+
 	for (uint8_t nTick = 0; true; nTick ^= SNAKE_COLOR_APPLE)
 	{
 		// determine new direction
 #if defined ANIMATION_SNAKE && defined GAME_SNAKE
 		if (bDemoMode)
 		{
-			snake_autoRoute(&protSnake, &apples);
+			snake_autoRoute(&protSnake, &apples, grid);
 		}
 		else
 		{
@@ -448,7 +668,7 @@ void snake_engine(uint8_t bDemoMode)
 		}
 		if (bDemoMode || nTick) {
 #elif defined ANIMATION_SNAKE
-		snake_autoRoute(&protSnake, &apples);
+		snake_autoRoute(&protSnake, &apples, grid);
 		{
 #else
 		snake_userControl(&protSnake, &dirLast);
@@ -457,34 +677,49 @@ void snake_engine(uint8_t bDemoMode)
 			// release joystick lock
 			protSnake.bJoystickLocked = false;
 
-			// actually move head
-			pixel pxOldHead = protSnake.aSegments[protSnake.nHeadIndex];
-			protSnake.nHeadIndex = (protSnake.nHeadIndex + 1u) % USNAKE_MAX_LENGTH;
-			protSnake.aSegments[protSnake.nHeadIndex] =
-					snake_nextDirection(pxOldHead, protSnake.dir);
+#ifdef ANIMATION_SNAKE
+			// the demo ends after a while, even if the snake is still alive
+			if (bDemoMode && (--nSteps == 0))
+			{
+				snake_eliminateProtagonist(&protSnake);
+				return;
+			}
+#endif
+
+			pixel const pxNewHead = snake_nextDirection(
+					protSnake.aSegments[protSnake.nHeadIndex], protSnake.dir);
 
 			// look if we have found an apple
-			if (!snake_checkForApple(&apples,
-					protSnake.aSegments[protSnake.nHeadIndex]))
+			bool const bAte = snake_checkForApple(&apples, pxNewHead);
+
+			// remove last segment (the snake grows as long as there is room)
+			if (!bAte || (snake_length(&protSnake) == USNAKE_MAX_LENGTH))
 			{
-				// quit game if we hit something which is not an apple
-				if (get_pixel(protSnake.aSegments[protSnake.nHeadIndex]))
-				{
-					snake_eliminateProtagonist(&protSnake);
-					return;
-				}
-
-				// remove last segment
-				clearpixel(protSnake.aSegments[protSnake.nTailIndex])
+				pixel const pxTail = protSnake.aSegments[protSnake.nTailIndex];
+				clearpixel(pxTail);
+				snake_vacate(grid, pxTail);
 				protSnake.nTailIndex =
 						(protSnake.nTailIndex + 1u) % USNAKE_MAX_LENGTH;
+			}
 
-				// new apples
-				snake_spawnApples(&apples);
+			// quit game if we hit something which is not an apple
+			if (snake_isOccupied(grid, pxNewHead))
+			{
+				snake_eliminateProtagonist(&protSnake);
+				return;
+			}
+
+			// actually move head
+			protSnake.nHeadIndex = (protSnake.nHeadIndex + 1u) % USNAKE_MAX_LENGTH;
+			protSnake.aSegments[protSnake.nHeadIndex] = pxNewHead;
+			snake_occupy(grid, pxNewHead);
+			setpixel(pxNewHead, SNAKE_COLOR_PROTAGONIST);
+
+			// new apples
+			if (!bAte)
+			{
+				snake_spawnApples(&apples, grid);
 			}
-			// draw new head
-			setpixel(protSnake.aSegments[protSnake.nHeadIndex],
-					SNAKE_COLOR_PROTAGONIST);
 		}
 
 		// draw apples
@@ -494,20 +729,7 @@ void snake_engine(uint8_t bDemoMode)
 			setpixel(apples.aApples[i], nTick);
 		}
 
-#if defined ANIMATION_SNAKE && defined GAME_SNAKE
-		if (bDemoMode)
-		{
-			wait(SNAKE_ANIM_DELAY);
-		}
-		else
-		{
-			wait(SNAKE_GAME_DELAY / 2);
-		}
-#elif defined ANIMATION_SNAKE
-		wait(SNAKE_ANIM_DELAY);
-#else
-		wait(SNAKE_GAME_DELAY / 2);
-#endif
+		next_frame(&pacer);
 	}
 }
 
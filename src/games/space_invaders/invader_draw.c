@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <string.h>
 #include "invaders2.h"
 
 /*--------------------double buffered graphics-------------------*/
@@ -11,29 +12,57 @@ static void setOffScreenPixel(offScreen_t offScreen, unsigned char x,
 	assert(y < NUM_ROWS);
 	assert(color <= NUMPLANE);
 
-	offScreen[color][y][x / 8u] |= shl_table[x % 8u];
+	/* overlapping objects: the brightest one wins (planes are just ORed) */
+	unsigned char const mask = 1u << (x % 8u);
+	unsigned char plane;
+	for (plane = 0; plane < color; ++plane)
+	{
+		offScreen[plane][y][x / 8u] |= mask;
+	}
 }
 
-static void flushOffScreenBuffer(offScreen_t offScreen)
+/* ORs the bits of a bitboard row into an off-screen line at column x */
+static void orOffScreenRow(unsigned char *line, invaderRow_t bits,
+		signed char x)
 {
-	assert(offScreen != 0);
+	if (x < 0)
+	{
+		if (x <= -(signed char)(sizeof(bits) * 8))
+		{
+			return;
+		}
+		bits >>= -x;
+		x = 0;
+	}
+	if (x >= NUM_COLS)
+	{
+		return;
+	}
 
-	/* off-screen blitting borrowed from fixed point math patterns animation,
-	   see fpmath_patterns.c (fixDrawPattern(...) for details */
-	unsigned char *pPixmap =
-			(&pixmap[NUMPLANE - 1][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-	unsigned char *pOffScreenDistHigh =
-			(&offScreen[NUMPLANE][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-	unsigned char *pOffScreenDistLow =
-			(&offScreen[NUMPLANE - 1][NUM_ROWS - 1][LINEBYTES - 1]) + 1;
-	while (pPixmap != &pixmap[0][0][0]) // stop at the beginning
+	/* clip at the right border */
+	uint32_t wide = bits;
+	if ((NUM_COLS - x) < 32)
+	{
+		wide &= (1ul << (NUM_COLS - x)) - 1u;
+	}
+
+	unsigned char i;
+	wide <<= x % 8u;
+	for (i = x / 8u; wide && (i < LINEBYTES); ++i)
 	{
-		*(--pPixmap) = *(--pOffScreenDistHigh);
-		*(--pOffScreenDistLow) |= *pOffScreenDistHigh;
-		*pOffScreenDistHigh = 0;
+		line[i] |= (unsigned char)wide;
+		wide >>= 8;
 	}
 }
 
+static void flushOffScreenBuffer(offScreen_t offScreen)
+{
+	assert(offScreen != 0);
+
+	memcpy(pixmap, offScreen, sizeof(offScreen_t));
+	memset(offScreen, 0, sizeof(offScreen_t));
+}
+
 /*----------------------getter/setter----------------------------*/
 
 unsigned char getInvaderPixel(Invaders * iv, unsigned char x, unsigned char y)
@@ -41,36 +70,70 @@ unsigned char getInvaderPixel(Invaders * iv, unsigned char x, unsigned char y)
 	if (((x - iv->pos.x) < MAX_INVADER_WIDTH) && ((x - iv->pos.x) >= 0) &&
 			((y - iv->pos.y) < MAX_INVADER_HEIGHT) && ((y - iv->pos.y) >= 0))
 	{
-		return iv->map[x - iv->pos.x][y - iv->pos.y];
+		unsigned char const col = x - iv->pos.x;
+		unsigned char const row = y - iv->pos.y;
+		return ((iv->lives[0][row] >> col) & 0x01) |
+				(((iv->lives[1][row] >> col) & 0x01) << 1);
 	}
 	return 0;
 }
 
-void setInvaderPixel(Invaders * iv, unsigned char x, unsigned char y,
+void setInvaderCell(Invaders * iv, unsigned char col, unsigned char row,
 		unsigned char val)
 {
-	if (((x - iv->pos.x) < MAX_INVADER_WIDTH) && ((x - iv->pos.x) >= 0) &&
-			((y - iv->pos.y) < MAX_INVADER_HEIGHT) && ((y - iv->pos.y) >= 0))
+	assert(col < MAX_INVADER_WIDTH);
+	assert(row < MAX_INVADER_HEIGHT);
+	assert(val <= 3);
+
+	invaderRow_t const mask = (invaderRow_t)1u << col;
+	iv->lives[0][row] = (iv->lives[0][row] & ~mask) | ((val & 0x01) ? mask : 0);
+	iv->lives[1][row] = (iv->lives[1][row] & ~mask) | ((val & 0x02) ? mask : 0);
+}
+
+unsigned char hitInvader(Invaders * iv, unsigned char x, unsigned char y)
+{
+	unsigned char const val = getInvaderPixel(iv, x, y);
+	if (val)
 	{
-		iv->map[x - iv->pos.x][y - iv->pos.y] = val;
+		setInvaderCell(iv, x - iv->pos.x, y - iv->pos.y, val - 1);
 	}
+	return val;
 }
 
-void setGuardPixel(unsigned char *guards, unsigned char x, unsigned char y,
-		unsigned char val)
+void setGuardPixel(Guards * guards, unsigned char x, unsigned char val)
 {
-	assert(val <= NUMPLANE);
+	assert(val <= 3);
 
+	if (x < NUM_COLS)
+	{
+		unsigned char const mask = 1u << (x % 8u);
+		unsigned char *lo = &guards->lives[0][x / 8u];
+		unsigned char *hi = &guards->lives[1][x / 8u];
+		*lo = (*lo & ~mask) | ((val & 0x01) ? mask : 0);
+		*hi = (*hi & ~mask) | ((val & 0x02) ? mask : 0);
+	}
+}
+
+unsigned char hitGuard(Guards * guards, unsigned char x, unsigned char y)
+{
 	if (x < NUM_COLS && y == GUARD_LINE)
 	{
-		guards[x] = val;
+		unsigned char const lo = guards->lives[0][x / 8u] >> (x % 8u);
+		unsigned char const hi = guards->lives[1][x / 8u] >> (x % 8u);
+		unsigned char const val = (lo & 0x01) | ((hi & 0x01) << 1);
+		if (val)
+		{
+			setGuardPixel(guards, x, val - 1);
+		}
+		return val;
 	}
+	return 0;
 }
 
 /*----------------------drawing Method---------------------------*/
 
 void draw(offScreen_t offScreen, Invaders * iv, Spaceship * sc, Player * pl,
-		Cannon * cn, unsigned char *guards, pixel *st, pixel * shot)
+		Cannon * cn, Guards * guards, pixel *st, pixel * shot)
 {
 	unsigned char x, y;
 
@@ -85,23 +148,36 @@ void draw(offScreen_t offScreen, Invaders * iv, Spaceship * sc, Player * pl,
 	}
 
 	/*---INVADERS--*/
+	/* plane p shows all cells with more than p lives */
 	for (y = MAX_INVADER_HEIGHT; y--;)
 	{
-		for (x = MAX_INVADER_WIDTH; x--;)
+		if ((y + iv->pos.y >= 0) && (y + iv->pos.y < NUM_ROWS))
 		{
-			if ((x + iv->pos.x >= 0) && (x + iv->pos.x < NUM_COLS) &&
-					(y + iv->pos.y < NUM_ROWS))
-			{
-				setOffScreenPixel(offScreen, x + iv->pos.x, y + iv->pos.y,
-						iv->map[x][y]);
-			}
+			invaderRow_t const lo = iv->lives[0][y];
+			invaderRow_t const hi = iv->lives[1][y];
+			unsigned char const row = y + iv->pos.y;
+			orOffScreenRow(offScreen[0][row], lo | hi, iv->pos.x);
+#if NUMPLANE > 1
+			orOffScreenRow(offScreen[1][row], hi, iv->pos.x);
+#endif
+#if NUMPLANE > 2
+			orOffScreenRow(offScreen[2][row], lo & hi, iv->pos.x);
+#endif
 		}
 	}
 
 	/*---GUARDS---*/
-	for (x = NUM_COLS; x--;)
+	for (x = LINEBYTES; x--;)
 	{
-		setOffScreenPixel(offScreen, x, GUARD_LINE, guards[x]);
+		unsigned char const lo = guards->lives[0][x];
+		unsigned char const hi = guards->lives[1][x];
+		offScreen[0][GUARD_LINE][x] |= lo | hi;
+#if NUMPLANE > 1
+		offScreen[1][GUARD_LINE][x] |= hi;
+#endif
+#if NUMPLANE > 2
+		offScreen[2][GUARD_LINE][x] |= lo & hi;
+#endif
 	}
 
 	/*---SHOTS--*/
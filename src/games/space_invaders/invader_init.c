@@ -9,15 +9,15 @@ uint16_t const peter[8] PROGMEM =
 uint16_t const hans[7] PROGMEM =
 		{0x0000, 0x0372, 0x0552, 0x0372, 0x0552, 0x0356, 0x0000};
 
-void initGuards(unsigned char *guards)
+void initGuards(Guards * guards)
 {
-	memset(guards, 0, NUM_COLS);
+	memset(guards, 0, sizeof(Guards));
 
 #if NUM_COLS == 16
-	guards[2] = 3;
-	guards[5] = 3;
-	guards[10] = 3;
-	guards[13] = 3;
+	setGuardPixel(guards, 2, 3);
+	setGuardPixel(guards, 5, 3);
+	setGuardPixel(guards, 10, 3);
+	setGuardPixel(guards, 13, 3);
 #else
 	unsigned const guard_min_distance = 3;
 	unsigned char pos;
@@ -25,8 +25,8 @@ void initGuards(unsigned char *guards)
 	{
 		if (((pos % guard_min_distance) == 0) && (pos != 0))
 		{
-			guards[pos - 1] = 3;
-			guards[NUM_COLS - pos] = 3;
+			setGuardPixel(guards, pos - 1, 3);
+			setGuardPixel(guards, NUM_COLS - pos, 3);
 		}
 	}
 #endif
@@ -37,7 +37,7 @@ void initInvaders(Invaders * iv, unsigned char lv)
 	unsigned char x, y;
 
 	// first zero out map!
-	memset(iv->map, 0, sizeof(iv->map));
+	memset(iv->lives, 0, sizeof(iv->lives));
 
 	iv->speedinc = 0;
 	iv->isEdged = 0;
@@ -48,10 +48,10 @@ void initInvaders(Invaders * iv, unsigned char lv)
 	default:
 		for (x = 0; x < 8; ++x)
 		{
-			iv->map[x][0] = 2;
-			iv->map[x][1] = 2;
-			iv->map[x][2] = 2;
-			iv->map[x][3] = 1;
+			setInvaderCell(iv, x, 0, 2);
+			setInvaderCell(iv, x, 1, 2);
+			setInvaderCell(iv, x, 2, 2);
+			setInvaderCell(iv, x, 3, 1);
 		}
 
 		iv->pos.x = (NUM_COLS - 8) / 2;
@@ -63,10 +63,10 @@ void initInvaders(Invaders * iv, unsigned char lv)
 	case 1:
 		for (x = 0; x < 8; ++x)
 		{
-			iv->map[x][0] = 3;
-			iv->map[x][1] = 3;
-			iv->map[x][2] = 2;
-			iv->map[x][3] = 2;
+			setInvaderCell(iv, x, 0, 3);
+			setInvaderCell(iv, x, 1, 3);
+			setInvaderCell(iv, x, 2, 2);
+			setInvaderCell(iv, x, 3, 2);
 		}
 
 		iv->pos.x = (NUM_COLS - 8) / 2;
@@ -79,11 +79,11 @@ void initInvaders(Invaders * iv, unsigned char lv)
 	case 2:
 		for (x = 0; x < 8; ++x)
 		{
-			iv->map[x][0] = 3;
-			iv->map[x][1] = 3;
-			iv->map[x][2] = 2;
-			iv->map[x][3] = 2;
-			iv->map[x][4] = 1;
+			setInvaderCell(iv, x, 0, 3);
+			setInvaderCell(iv, x, 1, 3);
+			setInvaderCell(iv, x, 2, 2);
+			setInvaderCell(iv, x, 3, 2);
+			setInvaderCell(iv, x, 4, 1);
 		}
 
 		iv->pos.x = (NUM_COLS - 8) / 2;
@@ -100,7 +100,7 @@ void initInvaders(Invaders * iv, unsigned char lv)
 			uint16_t mask = 0x0001;
 			for (x = 11; x--;)
 			{
-				iv->map[x][y] = (hansrow & mask) ? 2 : 1;
+				setInvaderCell(iv, x, y, (hansrow & mask) ? 2 : 1);
 				mask <<= 1;
 			}
 		}
@@ -121,7 +121,7 @@ void initInvaders(Invaders * iv, unsigned char lv)
 			{
 				if (peterrow & mask)
 				{
-					iv->map[x][y] = 2;
+					setInvaderCell(iv, x, y, 2);
 				}
 				mask <<= 1;
 			}
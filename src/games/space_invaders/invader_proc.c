@@ -38,15 +38,23 @@ void procCannon(Cannon * cn, pixel * shot)
 
 static unsigned char areAtBorder(Invaders * iv)
 {
-	unsigned char y;
-	for (y = SPACESHIP_LINE + 1; y <= GUARD_LINE; ++y)
+	/* collect the occupied columns of all rows between spaceship and guards */
+	invaderRow_t cols = 0;
+	unsigned char row;
+	for (row = 0; row < MAX_INVADER_HEIGHT; ++row)
 	{
-		if (getInvaderPixel(iv, NUM_COLS - 1, y) || getInvaderPixel(iv, 0, y))
+		signed char const y = iv->pos.y + row;
+		if ((y > SPACESHIP_LINE) && (y <= GUARD_LINE))
 		{
-			return 1;
+			cols |= getInvaderRow(iv, row);
 		}
 	}
-	return 0;
+
+	/* formation columns which lie on the left and right border */
+	signed char const left = -iv->pos.x;
+	signed char const right = NUM_COLS - 1 - iv->pos.x;
+	return ((left >= 0) && (left < MAX_INVADER_WIDTH) && ((cols >> left) & 1))
+		|| ((right >= 0) && (right < MAX_INVADER_WIDTH) && ((cols >> right) & 1));
 }
 
 void procInvaders(Invaders * iv, pixel *st)
@@ -69,31 +77,43 @@ void procInvaders(Invaders * iv, pixel *st)
 		}
 	}
 
-	unsigned char i, y;
+	unsigned char i;
 	unsigned char spos = random8() % UNUM_COLS;
 
 	if (random8() < SHOOTING_RATE)
 	{
+		signed char const col = spos - iv->pos.x;
+		if ((col < 0) || (col >= MAX_INVADER_WIDTH))
+		{
+			return;
+		}
+		invaderRow_t const mask = (invaderRow_t)1u << col;
+
 		for (i = 0; i < MAX_SHOTS; ++i)
 		{
 			if (st[i].y >= NUM_ROWS)
 			{
-				for (y = GUARD_LINE; y > SPACESHIP_LINE; --y)
+				/* lowest invader of that column shoots */
+				signed char row;
+				for (row = MAX_INVADER_HEIGHT; row--;)
 				{
-					if (getInvaderPixel(iv, spos, y) != 0)
+					signed char const y = iv->pos.y + row;
+					if ((y <= GUARD_LINE) && (y > SPACESHIP_LINE) &&
+							(getInvaderRow(iv, row) & mask))
 					{
 						st[i].x = spos;
 						st[i].y = y + 1;
 						return;
 					}
 				}
+				return;
 			}
 		} //for SHOTS
 	}
 }
 
 void procShots(Invaders * iv, Player * pl, Cannon * cn, Spaceship * sc,
-		unsigned char *guards, pixel *st, pixel * shot)
+		Guards * guards, pixel *st, pixel * shot)
 {
 	unsigned char i;
 	static unsigned char cmv = 0, imv = 0;
@@ -150,21 +170,16 @@ void procShots(Invaders * iv, Player * pl, Cannon * cn, Spaceship * sc,
 		}
 
 		//GUARDS
-		if ((tmp = getGuardPixel(guards, shot->x, shot->y)))
+		if (hitGuard(guards, shot->x, shot->y))
 		{
-			--tmp;
-			setGuardPixel(guards, shot->x, shot->y, tmp);
 			cn->ready = 1;
 			goto invader_shots;
 		}
 
 		//INVADER
-		if ((tmp = getInvaderPixel(iv, shot->x, shot->y)))
+		if ((tmp = hitInvader(iv, shot->x, shot->y)))
 		{
-			--tmp;
-			setInvaderPixel(iv, shot->x, shot->y, tmp);
-
-			if (tmp == 0)
+			if (tmp == 1)
 			{
 				iv->speedinc++;
 				if (iv->speedinc == SPEED_INC_RATE)
@@ -198,10 +213,8 @@ void procShots(Invaders * iv, Player * pl, Cannon * cn, Spaceship * sc,
 invader_shots:
 	for (i = 0; i < MAX_SHOTS; ++i)
 	{
-		if ((tmp = getGuardPixel(guards, st[i].x, st[i].y)))
+		if (hitGuard(guards, st[i].x, st[i].y))
 		{
-			--tmp;
-			setGuardPixel(guards, st[i].x, st[i].y, tmp);
 			st[i].x = 255;
 			st[i].y = 255;
 		}
@@ -252,29 +265,48 @@ void procSpaceship(Spaceship * sc)
 	}
 }
 
+/* clears the cells of a formation row which lie beyond the screen borders */
+static invaderRow_t getVisibleCells(Invaders * iv, invaderRow_t cells)
+{
+	signed char const left = -iv->pos.x;
+	signed char const right = NUM_COLS - iv->pos.x;
+
+	if ((left >= MAX_INVADER_WIDTH) || (right <= 0))
+	{
+		return 0;
+	}
+	if (left > 0)
+	{
+		cells &= ~(((invaderRow_t)1u << left) - 1u);
+	}
+	if (right < MAX_INVADER_WIDTH)
+	{
+		cells &= ((invaderRow_t)1u << right) - 1u;
+	}
+	return cells;
+}
+
 unsigned char getStatus(Invaders * iv)
 {
-	unsigned char x, y;
+	unsigned char row;
+	invaderRow_t any = 0;
 
-	// did invaders reached earth?
-	for (x = NUM_COLS; x--;)
+	for (row = MAX_INVADER_HEIGHT; row--;)
 	{
-		if (getInvaderPixel(iv, x, GUARD_LINE + 1))
+		invaderRow_t const cells = getInvaderRow(iv, row);
+
+		// did invaders reached earth?
+		if ((iv->pos.y + row == GUARD_LINE + 1) && getVisibleCells(iv, cells))
 		{
 			return 2;
 		}
+		any |= cells;
 	}
 
 	// any invaders left?
-	for (x = MAX_INVADER_WIDTH; x--;)
+	if (any)
 	{
-		for (y = MAX_INVADER_HEIGHT; y--;)
-		{
-			if (iv->map[x][y])
-			{
-				return 0; // yes
-			}
-		}
+		return 0; // yes
 	}
 
 	// if we reach here, level was cleared \o/
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include "../../util.h"
+#include "../../frame_pacer.h"
 #include "../../compat/eeprom.h"
 #include "../../compat/pgmspace.h"
 #include "../../menu/menu.h"
@@ -31,26 +32,25 @@ void borg_invaders()
 	Player pl;
 	Spaceship sc;
 
-	unsigned char guards[NUM_COLS];
+	Guards guards;
 	unsigned char level = 0;
 	unsigned char ivStatus = 0;
 
-	pixel st[MAX_SHOTS] =
+	pixel st[MAX_SHOTS];
+	unsigned char i;
+	for (i = MAX_SHOTS; i--;)
 	{
-		{255, 255},
-		{255, 255},
-		{255, 255},
-		{255, 255},
-		{255, 255},
-		{255, 255},
-		{255, 255}
-	};
+		st[i] = (pixel){255, 255};
+	}
 
 	pixel shot;
 
 	pl.points = 0;
 	pl.lives = 3;
 
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, WAIT_MS);
+
 
 	/****************************************************************/
 	/*                          GAME LOOP                           */
@@ -58,7 +58,7 @@ void borg_invaders()
 	do
 	{
 		//----- INITIALIZE LEVEL-----//
-		initGuards(guards);
+		initGuards(&guards);
 		initInvaders(&iv, level);
 
 		//Spaceship 
@@ -73,10 +73,10 @@ void borg_invaders()
 		{
 			procInvaders(&iv, st);
 			procSpaceship(&sc);
-			procShots(&iv, &pl, &cn, &sc, guards, st, &shot);
+			procShots(&iv, &pl, &cn, &sc, &guards, st, &shot);
 			procCannon(&cn, &shot);
 
-			draw(offScreen, &iv, &sc, &pl, &cn, guards, st, &shot);
+			draw(offScreen, &iv, &sc, &pl, &cn, &guards, st, &shot);
 
 			ivStatus = getStatus(&iv);
 
@@ -95,7 +95,7 @@ void borg_invaders()
 				break;
 			}
 
-			wait (WAIT_MS);
+			next_frame(&pacer);
 		} //IN LEVEL LOOP
 
 	} while (pl.lives != 0); //GAME LOOP
@@ -32,6 +32,10 @@ extern uint16_t const hans[7];
 
 #define MAX_INVADER_HEIGHT  8
 #define MAX_INVADER_WIDTH  12
+
+#if MAX_INVADER_WIDTH > 16
+#	error MAX_INVADER_WIDTH must not exceed the width of invaderRow_t
+#endif
 #define MAX_INVADER_LIVES   3
 
 #define POINTS_FOR_HIT         5
@@ -61,9 +65,16 @@ typedef struct
 	signed char y;
 } spixel;
 
+/* one row of a bitboard, bit x belongs to column x of the formation */
+typedef uint16_t invaderRow_t;
+
+/*
+ * The lives (0..3) of the invaders are kept bit-sliced: lives[0] holds the
+ * low bits and lives[1] the high bits of all cells of a row.
+ */
 typedef struct
 {
-	unsigned char map[MAX_INVADER_WIDTH][MAX_INVADER_HEIGHT];
+	invaderRow_t lives[2][MAX_INVADER_HEIGHT];
 	spixel pos;
 
 	unsigned char speed;
@@ -93,7 +104,14 @@ typedef struct
 	unsigned int points;
 } Player;
 
-typedef unsigned char offScreen_t[NUMPLANE + 1][NUM_ROWS][LINEBYTES];
+/* bit-sliced lives of the guards, laid out like a line of the frame buffer */
+typedef struct
+{
+	unsigned char lives[2][LINEBYTES];
+} Guards;
+
+/* off-screen copy of the frame buffer */
+typedef unsigned char offScreen_t[NUMPLANE][NUM_ROWS][LINEBYTES];
 
 
 /****************************************************************/
@@ -108,36 +126,39 @@ void procCannon(Cannon * cn, pixel * shot);
 
 void procInvaders(Invaders * iv, pixel st[MAX_SHOTS]);
 void procShots(Invaders * iv, Player * pl, Cannon * cn, Spaceship * sc,
-		unsigned char guards[NUM_COLS], pixel st[MAX_SHOTS], pixel * shot);
+		Guards * guards, pixel st[MAX_SHOTS], pixel * shot);
 
 unsigned char getStatus(Invaders * iv);
 
 /*----------------------Initialization---------------------------*/
 
-void initGuards(unsigned char guards[NUM_COLS]);
+void initGuards(Guards * guards);
 void initInvaders(Invaders * iv, unsigned char lv);
 
 /*----------------------getter/setter----------------------------*/
 
+/* occupied cells of a formation row */
+inline static invaderRow_t getInvaderRow(Invaders * iv, unsigned char row)
+{
+	return iv->lives[0][row] | iv->lives[1][row];
+}
+
 unsigned char getInvaderPixel(Invaders * iv, unsigned char x, unsigned char y);
 
-void setInvaderPixel(Invaders * iv, unsigned char x, unsigned char y,
+void setInvaderCell(Invaders * iv, unsigned char col, unsigned char row,
 		unsigned char val);
 
-void setGuardPixel(unsigned char *guards, unsigned char x,
-		unsigned char y, unsigned char val);
+/* decrements the lives of an invader, returns its former lives (0 = miss) */
+unsigned char hitInvader(Invaders * iv, unsigned char x, unsigned char y);
 
-inline static unsigned char getGuardPixel(unsigned char *guards,
-		unsigned char x, unsigned char y)
-{
-	if (x < NUM_COLS && y == GUARD_LINE)
-		return guards[x];
-	return 0;
-}
+void setGuardPixel(Guards * guards, unsigned char x, unsigned char val);
+
+/* decrements the lives of a guard, returns its former lives (0 = miss) */
+unsigned char hitGuard(Guards * guards, unsigned char x, unsigned char y);
 
 /*----------------------drawing Method---------------------------*/
 
 void draw(offScreen_t offscreen, Invaders * iv, Spaceship * sc, Player * pl,
-		Cannon * cn, unsigned char *guards, pixel *st, pixel * shot);
+		Cannon * cn, Guards * guards, pixel *st, pixel * shot);
 
 #endif /* INVADERS2_H */
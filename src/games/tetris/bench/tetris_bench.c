@@ -0,0 +1,673 @@
+/**
+ * \addtogroup tetris
+ * @{
+ */
+
+/**
+ * @file tetris_bench.c
+ * @brief Headless self-play benchmark of the Tetris engine (host only).
+ * @details The unmodified Tetris core (tetris_main.c, bucket.c, piece.c and
+ *          the configured variants) gets linked against stand-ins for the
+ *          input module, the view and the high score storage. A simple AI
+ *          takes the place of the joystick: It tries every rotation and
+ *          column of a new piece on a copy of the bucket and drops the piece
+ *          at the most promising spot. As neither the view nor the input
+ *          module are linked, nothing ever calls wait() and the games run at
+ *          full speed.
+ *
+ *          For every variant the benchmark reports the placed pieces per
+ *          second, the positions evaluated by the AI per second, the cost of
+ *          the variant's choosePiece() method and the distribution of game
+ *          lengths. Games are seeded with consecutive values starting at a
+ *          fixed seed, so the game lengths are reproducible and any change
+ *          after touching bucket.c indicates a behavioural regression.
+ *
+ *          The benchmark doubles as a test of the Tetris core's static
+ *          storage: malloc() and friends are wrapped at link time and any
+ *          heap use while a game is running aborts the benchmark.
+ *
+ *          Build with "make tetris-bench" after configuring the borgware and
+ *          run "./tetrisbench -h" for the available options.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../../config.h"
+#include "../../../random/prng.h"
+#include "../bearing.h"
+#include "../piece.h"
+#include "../highscore.h"
+#include "../bucket.h"
+#include "../input.h"
+#include "../variants.h"
+#include "../view.h"
+#include "../tetris_main.h"
+#if defined(GAME_TETRIS) || defined(GAME_TETRIS_FP)
+#	include "../variant_std.h"
+#endif
+#ifdef GAME_TETRIS_FP
+#	include "../variant_fp.h"
+#endif
+#ifdef GAME_BASTET
+#	include "../variant_bastet.h"
+#endif
+
+
+/***********
+ * defines *
+ ***********/
+
+/** width of the benchmark bucket */
+#define TETRIS_BENCH_WIDTH  10
+/** height of the benchmark bucket */
+#define TETRIS_BENCH_HEIGHT 20
+
+/** default number of games per variant */
+#define TETRIS_BENCH_GAMES     100
+/** default number of pieces after which the AI gives up a game */
+#define TETRIS_BENCH_MAXPIECES 1000
+/** default seed of the first game */
+#define TETRIS_BENCH_SEED      1
+
+// weights of the AI's evaluation function
+#define TETRIS_BENCH_WEIGHT_LINES   760
+#define TETRIS_BENCH_WEIGHT_HEIGHT  510
+#define TETRIS_BENCH_WEIGHT_HOLES   356
+#define TETRIS_BENCH_WEIGHT_BUMPS   184
+
+
+/*********
+ * types *
+ *********/
+
+/** a variant which can be benchmarked */
+typedef struct tetris_bench_variant_s
+{
+	char const *pszName;              /**< name on the command line */
+	tetris_variant_t const *pMethods; /**< its original methods */
+}
+tetris_bench_variant_t;
+
+
+/*************
+ * variables *
+ *************/
+
+/** all configured variants */
+static tetris_bench_variant_t const tetris_bench_variants[] =
+{
+#ifdef GAME_TETRIS
+	{"std", &tetrisStdVariant},
+#endif
+#ifdef GAME_TETRIS_FP
+	{"fp", &tetrisFpVariant},
+#endif
+#ifdef GAME_BASTET
+	{"bastet", &tetrisBastetVariant},
+#endif
+};
+
+#define TETRIS_BENCH_VARIANT_COUNT \
+	(sizeof(tetris_bench_variants) / sizeof(tetris_bench_variants[0]))
+
+/** copy of the benchmarked methods, choosePiece() gets intercepted */
+static tetris_variant_t tetris_bench_methods;
+/** original choosePiece() method of the benchmarked variant */
+static tetris_piece_t (*tetris_bench_choosePiece)(void *pVariantData);
+
+/** bucket of the running game (taken from the view) */
+static tetris_bucket_t *tetris_bench_pBucket;
+/** variant data object of the running game (taken from the view) */
+static void *tetris_bench_pVariantData;
+
+/** number of pieces after which the AI gives up */
+static uint32_t tetris_bench_nMaxPieces = TETRIS_BENCH_MAXPIECES;
+
+/** set while tetris_main() runs, no heap use is allowed then */
+static uint8_t tetris_bench_bInGame;
+
+// figures of the running game
+static uint32_t tetris_bench_nPieces;   /**< chosen pieces so far */
+static uint64_t tetris_bench_nEvals;    /**< evaluated positions so far */
+static uint64_t tetris_bench_nChooseNs; /**< time spent in choosePiece() */
+static uint64_t tetris_bench_nChooseMaxNs; /**< slowest choosePiece() call */
+
+// the AI's plan for the current piece
+static uint8_t tetris_bench_bPlanned;   /**< plan for current piece exists */
+static uint8_t tetris_bench_nRotations; /**< remaining rotations */
+static int8_t tetris_bench_nTarget;     /**< target column */
+static int8_t tetris_bench_nLastColumn; /**< column before the last move */
+
+
+/***************************
+ * non-interface functions *
+ ***************************/
+
+/**
+ * reads a monotonic clock
+ * @return current time in nanoseconds
+ */
+static uint64_t tetris_bench_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * choosePiece() replacement which measures the original method
+ * @param pVariantData the variant instance of interest
+ * @return the piece chosen by the variant
+ */
+static tetris_piece_t tetris_bench_timedChoosePiece(void *pVariantData)
+{
+	uint64_t const nStart = tetris_bench_now();
+	tetris_piece_t const piece = tetris_bench_choosePiece(pVariantData);
+	uint64_t const nTime = tetris_bench_now() - nStart;
+
+	tetris_bench_nChooseNs += nTime;
+	if (nTime > tetris_bench_nChooseMaxNs)
+	{
+		tetris_bench_nChooseMaxNs = nTime;
+	}
+	++tetris_bench_nPieces;
+	tetris_bench_bPlanned = 0;
+	return piece;
+}
+
+
+/**
+ * rates the dump of a bucket whose piece has been docked
+ * @param pBucket the bucket to be rated
+ * @param nLines number of lines the piece has completed
+ * @return the higher the better
+ */
+static int32_t tetris_bench_rate(tetris_bucket_t *pBucket,
+                                 uint8_t nLines)
+{
+	int8_t const nWidth = tetris_bucket_getWidth(pBucket);
+	int8_t const nHeight = tetris_bucket_getHeight(pBucket);
+	int32_t nAggregate = 0, nHoles = 0, nBumps = 0;
+	int8_t nLastHeight = -1;
+
+	for (int8_t x = 0; x < nWidth; ++x)
+	{
+		uint16_t const nMask = (uint16_t)1 << x;
+		int8_t nColHeight = 0;
+		for (int8_t y = 0; y < nHeight; ++y)
+		{
+			if (tetris_bucket_getDumpRow(pBucket, y) & nMask)
+			{
+				if (nColHeight == 0)
+				{
+					nColHeight = nHeight - y;
+				}
+			}
+			else if (nColHeight != 0)
+			{
+				++nHoles;
+			}
+		}
+		nAggregate += nColHeight;
+		if (nLastHeight >= 0)
+		{
+			nBumps += abs(nColHeight - nLastHeight);
+		}
+		nLastHeight = nColHeight;
+	}
+
+	return TETRIS_BENCH_WEIGHT_LINES * nLines
+			- TETRIS_BENCH_WEIGHT_HEIGHT * nAggregate
+			- TETRIS_BENCH_WEIGHT_HOLES * nHoles
+			- TETRIS_BENCH_WEIGHT_BUMPS * nBumps;
+}
+
+
+/**
+ * plays a move on a copy of the bucket just like the real game would do
+ * @param pBucket bucket with the piece at its initial position
+ * @param nRotations number of clockwise rotations
+ * @param nColumn target column
+ * @param pScore receives the rating of the move
+ * @return 1 if the move is possible, otherwise 0
+ */
+static uint8_t tetris_bench_tryMove(tetris_bucket_t const *pBucket,
+                                    uint8_t nRotations,
+                                    int8_t nColumn,
+                                    int32_t *pScore)
+{
+	tetris_bucket_t bucket = *pBucket;
+	++tetris_bench_nEvals;
+
+	while (nRotations--)
+	{
+		if (!tetris_bucket_rotatePiece(&bucket, TETRIS_PC_ROT_CW))
+		{
+			return 0;
+		}
+	}
+	while (tetris_bucket_getColumn(&bucket) != nColumn)
+	{
+		if (!tetris_bucket_movePiece(&bucket,
+				tetris_bucket_getColumn(&bucket) < nColumn ?
+						TETRIS_BUD_RIGHT : TETRIS_BUD_LEFT))
+		{
+			return 0;
+		}
+	}
+	while ((tetris_bucket_getStatus(&bucket) == TETRIS_BUS_HOVERING) ||
+			(tetris_bucket_getStatus(&bucket) == TETRIS_BUS_GLIDING))
+	{
+		tetris_bucket_advancePiece(&bucket);
+	}
+	if (tetris_bucket_getStatus(&bucket) == TETRIS_BUS_GAMEOVER)
+	{
+		*pScore = INT32_MIN;
+		return 1;
+	}
+
+	tetris_bucket_removeCompleteLines(&bucket);
+	*pScore = tetris_bench_rate(&bucket,
+			tetris_bucket_calculateLines(tetris_bucket_getRowMask(&bucket)));
+	return 1;
+}
+
+
+/**
+ * determines rotation and column for the current piece
+ * @param pBucket the bucket of the running game
+ */
+static void tetris_bench_plan(tetris_bucket_t *pBucket)
+{
+	tetris_bench_bPlanned = 1;
+	tetris_bench_nRotations = 0;
+	tetris_bench_nTarget = tetris_bucket_getColumn(pBucket);
+	tetris_bench_nLastColumn = TETRIS_BUCKET_INVALID;
+
+	// give up by dropping everything straight down
+	if (tetris_bench_nPieces > tetris_bench_nMaxPieces)
+	{
+		return;
+	}
+
+	int32_t nBest = INT32_MIN;
+	uint8_t const nAngles =
+			tetris_piece_getAngleCount(tetris_bucket_getPiece(pBucket));
+	for (uint8_t nRot = 0; nRot < nAngles; ++nRot)
+	{
+		for (int8_t nCol = -3; nCol < tetris_bucket_getWidth(pBucket); ++nCol)
+		{
+			int32_t nScore;
+			if (tetris_bench_tryMove(pBucket, nRot, nCol, &nScore) &&
+					(nScore > nBest))
+			{
+				nBest = nScore;
+				tetris_bench_nRotations = nRot;
+				tetris_bench_nTarget = nCol;
+			}
+		}
+	}
+}
+
+
+/*********************************
+ * stand-in of the input module *
+ *********************************/
+
+void tetris_input_construct(tetris_input_t *pIn)
+{
+	memset(pIn, 0, sizeof(tetris_input_t));
+	tetris_bench_bPlanned = 0;
+}
+
+
+tetris_input_command_t tetris_input_getCommand(tetris_input_t *pIn,
+                                               tetris_input_pace_t nPace)
+{
+	tetris_bucket_t *pBucket = tetris_bench_pBucket;
+	if (!tetris_bench_bPlanned)
+	{
+		tetris_bench_plan(pBucket);
+	}
+
+	if (tetris_bench_nRotations != 0)
+	{
+		--tetris_bench_nRotations;
+		return TETRIS_INCMD_ROT_CW;
+	}
+
+	// stop moving if the piece got stuck (which should never happen)
+	int8_t const nColumn = tetris_bucket_getColumn(pBucket);
+	if ((nColumn != tetris_bench_nTarget) &&
+			(nColumn != tetris_bench_nLastColumn))
+	{
+		tetris_bench_nLastColumn = nColumn;
+		return nColumn < tetris_bench_nTarget ?
+				TETRIS_INCMD_RIGHT : TETRIS_INCMD_LEFT;
+	}
+	return TETRIS_INCMD_DROP;
+}
+
+
+void tetris_input_setLevel(tetris_input_t *pIn,
+                           uint8_t nLvl)
+{
+}
+
+
+void tetris_input_resetDownKeyRepeat(tetris_input_t *pIn)
+{
+}
+
+
+void tetris_input_setBearing(tetris_input_t *pIn,
+                             tetris_bearing_t nBearing)
+{
+}
+
+
+/*************************
+ * stand-in of the view *
+ *************************/
+
+void tetris_view_construct(tetris_view_t *pView,
+                           tetris_variant_t const *const pVarMethods,
+                           void *pVariantData,
+                           tetris_bucket_t *pBucket)
+{
+	memset(pView, 0, sizeof(tetris_view_t));
+	pView->pVariantMethods = pVarMethods;
+	pView->pVariant = pVariantData;
+	pView->pBucket = pBucket;
+	tetris_bench_pBucket = pBucket;
+	tetris_bench_pVariantData = pVariantData;
+}
+
+
+void tetris_view_getDimensions(int8_t *w,
+                               int8_t *h)
+{
+	*w = TETRIS_BENCH_WIDTH;
+	*h = TETRIS_BENCH_HEIGHT;
+}
+
+
+void tetris_view_update(tetris_view_t *pV)
+{
+}
+
+
+void tetris_view_showResults(tetris_view_t *pV)
+{
+}
+
+
+/*******************************************
+ * stand-in of the high score table (RAM) *
+ *******************************************/
+
+static tetris_highscore_entry_t g_highScoreTable[TETRIS_HISCORE_END];
+
+
+uint16_t tetris_highscore_retrieveHighScore(tetris_highscore_index_t nIndex)
+{
+	return g_highScoreTable[nIndex].nHighScore;
+}
+
+
+void tetris_highscore_saveHighScore(tetris_highscore_index_t nIndex,
+                                    uint16_t nHighScore)
+{
+	if (nHighScore > g_highScoreTable[nIndex].nHighScore)
+	{
+		g_highScoreTable[nIndex].nHighScore = nHighScore;
+	}
+}
+
+
+uint16_t tetris_highscore_retrieveHighScoreName(tetris_highscore_index_t nIdx)
+{
+	return g_highScoreTable[nIdx].nHighScoreName;
+}
+
+
+void tetris_highscore_saveHighScoreName(tetris_highscore_index_t nIndex,
+                                        uint16_t nHighscoreName)
+{
+	g_highScoreTable[nIndex].nHighScoreName = nHighscoreName;
+}
+
+
+uint16_t tetris_highscore_inputName(void)
+{
+	return 0;
+}
+
+
+/*****************
+ * the benchmark *
+ *****************/
+
+/**
+ * comparison function for qsort()
+ */
+static int tetris_bench_compare(void const *pA,
+                                void const *pB)
+{
+	uint32_t const a = *(uint32_t const *)pA, b = *(uint32_t const *)pB;
+	return (a > b) - (a < b);
+}
+
+
+/**
+ * prints minimum, quartiles and maximum of some values
+ * @param pszLabel what the values are about
+ * @param pValues the values (get sorted)
+ * @param nCount number of values
+ */
+static void tetris_bench_printDistribution(char const *pszLabel,
+                                           uint32_t *pValues,
+                                           unsigned nCount)
+{
+	uint64_t nSum = 0;
+	for (unsigned i = 0; i < nCount; ++i)
+	{
+		nSum += pValues[i];
+	}
+	qsort(pValues, nCount, sizeof(uint32_t), tetris_bench_compare);
+	printf("  %-8s min %6u  q1 %6u  median %6u  q3 %6u  max %6u  mean %9.1f"
+			"\n", pszLabel, (unsigned)pValues[0],
+			(unsigned)pValues[nCount / 4], (unsigned)pValues[nCount / 2],
+			(unsigned)pValues[(3 * nCount) / 4],
+			(unsigned)pValues[nCount - 1], (double)nSum / nCount);
+}
+
+
+/*
+ * The Tetris core must not touch the heap at all. These wrappers take the
+ * place of the C library's allocator (see -Wl,--wrap in the Makefile).
+ */
+void *__real_malloc(size_t nSize);
+void *__real_calloc(size_t nCount, size_t nSize);
+void *__real_realloc(void *p, size_t nSize);
+void __real_free(void *p);
+
+
+/**
+ * aborts the benchmark if the heap gets used during a game
+ * @param pszFunction name of the called allocator function
+ */
+static void tetris_bench_checkHeap(char const *pszFunction)
+{
+	if (tetris_bench_bInGame)
+	{
+		fprintf(stderr, "tetrisbench: %s() called during a game\n",
+				pszFunction);
+		abort();
+	}
+}
+
+
+void *__wrap_malloc(size_t nSize)
+{
+	tetris_bench_checkHeap("malloc");
+	return __real_malloc(nSize);
+}
+
+
+void *__wrap_calloc(size_t nCount, size_t nSize)
+{
+	tetris_bench_checkHeap("calloc");
+	return __real_calloc(nCount, nSize);
+}
+
+
+void *__wrap_realloc(void *p, size_t nSize)
+{
+	tetris_bench_checkHeap("realloc");
+	return __real_realloc(p, nSize);
+}
+
+
+void __wrap_free(void *p)
+{
+	tetris_bench_checkHeap("free");
+	__real_free(p);
+}
+
+
+/**
+ * plays a series of games with a variant and prints the results
+ * @param pVariant the variant to be benchmarked
+ * @param nGames number of games
+ * @param nSeed seed of the first game
+ */
+static void tetris_bench_run(tetris_bench_variant_t const *pVariant,
+                             unsigned nGames,
+                             uint32_t nSeed)
+{
+	uint32_t *pPieces = malloc(nGames * sizeof(uint32_t));
+	uint32_t *pLines = malloc(nGames * sizeof(uint32_t));
+	if ((pPieces == NULL) || (pLines == NULL))
+	{
+		perror("tetrisbench");
+		exit(EXIT_FAILURE);
+	}
+
+	tetris_bench_methods = *pVariant->pMethods;
+	tetris_bench_choosePiece = tetris_bench_methods.choosePiece;
+	tetris_bench_methods.choosePiece = &tetris_bench_timedChoosePiece;
+
+	uint64_t nTotalPieces = 0, nTotalEvals = 0, nChooseNs = 0;
+	tetris_bench_nChooseMaxNs = 0;
+	uint64_t const nStart = tetris_bench_now();
+	for (unsigned i = 0; i < nGames; ++i)
+	{
+#ifdef RANDOM_SUPPORT
+		random_restart(nSeed + i);
+#else
+		srand(nSeed + i);
+#endif
+		memset(&g_highScoreTable, 0, sizeof(g_highScoreTable));
+		tetris_bench_nPieces = 0;
+		tetris_bench_nEvals = 0;
+		tetris_bench_nChooseNs = 0;
+
+		tetris_bench_bInGame = 1;
+		tetris_main(&tetris_bench_methods);
+		tetris_bench_bInGame = 0;
+
+		pPieces[i] = tetris_bench_nPieces;
+		pLines[i] = tetris_bench_methods.getLines(tetris_bench_pVariantData);
+		nTotalPieces += tetris_bench_nPieces;
+		nTotalEvals += tetris_bench_nEvals;
+		nChooseNs += tetris_bench_nChooseNs;
+	}
+	double const nSeconds = (tetris_bench_now() - nStart) / 1e9;
+
+	printf("%s: %u games, seeds %lu..%lu, %.3f s\n", pVariant->pszName,
+			nGames, (unsigned long)nSeed,
+			(unsigned long)(nSeed + nGames - 1), nSeconds);
+	printf("  pieces   %10.0f placed/s  %12.0f evaluated/s\n",
+			nTotalPieces / nSeconds, nTotalEvals / nSeconds);
+	printf("  choose   %10.2f us mean   %12.2f us max\n",
+			nChooseNs / 1e3 / (nTotalPieces ? nTotalPieces : 1),
+			tetris_bench_nChooseMaxNs / 1e3);
+	tetris_bench_printDistribution("pieces", pPieces, nGames);
+	tetris_bench_printDistribution("lines", pLines, nGames);
+
+	free(pPieces);
+	free(pLines);
+}
+
+
+/**
+ * prints the usage
+ * @param pszName name of the executable
+ */
+static void tetris_bench_usage(char const *pszName)
+{
+	fprintf(stderr, "usage: %s [-g games] [-p max pieces] [-s seed] "
+			"[variant...]\nvariants:", pszName);
+	for (unsigned i = 0; i < TETRIS_BENCH_VARIANT_COUNT; ++i)
+	{
+		fprintf(stderr, " %s", tetris_bench_variants[i].pszName);
+	}
+	fprintf(stderr, "\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	unsigned nGames = TETRIS_BENCH_GAMES;
+	uint32_t nSeed = TETRIS_BENCH_SEED;
+
+	int nOpt;
+	while ((nOpt = getopt(argc, argv, "g:p:s:h")) != -1)
+	{
+		switch (nOpt)
+		{
+		case 'g':
+			nGames = (unsigned)strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			tetris_bench_nMaxPieces = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			nSeed = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		default:
+			tetris_bench_usage(argv[0]);
+			return nOpt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	if (nGames == 0)
+	{
+		tetris_bench_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// without arguments, all configured variants get benchmarked
+	for (unsigned i = 0; i < TETRIS_BENCH_VARIANT_COUNT; ++i)
+	{
+		uint8_t bSelected = (optind == argc);
+		for (int j = optind; j < argc; ++j)
+		{
+			bSelected |= !strcmp(argv[j], tetris_bench_variants[i].pszName);
+		}
+		if (bSelected)
+		{
+			tetris_bench_run(&tetris_bench_variants[i], nGames, nSeed);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/*@}*/
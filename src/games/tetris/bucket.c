@@ -44,7 +44,7 @@ static uint8_t tetris_bucket_collision(tetris_bucket_t *pBucket,
 	assert((nRow > -4) && (nRow < pBucket->nHeight));
 
 	// left and right borders
-	uint16_t const nPieceMap = tetris_piece_getBitmap(pBucket->pPiece);
+	uint16_t const nPieceMap = tetris_piece_getBitmap(&pBucket->piece);
 	uint16_t nBucketPart = 0;
 	if (nCol < 0)
 	{
@@ -114,19 +114,14 @@ static void tetris_bucket_hoverStatus(tetris_bucket_t *pBucket)
  * construction/destruction *
  ****************************/
 
-tetris_bucket_t *tetris_bucket_construct(int8_t nWidth,
-                                         int8_t nHeight)
+void tetris_bucket_construct(tetris_bucket_t *pBucket,
+                             int8_t nWidth,
+                             int8_t nHeight)
 {
+	assert(pBucket != NULL);
 	assert((nWidth >= 4) && (nWidth <= TETRIS_BUCKET_MAX_COLUMNS));
 	assert((nHeight >= 4) && (nHeight <= TETRIS_BUCKET_MAX_ROWS));
 
-	// allocating memory
-	tetris_bucket_t *pBucket =
-			(tetris_bucket_t *)malloc(sizeof(tetris_bucket_t));
-	assert(pBucket != NULL);
-	pBucket->dump = (uint16_t *)calloc((size_t)nHeight, sizeof(uint16_t));
-	assert(pBucket->dump != NULL);
-
 	// setting requested attributes
 	pBucket->nHeight = pBucket->nFirstTaintedRow = nHeight;
 	pBucket->nWidth = nWidth;
@@ -135,8 +130,6 @@ tetris_bucket_t *tetris_bucket_construct(int8_t nWidth,
 	pBucket->nFullRow = 0xFFFF >> (16 - pBucket->nWidth);
 
 	tetris_bucket_reset(pBucket);
-
-	return pBucket;
 }
 
 
@@ -147,9 +140,8 @@ tetris_bucket_t *tetris_bucket_construct(int8_t nWidth,
 void tetris_bucket_reset(tetris_bucket_t *pBucket)
 {
 	assert(pBucket != NULL);
-	assert(pBucket->dump != NULL);
 
-	pBucket->pPiece = NULL;
+	tetris_piece_construct(&pBucket->piece, TETRIS_PC_LINE, TETRIS_PC_ANGLE_0);
 	pBucket->nColumn = 0;
 	pBucket->nRow = 0;
 	pBucket->nRowMask = 0;
@@ -160,8 +152,8 @@ void tetris_bucket_reset(tetris_bucket_t *pBucket)
 }
 
 
-tetris_piece_t *tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
-                                          tetris_piece_t *pPiece)
+void tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
+                               tetris_piece_t const *pPiece)
 {
 	assert((pBucket != NULL) && (pPiece != NULL));
 
@@ -179,8 +171,7 @@ tetris_piece_t *tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
 			1 - tetris_piece_getBottomOffset(tetris_piece_getBitmap(pPiece));
 
 	// replace old piece
-	tetris_piece_t *pOldPiece = pBucket->pPiece;
-	pBucket->pPiece = pPiece;
+	pBucket->piece = *pPiece;
 
 	// did we already collide with something?
 	if (tetris_bucket_collision(pBucket, pBucket->nColumn, pBucket->nRow))
@@ -193,7 +184,6 @@ tetris_piece_t *tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
 		// bring it on!
 		tetris_bucket_hoverStatus(pBucket);
 	}
-	return pOldPiece;
 }
 
 
@@ -207,7 +197,7 @@ void tetris_bucket_advancePiece(tetris_bucket_t *pBucket)
 	// collision detected? check if we can embed the piece into the bucket...
 	if (tetris_bucket_collision(pBucket, pBucket->nColumn, pBucket->nRow + 1))
 	{
-		uint16_t nPieceMap = tetris_piece_getBitmap(pBucket->pPiece);
+		uint16_t nPieceMap = tetris_piece_getBitmap(&pBucket->piece);
 		// determine first row of the piece (skipping empty lines at the top)
 		int8_t nPieceTop = pBucket->nRow + tetris_piece_getTopRow(nPieceMap);
 
@@ -282,13 +272,13 @@ uint8_t tetris_bucket_rotatePiece(tetris_bucket_t *pBucket,
 	assert((pBucket->status == TETRIS_BUS_HOVERING) ||
 			(pBucket->status == TETRIS_BUS_GLIDING));
 
-	tetris_piece_rotate(pBucket->pPiece, rotation);
+	tetris_piece_rotate(&pBucket->piece, rotation);
 
 	// does the rotated piece collide with something?
 	if (tetris_bucket_collision(pBucket, pBucket->nColumn, pBucket->nRow))
 	{
 		// in that case we revert the rotation
-		tetris_piece_rotate(pBucket->pPiece, rotation == TETRIS_PC_ROT_CW ?
+		tetris_piece_rotate(&pBucket->piece, rotation == TETRIS_PC_ROT_CW ?
 				TETRIS_PC_ROT_CCW : TETRIS_PC_ROT_CW);
 		return 0;
 	}
@@ -369,8 +359,8 @@ int8_t tetris_bucket_predictDeepestRow(tetris_bucket_t *pBucket,
 	assert(nColumn > TETRIS_BUCKET_INVALID && nColumn < pBucket->nWidth);
 
 	// exchange current piece of the bucket (to use its collision detection)
-	tetris_piece_t *pActualPiece = pBucket->pPiece;
-	pBucket->pPiece = pPiece;
+	tetris_piece_t const actualPiece = pBucket->piece;
+	pBucket->piece = *pPiece;
 
 	// skip empty rows at the bottom of the piece which may overlap the dump
 	uint16_t nMap = tetris_piece_getBitmap(pPiece);
@@ -391,7 +381,7 @@ int8_t tetris_bucket_predictDeepestRow(tetris_bucket_t *pBucket,
 	}
 
 	// restore actual bucket piece
-	pBucket->pPiece = pActualPiece;
+	pBucket->piece = actualPiece;
 
 	return nStartRow;
 }
@@ -27,7 +27,13 @@
 
 #define TETRIS_BUCKET_INVALID -4
 #define TETRIS_BUCKET_MAX_COLUMNS 16
-#define TETRIS_BUCKET_MAX_ROWS (INT8_MAX - 4)
+// the view never shows more than 20 rows, so the dump is sized statically
+#ifndef TETRIS_BUCKET_MAX_ROWS
+	#define TETRIS_BUCKET_MAX_ROWS 20
+#endif
+#if TETRIS_BUCKET_MAX_ROWS > (INT8_MAX - 4)
+	#error TETRIS_BUCKET_MAX_ROWS must not exceed INT8_MAX - 4
+#endif
 
 
 /*********
@@ -68,14 +74,14 @@ typedef struct tetris_bucket_s
 {
 	int8_t nWidth;                  /**< width of bucket */
 	int8_t nHeight;                 /**< height of bucket */
-	tetris_piece_t *pPiece;         /**< currently falling piece */
+	tetris_piece_t piece;           /**< currently falling piece */
 	int8_t nColumn;                 /**< horz. piece pos. (0 is left) */
 	int8_t nRow;                    /**< vert. piece pos. (0 is top) */
 	uint8_t nRowMask;               /**< removed lines relative to nRow */
 	tetris_bucket_status_t status;  /**< status of the bucket */
 	int8_t nFirstTaintedRow;        /**< top most row which has matter */
 	uint16_t nFullRow;              /**< value of a full row */
-	uint16_t *dump;                 /**< bucket itself */
+	uint16_t dump[TETRIS_BUCKET_MAX_ROWS]; /**< bucket itself */
 }
 tetris_bucket_t;
 
@@ -101,25 +107,13 @@ tetris_bucket_iterator_t;
 
 /**
  * constructs a bucket with the given dimensions
- * @param nWidth width of bucket (4 <= n <= 16)
- * @param nHeight height of bucket (4 <= n <= TETRIS_BUCKET_MAX_COLUMNS)
- * @return pointer to a newly created bucket
+ * @param pBucket pointer to the storage of the bucket
+ * @param nWidth width of bucket (4 <= n <= TETRIS_BUCKET_MAX_COLUMNS)
+ * @param nHeight height of bucket (4 <= n <= TETRIS_BUCKET_MAX_ROWS)
  */
-tetris_bucket_t *tetris_bucket_construct(int8_t nWidth,
-                                         int8_t nHeight);
-
-
-/**
- * destructs a bucket
- * @param pBucket pointer to the bucket to be destructed
- */
-inline static void tetris_bucket_destruct(tetris_bucket_t *pBucket)
-{
-	assert(pBucket != NULL);
-	assert(pBucket->dump != NULL);
-	free(pBucket->dump);
-	free(pBucket);
-}
+void tetris_bucket_construct(tetris_bucket_t *pBucket,
+                             int8_t nWidth,
+                             int8_t nHeight);
 
 
 /*******************************
@@ -164,11 +158,10 @@ void tetris_bucket_reset(tetris_bucket_t *pBucket);
 /**
  * inserts a new piece
  * @param pBucket bucket to perform action on
- * @param pPiece piece to be inserted
- * @return pointer to former piece for deallocation
+ * @param pPiece piece to be inserted (the bucket keeps a copy of it)
  */
-tetris_piece_t *tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
-                                          tetris_piece_t *pPiece);
+void tetris_bucket_insertPiece(tetris_bucket_t *pBucket,
+                               tetris_piece_t const *pPiece);
 
 
 /**
@@ -241,7 +234,7 @@ inline static int8_t tetris_bucket_getHeight(tetris_bucket_t *pBucket)
 inline static tetris_piece_t *tetris_bucket_getPiece(tetris_bucket_t *pBucket)
 {
 	assert(pBucket != NULL);
-	return pBucket->pPiece;
+	return &pBucket->piece;
 }
 
 
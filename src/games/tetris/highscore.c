@@ -17,12 +17,26 @@
 #include "../../config.h"
 #include "../../scrolltext/scrolltext.h"
 #include "../../joystick/joystick.h"
-#include "../../compat/eeprom.h"
+#include "../../kvstore.h"
 #include "highscore.h"
 
 
-/** The global high score table (located in the EEPROM), */
-tetris_highscore_table_t g_highScoreTable EEMEM;
+#if (KV_TETRIS_HIGHSCORE_END - KV_TETRIS_HIGHSCORE) < TETRIS_HISCORE_END
+#	error the settings store provides too few keys for the Tetris high scores
+#endif
+
+
+/**
+ * retrieves the high score entry of a variant from the settings store
+ * @param nIndex the variant dependent index of the high score
+ * @param pEntry receives the entry (zeroed if there is none)
+ */
+static void tetris_highscore_retrieveEntry(tetris_highscore_index_t nIndex,
+                                           tetris_highscore_entry_t *pEntry)
+{
+	memset(pEntry, 0, sizeof(*pEntry));
+	kv_get(KV_TETRIS_HIGHSCORE + nIndex, pEntry, sizeof(*pEntry));
+}
 
 
 uint16_t tetris_highscore_inputName(void)
@@ -109,12 +123,40 @@ uint16_t tetris_highscore_inputName(void)
 
 uint16_t tetris_highscore_retrieveHighScore(tetris_highscore_index_t nIndex)
 {
-	eeprom_busy_wait();
-	uint16_t nHighScore =
-			eeprom_read_word(&g_highScoreTable.nHighScore[nIndex]);
+	tetris_highscore_entry_t entry;
+	tetris_highscore_retrieveEntry(nIndex, &entry);
+	return entry.nHighScore;
+}
+
+
+void tetris_highscore_saveHighScore(tetris_highscore_index_t nIndex,
+                                    uint16_t nHighScore)
+{
+	tetris_highscore_entry_t entry;
+	tetris_highscore_retrieveEntry(nIndex, &entry);
+	if (nHighScore > entry.nHighScore)
+	{
+		entry.nHighScore = nHighScore;
+		kv_set(KV_TETRIS_HIGHSCORE + nIndex, &entry, sizeof(entry));
+	}
+}
+
+
+uint16_t tetris_highscore_retrieveHighScoreName(tetris_highscore_index_t nIdx)
+{
+	tetris_highscore_entry_t entry;
+	tetris_highscore_retrieveEntry(nIdx, &entry);
+	return entry.nHighScoreName;
+}
 
-	// a score of 65535 is most likely caused by uninitialized EEPROM addresses
-	return nHighScore == UINT16_MAX ? 0 : nHighScore;
+
+void tetris_highscore_saveHighScoreName(tetris_highscore_index_t nIndex,
+                                        uint16_t nHighscoreName)
+{
+	tetris_highscore_entry_t entry;
+	tetris_highscore_retrieveEntry(nIndex, &entry);
+	entry.nHighScoreName = nHighscoreName;
+	kv_set(KV_TETRIS_HIGHSCORE + nIndex, &entry, sizeof(entry));
 }
 
 /*@}*/
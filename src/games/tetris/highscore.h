@@ -14,7 +14,6 @@
 #define TETRIS_HIGHSCORE_H_
 
 #include <stdint.h>
-#include "../../compat/eeprom.h"
 
 
 /**
@@ -36,20 +35,14 @@ enum tetris_highscore_index_e
 
 
 /**
- * type for global high score table
+ * high score entry of a variant as kept in the settings store
  */
-typedef struct tetris_highscore_table_s
+typedef struct tetris_highscore_entry_s
 {
-	uint16_t nHighScore[TETRIS_HISCORE_END];     /**< actual high scores */
-	uint16_t nHighScoreName[TETRIS_HISCORE_END]; /**< champions' initials */
+	uint16_t nHighScore;     /**< actual high score */
+	uint16_t nHighScoreName; /**< champion's initials */
 }
-tetris_highscore_table_t;
-
-
-/**
- * the actual high score table
- */
-extern tetris_highscore_table_t g_highScoreTable EEMEM;
+tetris_highscore_entry_t;
 
 
 /**
@@ -72,16 +65,8 @@ uint16_t tetris_highscore_retrieveHighScore(tetris_highscore_index_t nIndex);
  * @param nIdx the variant dependent index of the high score
  * @param nHighscoreName the high score
  */
-inline static
 void tetris_highscore_saveHighScore(tetris_highscore_index_t nIndex,
-                                    uint16_t nHighScore)
-{
-	if (nHighScore > tetris_highscore_retrieveHighScore(nIndex))
-	{
-		eeprom_busy_wait();
-		eeprom_write_word(&g_highScoreTable.nHighScore[nIndex], nHighScore);
-	}
-}
+                                    uint16_t nHighScore);
 
 
 /**
@@ -89,15 +74,7 @@ void tetris_highscore_saveHighScore(tetris_highscore_index_t nIndex,
  * @param nIdx the variant dependent index of the high score
  * @return the initials of the champion packed into a uint16_t
  */
-inline static
-uint16_t tetris_highscore_retrieveHighScoreName(tetris_highscore_index_t nIdx)
-{
-	eeprom_busy_wait();
-	uint16_t nHighScoreName =
-			eeprom_read_word(&g_highScoreTable.nHighScoreName[nIdx]);
-
-	return nHighScoreName;
-}
+uint16_t tetris_highscore_retrieveHighScoreName(tetris_highscore_index_t nIdx);
 
 
 /**
@@ -105,13 +82,8 @@ uint16_t tetris_highscore_retrieveHighScoreName(tetris_highscore_index_t nIdx)
  * @param nIndex the variant dependent index of the high score
  * @param nHighscoreName the initials of the champion packed into a uint16_t
  */
-inline static
 void tetris_highscore_saveHighScoreName(tetris_highscore_index_t nIndex,
-                                        uint16_t nHighscoreName)
-{
-	eeprom_busy_wait();
-	eeprom_write_word(&g_highScoreTable.nHighScoreName[nIndex], nHighscoreName);
-}
+                                        uint16_t nHighscoreName);
 
 
 #endif /*TETRIS_HIGHSCORE_H_*/
@@ -28,7 +28,7 @@
 #define WAIT(ms) wait(ms)
 #define PM(value) pgm_read_byte(&value)
 
-/** Number of milliseconds that each loop cycle waits. */
+/** Duration of each loop cycle in milliseconds. */
 #define TETRIS_INPUT_TICKS 5
 
 /**
@@ -171,6 +171,8 @@ static tetris_input_command_t tetris_input_queryJoystick(tetris_input_t *pIn)
 	{
 		cmdJoystick = TETRIS_INCMD_PAUSE;
 		WAIT(TETRIS_INPUT_PAUSE_TICKS);
+		// don't count the pause delay as an overrun of the current cycle
+		begin_frame(&pIn->pacer);
 	}
 	else if (JOYISDOWN)
 	{
@@ -222,9 +224,8 @@ static tetris_input_command_t tetris_input_queryJoystick(tetris_input_t *pIn)
  * construction/destruction *
  ****************************/
 
-tetris_input_t *tetris_input_construct(void)
+void tetris_input_construct(tetris_input_t *pIn)
 {
-	tetris_input_t *pIn = (tetris_input_t *)malloc(sizeof(tetris_input_t));
 	assert(pIn != NULL);
 
 	pIn->cmdRawLast = pIn->cmdLast = TETRIS_INCMD_NONE;
@@ -234,8 +235,7 @@ tetris_input_t *tetris_input_construct(void)
 	pIn->nRepeatCount = -TETRIS_INPUT_REPEAT_INITIALDELAY;
 	pIn->nPauseCount = 0;
 	memset(pIn->nIgnoreCmdCounter, 0, TETRIS_INCMD_NONE);
-
-	return pIn;
+	frame_pacer_init(&pIn->pacer, TETRIS_INPUT_TICKS);
 }
 
 
@@ -341,7 +341,7 @@ tetris_input_command_t tetris_input_getCommand(tetris_input_t *pIn,
 			++pIn->nLoopCycles;
 		}
 
-		WAIT(TETRIS_INPUT_TICKS);
+		next_frame(&pIn->pacer);
 		if (cmdReturn != TETRIS_INCMD_NONE)
 		{
 			return cmdReturn;
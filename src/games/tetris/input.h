@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <assert.h>
+#include "../../frame_pacer.h"
 #include "bearing.h"
 
 
@@ -129,6 +130,13 @@ typedef struct tetris_input_s
 	 * bearing of the bucket (for mapping directions)
 	 */
 	tetris_bearing_t nBearing;
+
+	/**
+	 * Paces the loop cycles. The time the game logic and the view need
+	 * between two calls of tetris_input_getCommand() gets deducted from the
+	 * cycle duration so that the falling speed doesn't depend on it.
+	 */
+	frame_pacer_t pacer;
 }
 tetris_input_t;
 
@@ -139,20 +147,9 @@ tetris_input_t;
 
 /**
  * constructs an input object for André's borg
- * @return pointer to a newly created input object
+ * @param pIn pointer to the storage of the input object
  */
-tetris_input_t *tetris_input_construct(void);
-
-
-/**
- * destructs an input object
- * @param pIn pointer to the input object which should be destructed
- */
-inline static void tetris_input_destruct(tetris_input_t *pIn)
-{
-	assert(pIn != NULL);
-	free(pIn);
-}
+void tetris_input_construct(tetris_input_t *pIn);
 
 
 /***************************
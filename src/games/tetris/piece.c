@@ -17,28 +17,11 @@
 #include "piece.h"
 
 
-/*****************************
- *  construction/destruction *
- *****************************/
-
-tetris_piece_t *tetris_piece_construct(tetris_piece_shape_t s,
-                                       tetris_piece_angle_t a)
-{
-	tetris_piece_t *p_piece = (tetris_piece_t*) malloc (sizeof(tetris_piece_t));
-	assert(p_piece != NULL);
-
-	p_piece->shape = s;
-	p_piece->angle = a;
-
-	return p_piece;
-}
-
-
 /****************************
  *  piece related functions *
  ****************************/
 
-uint16_t tetris_piece_getBitmap(tetris_piece_t *pPc)
+uint16_t tetris_piece_getBitmap(tetris_piece_t const *pPc)
 {
 	assert(pPc != NULL);
 	assert((pPc->angle < 4) && (pPc->shape < 7));
@@ -59,7 +42,7 @@ uint16_t tetris_piece_getBitmap(tetris_piece_t *pPc)
 }
 
 
-uint8_t tetris_piece_getAngleCount(tetris_piece_t *pPc)
+uint8_t tetris_piece_getAngleCount(tetris_piece_t const *pPc)
 {
 	assert(pPc != NULL);
 
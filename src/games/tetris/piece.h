@@ -85,22 +85,19 @@ tetris_piece_t;
 
 /**
  * constructs a piece with the given attributes
+ * @param pPc pointer to the storage of the piece
  * @param s shape of the piece (see tetris_piece_shape_t)
  * @param a its angle (see tetris_piece_angel_t)
- * @return pointer to a newly created piece
  */
-tetris_piece_t *tetris_piece_construct(tetris_piece_shape_t s,
-                                       tetris_piece_angle_t a);
-
-
-/**
- * destructs a piece
- * @param pPc pointer to the piece to be destructed
- */
-inline static void tetris_piece_destruct(tetris_piece_t *pPc)
+inline static void tetris_piece_construct(tetris_piece_t *pPc,
+                                          tetris_piece_shape_t s,
+                                          tetris_piece_angle_t a)
 {
 	assert(pPc != NULL);
-	free(pPc);
+	assert((s <= TETRIS_PC_Z) && (a <= TETRIS_PC_ANGLE_270));
+
+	pPc->shape = s;
+	pPc->angle = a;
 }
 
 
@@ -113,7 +110,7 @@ inline static void tetris_piece_destruct(tetris_piece_t *pPc)
  * @param pPc piece from which the bitfield shuld be retrieved
  * @return bitfield representation of the piece
  */
-uint16_t tetris_piece_getBitmap(tetris_piece_t *pPc);
+uint16_t tetris_piece_getBitmap(tetris_piece_t const *pPc);
 
 
 /**
@@ -168,7 +165,7 @@ inline static void tetris_piece_setAngle(tetris_piece_t *pPc,
  * @param pPc piece whose angle count we want to know
  * @return number of different angles
  */
-uint8_t tetris_piece_getAngleCount(tetris_piece_t *pPc);
+uint8_t tetris_piece_getAngleCount(tetris_piece_t const *pPc);
 
 
 /**
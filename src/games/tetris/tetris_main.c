@@ -9,9 +9,9 @@
  * @author Christian Kroll
  */
 
-#include <stdlib.h>
 #include <assert.h>
 #include <stdint.h>
+#include "../../config.h"
 #include "bearing.h"
 #include "piece.h"
 #include "highscore.h"
@@ -20,6 +20,36 @@
 #include "variants.h"
 #include "view.h"
 #include "tetris_main.h"
+#if defined(GAME_TETRIS) || defined(GAME_TETRIS_FP)
+#	include "variant_std.h"
+#endif
+#ifdef GAME_BASTET
+#	include "variant_bastet.h"
+#endif
+
+
+/**
+ * Storage which is large enough for the data object of every variant.
+ */
+typedef union tetris_variant_storage_u
+{
+#if defined(GAME_TETRIS) || defined(GAME_TETRIS_FP)
+	tetris_standard_variant_t std;    /**< standard and first person Tetris */
+#endif
+#ifdef GAME_BASTET
+	tetris_bastet_variant_t bastet;   /**< Bastard Tetris */
+#endif
+	uint8_t dummy;                    /**< keeps the union from being empty */
+}
+tetris_variant_storage_t;
+
+
+// the game objects live in static storage so no heap is needed at all
+static tetris_bucket_t tetris_bucket;
+static tetris_variant_storage_t tetris_variantData;
+static tetris_input_t tetris_input;
+static tetris_view_t tetris_view;
+
 
 void tetris_main(tetris_variant_t const *const pVariantMethods)
 {
@@ -31,11 +61,14 @@ void tetris_main(tetris_variant_t const *const pVariantMethods)
 	tetris_input_command_t inCmd;
 
 	// prepare data structures that drive the game...
-	tetris_bucket_t *pBucket = tetris_bucket_construct(nWidth, nHeight);
-	void *pVariantData = pVariantMethods->construct(pBucket);
-	tetris_input_t *pIn = tetris_input_construct();
-	tetris_view_t *pView = tetris_view_construct(pVariantMethods,
-			pVariantData, pBucket);
+	tetris_bucket_t *const pBucket = &tetris_bucket;
+	void *const pVariantData = &tetris_variantData;
+	tetris_input_t *const pIn = &tetris_input;
+	tetris_view_t *const pView = &tetris_view;
+	tetris_bucket_construct(pBucket, nWidth, nHeight);
+	pVariantMethods->construct(pVariantData, pBucket);
+	tetris_input_construct(pIn);
+	tetris_view_construct(pView, pVariantMethods, pVariantData, pBucket);
 
 	// retrieve highscore
 	tetris_highscore_index_t nHighscoreIndex =
@@ -52,7 +85,6 @@ void tetris_main(tetris_variant_t const *const pVariantMethods)
 	pVariantMethods->setHighscoreName(pVariantData, nHighscoreName);
 
 	int8_t nPieceRow; // for determining skipped lines after a piece drop
-	tetris_piece_t *pPiece = NULL; // initialize piece
 	tetris_input_pace_t inPace; // pace flag
 
 	// game loop, runs as long as the game is not over
@@ -63,14 +95,13 @@ void tetris_main(tetris_variant_t const *const pVariantMethods)
 		{
 		// the bucket awaits a new piece
 		case TETRIS_BUS_READY:
-			pPiece = pVariantMethods->choosePiece(pVariantData);
-			// destruct old piece (if it exists) since we don't need it anymore
-			tetris_piece_t *pOld;
-			if ((pOld = tetris_bucket_insertPiece(pBucket, pPiece)) != NULL)
-			{
-				tetris_piece_destruct(pOld);
-			}
+		{
+			// the bucket keeps its own copy of the piece
+			tetris_piece_t const piece =
+					pVariantMethods->choosePiece(pVariantData);
+			tetris_bucket_insertPiece(pBucket, &piece);
 			break;
+		}
 
 		// a piece is hovering and can be controlled by the player
 		case TETRIS_BUS_HOVERING:
@@ -208,13 +239,6 @@ void tetris_main(tetris_variant_t const *const pVariantMethods)
 		tetris_highscore_saveHighScore(nHighscoreIndex, nHighscore);
 		tetris_highscore_saveHighScoreName(nHighscoreIndex, nHighscoreName);
 	}
-
-	// cleanup
-	tetris_view_destruct(pView);
-	tetris_input_destruct(pIn);
-	pVariantMethods->destruct(pVariantData);
-	tetris_bucket_destruct(pBucket);
-	tetris_piece_destruct(pPiece);
 }
 
 /*@}*/
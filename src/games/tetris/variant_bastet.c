@@ -63,10 +63,10 @@ static void tetris_bastet_doPreprocessing(tetris_bastet_variant_t *pBastet)
 	int8_t const nStopRow = tetris_bucket_getFirstTaintedRow(pBastet->pBucket);
 
 	// clear old precalculated scores (last three elements are always 0)
-	memset(pBastet->pColScore, 0, nWidth * sizeof(int16_t));
+	memset(pBastet->nColScore, 0, nWidth * sizeof(int16_t));
 
 	// calculate the column heights of the actual bucket configuration
-	// NOTE: in this loop, pColScore stores the actual column heights,
+	// NOTE: in this loop, nColScore stores the actual column heights,
 	//       later it will contain the "score impact" of every unchanged column
 	for (int8_t y = nStartRow; y >= nStopRow; --y)
 	{
@@ -76,7 +76,7 @@ static void tetris_bastet_doPreprocessing(tetris_bastet_variant_t *pBastet)
 		{
 			if ((nDumpRow & nColMask) != 0)
 			{
-				pBastet->pColScore[x] = nStartRow - y + 1;
+				pBastet->nColScore[x] = nStartRow - y + 1;
 			}
 			nColMask <<= 1;
 		}
@@ -84,29 +84,29 @@ static void tetris_bastet_doPreprocessing(tetris_bastet_variant_t *pBastet)
 
 	// starting points for collision detection (to speedup things)
 	// calculate the maxima of the 4-tuples from column -3 to -1
-	pBastet->pStartingRow[0] = pBastet->pColScore[0];
-	pBastet->pStartingRow[1] = pBastet->pColScore[0] > pBastet->pColScore[1] ?
-			pBastet->pColScore[0] : pBastet->pColScore[1];
-	pBastet->pStartingRow[2] = pBastet->pStartingRow[1] > pBastet->pColScore[2]?
-			pBastet->pStartingRow[1] : pBastet->pColScore[2];
+	pBastet->nStartingRow[0] = pBastet->nColScore[0];
+	pBastet->nStartingRow[1] = pBastet->nColScore[0] > pBastet->nColScore[1] ?
+			pBastet->nColScore[0] : pBastet->nColScore[1];
+	pBastet->nStartingRow[2] = pBastet->nStartingRow[1] > pBastet->nColScore[2]?
+			pBastet->nStartingRow[1] : pBastet->nColScore[2];
 	// calculate the maxima of the 4-tuples from column 0 to width-1
 	for (uint8_t i = 0; i < nWidth; ++i)
 	{
 		// casting from int16_t to int8_t is safe here, since at this point
-		// pColScore only contains column heights which never exceed INT8_MAX-4
-		int8_t t0 = pBastet->pColScore[i] > pBastet->pColScore[i + 1] ?
-				pBastet->pColScore[i] : pBastet->pColScore[i + 1];
-		int8_t t1 = pBastet->pColScore[i + 2] > pBastet->pColScore[i + 3] ?
-				pBastet->pColScore[i + 2] : pBastet->pColScore[i + 3];
-		pBastet->pStartingRow[i + 3] = t0 > t1 ? t0 : t1;
+		// nColScore only contains column heights which never exceed INT8_MAX-4
+		int8_t t0 = pBastet->nColScore[i] > pBastet->nColScore[i + 1] ?
+				pBastet->nColScore[i] : pBastet->nColScore[i + 1];
+		int8_t t1 = pBastet->nColScore[i + 2] > pBastet->nColScore[i + 3] ?
+				pBastet->nColScore[i + 2] : pBastet->nColScore[i + 3];
+		pBastet->nStartingRow[i + 3] = t0 > t1 ? t0 : t1;
 	}
 
 	for (uint8_t i = nWidth + 3; i--;)
 	{
 		// normalize to bucket geometry
-		pBastet->pStartingRow[i] = nStartRow - pBastet->pStartingRow[i];
+		pBastet->nStartingRow[i] = nStartRow - pBastet->nStartingRow[i];
 		// finally calculate the score impact of every column
-		pBastet->pColScore[i] *= TETRIS_BASTET_HEIGHT_FACTOR;
+		pBastet->nColScore[i] *= TETRIS_BASTET_HEIGHT_FACTOR;
 	}
 }
 
@@ -138,7 +138,7 @@ static void tetris_bastet_predictColHeights(tetris_bastet_variant_t *pBastet,
 		{
 			if ((*pDump & nColMask) != 0)
 			{
-				pBastet->pColHeights[x] = nHeight;
+				pBastet->nColHeights[x] = nHeight;
 			}
 			nColMask <<= 1;
 		}
@@ -186,7 +186,7 @@ static int16_t tetris_bastet_evaluateMove(tetris_bastet_variant_t *pBastet,
 
 	// the row where the given piece collides
 	int8_t nDeepestRow = tetris_bucket_predictDeepestRow(pBastet->pBucket,
-			pPiece, pBastet->pStartingRow[nColumn + 3], nColumn);
+			pPiece, pBastet->nStartingRow[nColumn + 3], nColumn);
 
 	// in case the prediction fails we return the lowest possible score
 	if (nDeepestRow <= TETRIS_BUCKET_INVALID)
@@ -224,11 +224,11 @@ static int16_t tetris_bastet_evaluateMove(tetris_bastet_variant_t *pBastet,
 	{
 		if ((x >= nStartCol) && (x <= nStopCol))
 		{
-			nScore -= TETRIS_BASTET_HEIGHT_FACTOR * pBastet->pColHeights[x];
+			nScore -= TETRIS_BASTET_HEIGHT_FACTOR * pBastet->nColHeights[x];
 		}
 		else
 		{
-			nScore -= pBastet->pColScore[x];
+			nScore -= pBastet->nColScore[x];
 		}
 	}
 
@@ -245,27 +245,26 @@ static void tetris_bastet_evaluatePieces(tetris_bastet_variant_t *pBastet)
 	// precache actual column heights
 	tetris_bastet_doPreprocessing(pBastet);
 	int8_t nWidth = tetris_bucket_getWidth(pBastet->pBucket);
-	tetris_piece_t *pPiece = tetris_piece_construct(TETRIS_PC_LINE,
-			TETRIS_PC_ANGLE_0);
+	tetris_piece_t piece;
+	tetris_piece_construct(&piece, TETRIS_PC_LINE, TETRIS_PC_ANGLE_0);
 	for (uint8_t nBlock = TETRIS_PC_LINE; nBlock <= TETRIS_PC_Z; ++nBlock)
 	{
 		int16_t nMaxScore = INT16_MIN;
-		tetris_piece_setShape(pPiece, nBlock);
-		uint8_t nAngleCount = tetris_piece_getAngleCount(pPiece);
+		tetris_piece_setShape(&piece, nBlock);
+		uint8_t nAngleCount = tetris_piece_getAngleCount(&piece);
 		for (uint8_t nAngle = TETRIS_PC_ANGLE_0; nAngle < nAngleCount; ++nAngle)
 		{
-			tetris_piece_setAngle(pPiece, nAngle);
+			tetris_piece_setAngle(&piece, nAngle);
 			for (int8_t nCol = -3; nCol < nWidth; ++nCol)
 			{
 				int16_t nScore = tetris_bastet_evaluateMove(pBastet,
-						pPiece, nCol);
+						&piece, nCol);
 				nMaxScore = nMaxScore > nScore ? nMaxScore : nScore;
 			}
 		}
 		pBastet->nPieceScore[nBlock].shape = nBlock;
 		pBastet->nPieceScore[nBlock].nScore = nMaxScore;
 	}
-	tetris_piece_destruct(pPiece);
 }
 
 
@@ -299,7 +298,6 @@ void tetris_bastet(void)
 tetris_variant_t const tetrisBastetVariant =
 {
 	&tetris_bastet_construct,
-	&tetris_bastet_destruct,
 	&tetris_bastet_choosePiece,
 	&tetris_bastet_singleDrop,
 	&tetris_bastet_completeDrop,
@@ -318,36 +316,16 @@ tetris_variant_t const tetrisBastetVariant =
 };
 
 
-void *tetris_bastet_construct(tetris_bucket_t *pBucket)
+void tetris_bastet_construct(void *pVariantData,
+                             tetris_bucket_t *pBucket)
 {
+	assert(pVariantData != 0);
 	tetris_bastet_variant_t *pBastet =
-		(tetris_bastet_variant_t *) malloc(sizeof(tetris_bastet_variant_t));
+			(tetris_bastet_variant_t *)pVariantData;
 	memset(pBastet, 0, sizeof(tetris_bastet_variant_t));
 
 	pBastet->pBucket = pBucket;
-
-	size_t nWidth = (size_t)tetris_bucket_getWidth(pBastet->pBucket);
-	pBastet->pColScore = (int16_t*) calloc(nWidth + 3, sizeof(int16_t));
-	pBastet->pStartingRow = (int8_t*) calloc(nWidth + 3, sizeof(int8_t));
-	pBastet->pColHeights = (int8_t*) calloc(nWidth, sizeof(int8_t));
-
-	return pBastet;
-}
-
-
-void tetris_bastet_destruct(void *pVariantData)
-{
-	assert(pVariantData != 0);
-	tetris_bastet_variant_t *pBastetVariant =
-			(tetris_bastet_variant_t *)pVariantData;
-	free(pBastetVariant->pColScore);
-	free(pBastetVariant->pColHeights);
-	if (pBastetVariant->pPreviewPiece != NULL)
-	{
-		tetris_piece_destruct(pBastetVariant->pPreviewPiece);
-	}
-
-	free(pBastetVariant);
+	assert(tetris_bucket_getWidth(pBucket) <= TETRIS_BUCKET_MAX_COLUMNS);
 }
 
 
@@ -355,7 +333,7 @@ void tetris_bastet_destruct(void *pVariantData)
  * bastet related functions *
  ****************************/
 
-tetris_piece_t* tetris_bastet_choosePiece(void *pVariantData)
+tetris_piece_t tetris_bastet_choosePiece(void *pVariantData)
 {
 	assert(pVariantData != 0);
 	tetris_bastet_variant_t *pBastet =
@@ -374,15 +352,14 @@ tetris_piece_t* tetris_bastet_choosePiece(void *pVariantData)
 	tetris_bastet_sortPieces(pBastet);
 
 	// new "preview" piece (AKA "won't give you this one")
-	if (pBastet->pPreviewPiece != NULL)
-	{
-		tetris_piece_destruct(pBastet->pPreviewPiece);
-	}
-	pBastet->pPreviewPiece =
-			tetris_piece_construct(pBastet->nPieceScore[6].shape,
-					TETRIS_PC_ANGLE_0);
+	tetris_piece_construct(&pBastet->previewPiece,
+			pBastet->nPieceScore[6].shape, TETRIS_PC_ANGLE_0);
+	pBastet->bPreview = true;
 
-	tetris_piece_t *pPiece = NULL;
+	// the last threshold catches every random value, so this gets replaced
+	tetris_piece_t piece;
+	tetris_piece_construct(&piece, pBastet->nPieceScore[0].shape,
+			TETRIS_PC_ANGLE_0);
 	uint8_t const nPercent[4] = {191, 235, 250, 255};
 	uint8_t const nRnd = RANDOM8();
 	for (uint8_t i = 0; i < 4; ++i)
@@ -397,12 +374,11 @@ tetris_piece_t* tetris_bastet_choosePiece(void *pVariantData)
 				i += ((i == 0) ? 1 : -1);
 			}
 
-			pPiece = tetris_piece_construct(pBastet->nPieceScore[i].shape,
-						TETRIS_PC_ANGLE_0);
+			tetris_piece_setShape(&piece, pBastet->nPieceScore[i].shape);
 			break;
 		}
 	}
-	return pPiece;
+	return piece;
 }
 
 
@@ -510,7 +486,7 @@ tetris_piece_t* tetris_bastet_getPreviewPiece(void *pVariantData)
 	assert(pVariantData != 0);
 	tetris_bastet_variant_t *pBastetVariant =
 			(tetris_bastet_variant_t *)pVariantData;
-	return pBastetVariant->pPreviewPiece;
+	return pBastetVariant->bPreview ? &pBastetVariant->previewPiece : NULL;
 }
 
 
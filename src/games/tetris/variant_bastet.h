@@ -19,6 +19,7 @@
 #define VARIANT_BASTET_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "bearing.h"
 #include "piece.h"
 #include "highscore.h"
@@ -56,17 +57,21 @@ typedef struct tetris_bastet_variant_s
 	uint16_t nHighscoreName;                  /**< champion's initials */
 	uint8_t nLevel;                           /**< current level */
 	uint16_t nLines;                          /**< number of completed lines */
-	tetris_piece_t *pPreviewPiece;            /**< the piece for the preview */
+	tetris_piece_t previewPiece;              /**< the piece for the preview */
+	bool bPreview;                            /**< preview piece is valid */
 	tetris_bucket_t *pBucket;                 /**< bucket to be examined */
-	int16_t *pColScore;                       /**< score impact of each column*/
-	int8_t *pStartingRow;                     /**< starting point for
-	                                               collision detection */
-	int8_t *pColHeights;                      /**< predicted column heights */
+	int16_t nColScore[TETRIS_BUCKET_MAX_COLUMNS + 3]; /**< score impact of
+	                                                       each column */
+	int8_t nStartingRow[TETRIS_BUCKET_MAX_COLUMNS + 3]; /**< starting point
+	                                                         for collision
+	                                                         detection */
+	int8_t nColHeights[TETRIS_BUCKET_MAX_COLUMNS]; /**< predicted column
+	                                                    heights */
 	tetris_bastet_scorepair_t nPieceScore[7]; /**< score for every piece */
 }
 tetris_bastet_variant_t;
 
-tetris_variant_t const tetrisBastetVariant;
+extern tetris_variant_t const tetrisBastetVariant;
 
 
 /****************************
@@ -75,17 +80,11 @@ tetris_variant_t const tetrisBastetVariant;
 
 /**
  * constructs a bastet instance for a given bucket
+ * @param pVariantData pointer to the storage of the bastet instance
  * @param pBucket the bucket to be observed
- * @return pointer to a newly created bastet instance
  */
-void* tetris_bastet_construct(tetris_bucket_t *pBucket);
-
-
-/**
- * destructs the given bastet instance
- * @param pVariantData the bastet instance to be destroyed
- */
-void tetris_bastet_destruct(void *pVariantData);
+void tetris_bastet_construct(void *pVariantData,
+                             tetris_bucket_t *pBucket);
 
 
 /****************************
@@ -97,7 +96,7 @@ void tetris_bastet_destruct(void *pVariantData);
  * @param pVariantData the variant instance of interest
  * @return a tetris piece
  */
-tetris_piece_t* tetris_bastet_choosePiece(void *pBastet);
+tetris_piece_t tetris_bastet_choosePiece(void *pBastet);
 
 
 /**
@@ -66,7 +66,6 @@ void tetris_fp(void)
 tetris_variant_t const tetrisFpVariant =
 {
 	&tetris_std_construct,
-	&tetris_std_destruct,
 	&tetris_std_choosePiece,
 	&tetris_std_singleDrop,
 	&tetris_std_completeDrop,
@@ -74,7 +74,6 @@ void tetris(void)
 tetris_variant_t const tetrisStdVariant =
 {
 	&tetris_std_construct,
-	&tetris_std_destruct,
 	&tetris_std_choosePiece,
 	&tetris_std_singleDrop,
 	&tetris_std_completeDrop,
@@ -94,27 +93,16 @@ tetris_variant_t const tetrisStdVariant =
 #endif
 
 
-void *tetris_std_construct(tetris_bucket_t *pBucket)
-{
-	tetris_standard_variant_t *pStdVariant = (tetris_standard_variant_t *)
-			malloc(sizeof(tetris_standard_variant_t));
-	assert(pStdVariant != NULL);
-	memset(pStdVariant, 0, sizeof(tetris_standard_variant_t));
-	// don't begin with S and Z pieces according to official tetris guidelines
-	pStdVariant->pPreviewPiece =
-					tetris_piece_construct(RANDOM8() % 5, TETRIS_PC_ANGLE_0);
-
-	return pStdVariant;
-}
-
-
-void tetris_std_destruct(void *pVariantData)
+void tetris_std_construct(void *pVariantData,
+                          tetris_bucket_t *pBucket)
 {
 	assert(pVariantData != 0);
 	tetris_standard_variant_t *pStdVariant =
 			(tetris_standard_variant_t *)pVariantData;
-	tetris_piece_destruct(pStdVariant->pPreviewPiece);
-	free(pStdVariant);
+	memset(pStdVariant, 0, sizeof(tetris_standard_variant_t));
+	// don't begin with S and Z pieces according to official tetris guidelines
+	tetris_piece_construct(&pStdVariant->previewPiece, RANDOM8() % 5,
+			TETRIS_PC_ANGLE_0);
 }
 
 
@@ -123,15 +111,15 @@ void tetris_std_destruct(void *pVariantData)
  *****************************/
 
 
-tetris_piece_t* tetris_std_choosePiece(void *pVariantData)
+tetris_piece_t tetris_std_choosePiece(void *pVariantData)
 {
 	assert(pVariantData != 0);
 	tetris_standard_variant_t *pStdVariant =
 			(tetris_standard_variant_t *)pVariantData;
-	tetris_piece_t *pPiece = pStdVariant->pPreviewPiece;
-	pStdVariant->pPreviewPiece =
-			tetris_piece_construct(RANDOM8() % 7, TETRIS_PC_ANGLE_0);
-	return pPiece;
+	tetris_piece_t const piece = pStdVariant->previewPiece;
+	tetris_piece_construct(&pStdVariant->previewPiece, RANDOM8() % 7,
+			TETRIS_PC_ANGLE_0);
+	return piece;
 }
 
 
@@ -245,7 +233,7 @@ tetris_piece_t* tetris_std_getPreviewPiece(void *pVariantData)
 	assert(pVariantData != 0);
 	tetris_standard_variant_t *pStdVariant =
 			(tetris_standard_variant_t *)pVariantData;
-	return pStdVariant->pPreviewPiece;
+	return &pStdVariant->previewPiece;
 }
 
 
@@ -44,13 +44,13 @@ typedef struct tetris_standard_variant_s
 	uint16_t nHighscoreName;       /**< champion's initials */
 	uint8_t nLevel;                /**< current level */
 	uint16_t nLines;               /**< number of completed lines */
-	tetris_piece_t *pPreviewPiece; /**< the piece intended to be the next one */
+	tetris_piece_t previewPiece;   /**< the piece intended to be the next one */
 	tetris_bearing_t nBearing;     /**< bearing of the bucket */
 }
 tetris_standard_variant_t;
 
 
-tetris_variant_t const tetrisStdVariant;
+extern tetris_variant_t const tetrisStdVariant;
 
 
 /****************************
@@ -59,17 +59,11 @@ tetris_variant_t const tetrisStdVariant;
 
 /**
  * constructs a variant data object
+ * @param pVariantData pointer to the storage of the variant data object
  * @param pBucket related bucket object
- * @return pointer to a newly created variant data object
  */
-void *tetris_std_construct(tetris_bucket_t *pBucket);
-
-
-/**
- * destructs a variant data object
- * @param pVariantData pointer to a variant data object to be destructed
- */
-void tetris_std_destruct(void *pVariantData);
+void tetris_std_construct(void *pVariantData,
+                          tetris_bucket_t *pBucket);
 
 
 /*****************************
@@ -81,7 +75,7 @@ void tetris_std_destruct(void *pVariantData);
  * @param pVariantData the variant instance of interest
  * @return a tetris piece
  */
-tetris_piece_t* tetris_std_choosePiece(void *pVariantData);
+tetris_piece_t tetris_std_choosePiece(void *pVariantData);
 
 
 /**
@@ -29,17 +29,12 @@ typedef struct tetris_variant_s
 {
 	/**
 	 * constructs a variant data object
+	 * @param pVariantData pointer to the storage of the variant data object
+	 *                     (see tetris_variant_storage_t in tetris_main.c)
 	 * @param pBucket related bucket object
-	 * @return pointer to a newly created variant data object
 	 */
-	void* (*construct)(tetris_bucket_t *pBucket);
-
-
-	/**
-	 * destructs a variant data object
-	 * @param pVariantData pointer to a logic object to be destructed
-	 */
-	void (*destruct)(void *pVariantData);
+	void (*construct)(void *pVariantData,
+	                  tetris_bucket_t *pBucket);
 
 
 	/**
@@ -47,7 +42,7 @@ typedef struct tetris_variant_s
 	 * @param pVariantData the variant instance of interest
 	 * @return a tetris piece
 	 */
-	tetris_piece_t* (*choosePiece)(void *pVariantData);
+	tetris_piece_t (*choosePiece)(void *pVariantData);
 
 
 	/**
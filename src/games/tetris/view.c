@@ -71,6 +71,11 @@
 #endif
 
 
+#if TETRIS_VIEW_HEIGHT_DUMP > TETRIS_BUCKET_MAX_ROWS
+	#error TETRIS_BUCKET_MAX_ROWS is too small for the view
+#endif
+
+
 #if VIEWCOLS >= 16
 	#define TETRIS_VIEW_XOFFSET_DUMP         (((VIEWCOLS - 16) / 2) + 1)
 	#define TETRIS_VIEW_WIDTH_DUMP           10
@@ -102,6 +107,15 @@
 	#define TETRIS_VIEW_WIDTH_DUMP           VIEWCOLS
 #endif
 
+/** bit mask which covers a whole row of the dump */
+#define TETRIS_VIEW_MASK_DUMP ((uint16_t)((1ul << TETRIS_VIEW_WIDTH_DUMP) - 1))
+/** marks a cached dump row as invalid (it exceeds TETRIS_VIEW_MASK_DUMP) */
+#define TETRIS_VIEW_ROWMAP_INVALID 0xFFFFu
+
+#if TETRIS_VIEW_WIDTH_DUMP > 15
+	#error the dump is too wide for the row cache of the view
+#endif
+
 
 
 /***************************
@@ -148,6 +162,117 @@ static void tetris_view_setpixel(tetris_bearing_t nBearing,
 }
 
 
+/**
+ * writes some pixels of one frame buffer byte across all planes
+ * @param nPos offset of the byte within a plane
+ * @param nMask bits of the byte which should be written
+ * @param nBits bits which should be lit (must be a subset of nMask)
+ * @param nColor color of the lit pixels (0 <= nColor <= NUMPLANE)
+ */
+inline static void tetris_view_putByte(uint16_t const nPos,
+                                       uint8_t const nMask,
+                                       uint8_t const nBits,
+                                       uint8_t const nColor)
+{
+	for (uint8_t nPlane = 0; nPlane < NUMPLANE; ++nPlane)
+	{
+		uint8_t *const pByte = &pixmap[nPlane][0][nPos];
+		*pByte = (*pByte & ~nMask) | (nPlane < nColor ? nBits : 0);
+	}
+}
+
+
+/**
+ * draws a horizontal run of up to 16 view pixels in one go, bit 0 of the given
+ * bitmap belongs to the leftmost pixel, unset bits get cleared
+ * @param nBearing bearing of the view
+ * @param x x-coordinate of the leftmost pixel
+ * @param y y-coordinate of the run
+ * @param nWidth number of pixels (1 <= nWidth <= 16)
+ * @param nBitmap pixels which should be lit
+ * @param nColor color of the lit pixels
+ */
+static void tetris_view_blitRow(tetris_bearing_t nBearing,
+                                uint8_t x,
+                                uint8_t y,
+                                uint8_t nWidth,
+                                uint16_t nBitmap,
+                                uint8_t nColor)
+{
+	assert((nWidth > 0) && (nWidth <= 16));
+
+#ifdef VIEW_TILT
+	// tilt counter clockwise
+	nBearing = (nBearing + 3) % 4u;
+#endif
+
+	if (nColor > NUMPLANE)
+	{
+		nColor = NUMPLANE;
+	}
+
+	// see tetris_view_setpixel() for the underlying coordinate transformation
+	if ((nBearing == TETRIS_BEARING_90) || (nBearing == TETRIS_BEARING_270))
+	{
+		// the run becomes a screen column, so it's one bit in successive rows
+		uint8_t nScreenX;
+		uint8_t nScreenY;
+		int8_t nStep;
+		if (nBearing == TETRIS_BEARING_90)
+		{
+			nScreenX = y;
+			nScreenY = x;
+			nStep = LINEBYTES;
+		}
+		else
+		{
+			nScreenX = VIEWROWS - 1 - y;
+			nScreenY = VIEWCOLS - 1 - x;
+			nStep = -LINEBYTES;
+		}
+		uint8_t const nMask = shl_table[nScreenX % 8u];
+		uint16_t nPos = nScreenY * LINEBYTES + nScreenX / 8u;
+		for (; nWidth--; nBitmap >>= 1, nPos += nStep)
+		{
+			tetris_view_putByte(nPos, nMask, (nBitmap & 0x01) ? nMask : 0,
+					nColor);
+		}
+	}
+	else
+	{
+		// the run stays a screen row, which is mirrored for bearing 0
+		uint8_t nScreenX;
+		uint8_t nScreenY;
+		if (nBearing == TETRIS_BEARING_180)
+		{
+			nScreenX = x;
+			nScreenY = VIEWROWS - 1 - y;
+		}
+		else
+		{
+			uint16_t nMirror = 0;
+			for (uint8_t i = nWidth; i--; nBitmap >>= 1)
+			{
+				nMirror = (nMirror << 1) | (nBitmap & 0x01);
+			}
+			nBitmap = nMirror;
+			nScreenX = VIEWCOLS - x - nWidth;
+			nScreenY = y;
+		}
+
+		// align the run to the frame buffer bytes and write it byte by byte
+		uint8_t const nShift = nScreenX % 8u;
+		uint32_t nMask = (((uint32_t)1 << nWidth) - 1) << nShift;
+		uint32_t nBits = ((uint32_t)nBitmap << nShift) & nMask;
+		uint16_t nPos = nScreenY * LINEBYTES + nScreenX / 8u;
+		for (; nMask != 0; nMask >>= 8, nBits >>= 8, ++nPos)
+		{
+			tetris_view_putByte(nPos, (uint8_t)nMask, (uint8_t)nBits, nColor);
+		}
+	}
+}
+
+
 /**
  * draws a horizontal line
  * @param nBearing bearing of the view
@@ -212,7 +337,21 @@ inline static uint8_t tetris_view_getPieceColor(tetris_view_t *pV)
 
 
 /**
- * redraws the dump and the falling piece (if necessary)
+ * forces the dump to be redrawn completely on the next update
+ * @param pV pointer to the view whose dump should be redrawn
+ */
+static void tetris_view_invalidateDump(tetris_view_t *pV)
+{
+	for (uint8_t nRow = 0; nRow < TETRIS_VIEW_HEIGHT_DUMP; ++nRow)
+	{
+		pV->nRowMap[nRow] = TETRIS_VIEW_ROWMAP_INVALID;
+	}
+}
+
+
+/**
+ * redraws those rows of the dump and the falling piece which have changed
+ * since the last update
  * @param pV pointer to the view on which the dump should be drawn
  */
 static void tetris_view_drawDump(tetris_view_t *pV)
@@ -222,8 +361,14 @@ static void tetris_view_drawDump(tetris_view_t *pV)
 	{
 		return;
 	}
-	tetris_bearing_t const nBearing =
-			pV->pVariantMethods->getBearing(pV->pVariant);
+
+	// a changed piece color affects every row
+	uint8_t const nColor = tetris_view_getPieceColor(pV);
+	if (nColor != pV->nDumpColor)
+	{
+		pV->nDumpColor = nColor;
+		tetris_view_invalidateDump(pV);
+	}
 
 	for (int8_t nRow = TETRIS_VIEW_HEIGHT_DUMP - 1; nRow >= 0; --nRow)
 	{
@@ -248,14 +393,14 @@ static void tetris_view_drawDump(tetris_view_t *pV)
 					nPieceMap << nColumn : nPieceMap >> -nColumn;
 		}
 
-		uint16_t nElementMask = 0x0001;
-		for (uint8_t x = 0; x < TETRIS_VIEW_WIDTH_DUMP; ++x)
+		// only touch the frame buffer if the row looks different now
+		nRowMap &= TETRIS_VIEW_MASK_DUMP;
+		if (nRowMap != pV->nRowMap[nRow])
 		{
-			unsigned char nColor = (nRowMap & nElementMask) ?
-					tetris_view_getPieceColor(pV) : TETRIS_VIEW_COLORSPACE;
-			tetris_view_setpixel(nBearing, TETRIS_VIEW_XOFFSET_DUMP + x,
-					TETRIS_VIEW_YOFFSET_DUMP + (uint8_t)nRow, nColor);
-			nElementMask <<= 1;
+			pV->nRowMap[nRow] = nRowMap;
+			tetris_view_blitRow(pV->nBearing, TETRIS_VIEW_XOFFSET_DUMP,
+					TETRIS_VIEW_YOFFSET_DUMP + (uint8_t)nRow,
+					TETRIS_VIEW_WIDTH_DUMP, nRowMap, nColor);
 		}
 	}
 }
@@ -263,21 +408,16 @@ static void tetris_view_drawDump(tetris_view_t *pV)
 
 #ifdef TETRIS_VIEW_XOFFSET_PREVIEW
 /**
- * redraws the preview window
+ * redraws the preview window if its content has changed
  * @param pV pointer to the view on which the piece should be drawn
  * @param pPc pointer to the piece for the preview window (may be NULL)
  */
 static void tetris_view_drawPreviewPiece(tetris_view_t *pV,
-                                         tetris_piece_t *pPc)
+                                         tetris_piece_t const *pPc)
 {
-	tetris_bearing_t nBearing =
-			pV->pVariantMethods->getBearing(pV->pVariant);
-
+	uint16_t nPieceMap = 0;
 	if (pPc != NULL)
 	{
-		uint8_t nColor;
-		uint16_t nElementMask = 0x0001;
-		uint16_t nPieceMap;
 		if (pV->modeCurrent == TETRIS_VIMO_RUNNING)
 		{
 			nPieceMap = tetris_piece_getBitmap(pPc);
@@ -287,38 +427,16 @@ static void tetris_view_drawPreviewPiece(tetris_view_t *pV,
 			// an iconized "P"
 			nPieceMap = 0x26a6;
 		}
-
-		for (uint8_t y = 0; y < 4; ++y)
-		{
-			for (uint8_t x = 0; x < 4; ++x)
-			{
-				if ((nPieceMap & nElementMask) != 0)
-				{
-					nColor = TETRIS_VIEW_COLORPIECE;
-				}
-				else
-				{
-					nColor = TETRIS_VIEW_COLORSPACE;
-				}
-				tetris_view_setpixel(nBearing,
-						TETRIS_VIEW_XOFFSET_PREVIEW + x,
-						TETRIS_VIEW_YOFFSET_PREVIEW + y,
-						nColor);
-				nElementMask <<= 1;
-			}
-		}
 	}
-	else
+
+	if (pV->bRedraw || (nPieceMap != pV->nPreviewMap))
 	{
-		for (uint8_t y = 0; y < 4; ++y)
+		pV->nPreviewMap = nPieceMap;
+		for (uint8_t y = 0; y < 4; ++y, nPieceMap >>= 4)
 		{
-			for (uint8_t x = 0; x < 4; ++x)
-			{
-				tetris_view_setpixel(nBearing,
-						TETRIS_VIEW_XOFFSET_PREVIEW + x,
-						TETRIS_VIEW_YOFFSET_PREVIEW + y,
-						TETRIS_VIEW_COLORSPACE);
-			}
+			tetris_view_blitRow(pV->nBearing, TETRIS_VIEW_XOFFSET_PREVIEW,
+					TETRIS_VIEW_YOFFSET_PREVIEW + y, 4, nPieceMap & 0x000F,
+					TETRIS_VIEW_COLORPIECE);
 		}
 	}
 }
@@ -332,8 +450,7 @@ static void tetris_view_drawPreviewPiece(tetris_view_t *pV,
 static void tetris_view_drawBorders(tetris_view_t *pV,
                                     uint8_t nColor)
 {
-	tetris_bearing_t nBearing =
-			pV->pVariantMethods->getBearing(pV->pVariant);
+	tetris_bearing_t nBearing = pV->nBearing;
 
 #if TETRIS_VIEW_YOFFSET_DUMP != 0
 	// fill upper space if required
@@ -440,6 +557,8 @@ static void tetris_view_blinkBorders(tetris_view_t *pV)
 				TETRIS_VIEW_COLORBORDER : TETRIS_VIEW_COLORPIECE);
 		wait(TETRIS_VIEW_BORDER_BLINK_DELAY);
 	}
+	// restore the regular border color on the next update
+	pV->bRedraw = true;
 }
 
 
@@ -453,9 +572,6 @@ static void tetris_view_blinkLines(tetris_view_t *pV)
 	// reduce necessity of pointer arithmetic
 	int8_t nRow = tetris_bucket_getRow(pV->pBucket);
 
-	tetris_bearing_t nBearing =
-			pV->pVariantMethods->getBearing(pV->pVariant);
-
 	// don't try to draw below the border
 	int8_t nDeepestRowOffset = ((nRow + 3) < TETRIS_VIEW_HEIGHT_DUMP ?
 			3 : TETRIS_VIEW_HEIGHT_DUMP - (nRow + 1));
@@ -474,16 +590,12 @@ static void tetris_view_blinkLines(tetris_view_t *pV)
 				{
 					// draw line in current color
 					int8_t y = nRow + j;
-					for (int8_t x = tetris_bucket_getWidth(pV->pBucket); x--;)
-					{
-
-						uint8_t nColor = (nColIdx == 0 ? TETRIS_VIEW_COLORFADE
-								: TETRIS_VIEW_COLORPIECE);
-						tetris_view_setpixel(nBearing,
-								TETRIS_VIEW_XOFFSET_DUMP + (uint8_t)x,
-								TETRIS_VIEW_YOFFSET_DUMP + (uint8_t)y,
-								nColor);
-					}
+					uint8_t nColor = (nColIdx == 0 ? TETRIS_VIEW_COLORFADE
+							: TETRIS_VIEW_COLORPIECE);
+					tetris_view_blitRow(pV->nBearing, TETRIS_VIEW_XOFFSET_DUMP,
+							TETRIS_VIEW_YOFFSET_DUMP + (uint8_t)y,
+							TETRIS_VIEW_WIDTH_DUMP, TETRIS_VIEW_MASK_DUMP,
+							nColor);
 				}
 				nMask <<= 1;
 			}
@@ -491,22 +603,28 @@ static void tetris_view_blinkLines(tetris_view_t *pV)
 			wait(TETRIS_VIEW_LINE_BLINK_DELAY);
 		}
 	}
+
+	// the blinking lines have overwritten the cached state of the dump
+	tetris_view_invalidateDump(pV);
 }
 
 
 #ifdef TETRIS_VIEW_XOFFSET_COUNTER
 /**
- * draws counter of completed rows (0-399)
+ * draws counter of completed rows (0-399) if it has changed
  * @param pV pointer to the view
  */
 static void tetris_view_drawLineCounter(tetris_view_t *pV)
 {
+	tetris_bearing_t nBearing = pV->nBearing;
 
-	tetris_bearing_t nBearing =
-			pV->pVariantMethods->getBearing(pV->pVariant);
-
-	// get number of completed lines
+	// get number of completed lines, nothing to do if they haven't changed
 	uint16_t nLines = pV->pVariantMethods->getLines(pV->pVariant);
+	if (!pV->bRedraw && (nLines == pV->nLines))
+	{
+		return;
+	}
+	pV->nLines = nLines;
 
 	// get decimal places
 	uint8_t nOnes = nLines % 10;
@@ -573,15 +691,12 @@ static void tetris_view_formatHighscoreName(uint16_t nHighscoreName,
  * construction/destruction *
  ****************************/
 
-tetris_view_t *tetris_view_construct(tetris_variant_t const *const pVarMethods,
-                                     void *pVariantData,
-                                     tetris_bucket_t *pBucket)
+void tetris_view_construct(tetris_view_t *pView,
+                           tetris_variant_t const *const pVarMethods,
+                           void *pVariantData,
+                           tetris_bucket_t *pBucket)
 {
-	// memory allocation
-	assert((pVariantData != NULL) && (pBucket != NULL));
-	tetris_view_t *pView =
-		(tetris_view_t *) malloc(sizeof(tetris_view_t));
-	assert(pView != NULL);
+	assert((pView != NULL) && (pVariantData != NULL) && (pBucket != NULL));
 
 	// init
 	memset(pView, 0, sizeof(tetris_view_t));
@@ -589,12 +704,13 @@ tetris_view_t *tetris_view_construct(tetris_variant_t const *const pVarMethods,
 	pView->pVariant = pVariantData;
 	pView->pBucket = pBucket;
 	pView->modeCurrent = pView->modeOld = TETRIS_VIMO_RUNNING;
+	pView->nBearing = pVarMethods->getBearing(pVariantData);
+	pView->bRedraw = true;
+	tetris_view_invalidateDump(pView);
 
 	// drawing some first stuff
 	clear_screen(0);
 	tetris_view_drawBorders(pView, TETRIS_VIEW_COLORBORDER);
-
-	return pView;
 }
 
 
@@ -615,7 +731,19 @@ void tetris_view_update(tetris_view_t *pV)
 {
 	assert(pV != NULL);
 
-	tetris_view_drawBorders(pV, TETRIS_VIEW_COLORBORDER);
+	// a rotated view has to be redrawn completely
+	tetris_bearing_t const nBearing =
+			pV->pVariantMethods->getBearing(pV->pVariant);
+	if (nBearing != pV->nBearing)
+	{
+		pV->nBearing = nBearing;
+		pV->bRedraw = true;
+	}
+	if (pV->bRedraw)
+	{
+		tetris_view_drawBorders(pV, TETRIS_VIEW_COLORBORDER);
+		tetris_view_invalidateDump(pV);
+	}
 
 #ifdef TETRIS_VIEW_XOFFSET_PREVIEW
 	// draw preview piece
@@ -636,6 +764,7 @@ void tetris_view_update(tetris_view_t *pV)
 
 	// draw dump
 	tetris_view_drawDump(pV);
+	pV->bRedraw = false;
 
 	// visual feedback to inform about a level change
 	uint8_t nLevel = pV->pVariantMethods->getLevel(pV->pVariant);
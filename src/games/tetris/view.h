@@ -14,6 +14,7 @@
 #define TETRIS_VIEW_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "bearing.h"
 #include "bucket.h"
 #include "variants.h"
@@ -45,7 +46,12 @@ typedef struct tetris_view_s
 	tetris_view_mode_t modeCurrent;          /**< current presentation mode */
 	tetris_view_mode_t modeOld;              /**< old presentation mode */
 	uint8_t nOldLevel;                       /**< for detecting level changes */
-	tetris_bearing_t nBearing;               /**< bearing of the bucket */
+	tetris_bearing_t nBearing;               /**< bearing of the drawn view */
+	bool bRedraw;                            /**< everything must be redrawn */
+	uint8_t nDumpColor;                      /**< color of the drawn dump */
+	uint16_t nPreviewMap;                    /**< drawn preview bitmap */
+	uint16_t nLines;                         /**< drawn line counter value */
+	uint16_t nRowMap[TETRIS_BUCKET_MAX_ROWS]; /**< drawn dump rows */
 }
 tetris_view_t;
 
@@ -56,25 +62,15 @@ tetris_view_t;
 
 /**
  * constructs a view for André's borg
+ * @param pView pointer to the storage of the view
  * @param pVarMethods associated variant method pointers
  * @param pVariantData pointer to variant data object which should be observed
  * @param pBucket pointer to bucket which should be observed
- * @return pointer to a newly created view
  */
-tetris_view_t *tetris_view_construct(tetris_variant_t const *const pVarMethods,
-                                     void *pVariantData,
-                                     tetris_bucket_t *pBucket);
-
-
-/**
- * destructs a view
- * @param pView: pointer to the view to be destructed
- */
-inline static void tetris_view_destruct(tetris_view_t *pView)
-{
-	assert(pView != NULL);
-	free(pView);
-}
+void tetris_view_construct(tetris_view_t *pView,
+                           tetris_variant_t const *const pVarMethods,
+                           void *pVariantData,
+                           tetris_bucket_t *pBucket);
 
 
 /***************************
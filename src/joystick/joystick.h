@@ -131,4 +131,36 @@ void joy_init();
 
 #endif
 
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#	include <stdint.h>
+#	include "replay.h"
+
+	/**
+	 * Queries the joystick hardware directly.
+	 * @return Pressed directions and buttons (see REPLAY_FIRE etc.).
+	 */
+	inline static uint8_t joy_sample(void)
+	{
+		return (JOYISFIRE  ? REPLAY_FIRE  : 0) |
+		       (JOYISLEFT  ? REPLAY_LEFT  : 0) |
+		       (JOYISRIGHT ? REPLAY_RIGHT : 0) |
+		       (JOYISDOWN  ? REPLAY_DOWN  : 0) |
+		       (JOYISUP    ? REPLAY_UP    : 0);
+	}
+
+	// while recording or replaying, the sample of the current frame counts
+#	undef JOYISUP
+#	undef JOYISDOWN
+#	undef JOYISLEFT
+#	undef JOYISRIGHT
+#	undef JOYISFIRE
+#	define JOY_REPLAYED(bit) \
+		(((replay_mode != REPLAY_OFF) ? replay_joystick : joy_sample()) & (bit))
+#	define JOYISUP    JOY_REPLAYED(REPLAY_UP)
+#	define JOYISDOWN  JOY_REPLAYED(REPLAY_DOWN)
+#	define JOYISLEFT  JOY_REPLAYED(REPLAY_LEFT)
+#	define JOYISRIGHT JOY_REPLAYED(REPLAY_RIGHT)
+#	define JOYISFIRE  JOY_REPLAYED(REPLAY_FIRE)
+#endif
+
 #endif // JOYSTICK_H
@@ -0,0 +1,211 @@
+/**
+ * @file replay.c
+ * @brief Records the joystick input of a game and replays it later on.
+ *
+ * The log lives in the EEPROM and consists of (sample, frame count) pairs,
+ * terminated by a pair with a frame count of 0. The magic word gets written
+ * last, so an interrupted recording never passes for a complete one. While
+ * recording, the pairs are collected in RAM and only get written to the
+ * EEPROM by replay_stop(), so the game doesn't stall on EEPROM writes.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <setjmp.h>
+
+#include "../config.h"
+#include "../compat/eeprom.h"
+#include "../util.h"
+#include "joystick.h"
+#include "replay.h"
+
+#ifdef RANDOM_SUPPORT
+#	include "../random/prng.h"
+#else
+#	include <stdlib.h>
+#endif
+
+/** marks a complete recording */
+#define REPLAY_MAGIC 0x5250u
+
+/** number of log bytes which may be occupied by (sample, count) pairs */
+#define REPLAY_LOG_PAIRS_END (JOYSTICK_REPLAY_LOG_SIZE - 2u)
+
+#if JOYSTICK_REPLAY_LOG_SIZE < 4
+#	error JOYSTICK_REPLAY_LOG_SIZE must be at least 4 bytes
+#endif
+
+
+/** layout of a recording within the EEPROM, see REPLAY_EEPROM_SIZE */
+typedef struct replay_log_s
+{
+	uint16_t nMagic;                          /**< REPLAY_MAGIC if complete */
+	uint16_t nSeedLow;                        /**< lower half of the seed */
+	uint16_t nSeedHigh;                       /**< upper half of the seed */
+	uint8_t nGame;                            /**< number of the game */
+	uint8_t nLog[JOYSTICK_REPLAY_LOG_SIZE];   /**< (sample, count) pairs */
+}
+replay_log_t;
+
+replay_log_t EEMEM replay_log;
+
+//this buffer is declared in main
+extern jmp_buf newmode_jmpbuf;
+
+replay_mode_t replay_mode = REPLAY_OFF;
+uint8_t replay_joystick;
+
+/** position of the next (sample, count) pair within the log */
+static uint16_t replay_nPos;
+/** frames left for the current sample (playback) or seen so far (record) */
+static uint8_t replay_nCount;
+/** seed of the recording, gets written by replay_stop() */
+static uint32_t replay_nSeed;
+/** game of the recording, gets written by replay_stop() */
+static uint8_t replay_nGame;
+/** (sample, count) pairs of the recording, get written by replay_stop() */
+static uint8_t replay_anLog[JOYSTICK_REPLAY_LOG_SIZE];
+
+
+static void replay_restartRandom(uint32_t const nSeed)
+{
+#ifdef RANDOM_SUPPORT
+	random_restart(nSeed);
+#else
+	srand(nSeed);
+#endif
+}
+
+
+static void replay_appendPair(uint8_t const nSample,
+                              uint8_t const nCount)
+{
+	replay_anLog[replay_nPos++] = nSample;
+	replay_anLog[replay_nPos++] = nCount;
+}
+
+
+/**
+ * Appends the pending pair to the log. Samples which don't fit anymore are
+ * dropped, so the replay of an overlong game ends early.
+ */
+static void replay_flush(void)
+{
+	if ((replay_nCount != 0) && (replay_nPos + 2u <= REPLAY_LOG_PAIRS_END))
+	{
+		replay_appendPair(replay_joystick, replay_nCount);
+	}
+	replay_nCount = 0;
+}
+
+
+static void replay_save(void)
+{
+	// invalidate the previous recording
+	eeprom_busy_wait();
+	eeprom_write_word(&replay_log.nMagic, 0xFFFFu);
+
+	eeprom_busy_wait();
+	eeprom_write_word(&replay_log.nSeedLow, (uint16_t)replay_nSeed);
+	eeprom_busy_wait();
+	eeprom_write_word(&replay_log.nSeedHigh, (uint16_t)(replay_nSeed >> 16));
+	eeprom_busy_wait();
+	eeprom_update_byte(&replay_log.nGame, replay_nGame);
+	eeprom_busy_wait();
+	eeprom_update_block(replay_anLog, replay_log.nLog, replay_nPos);
+
+	eeprom_busy_wait();
+	eeprom_write_word(&replay_log.nMagic, REPLAY_MAGIC);
+}
+
+
+void replay_record(uint8_t nGame)
+{
+	replay_stop();
+
+#ifdef RANDOM_SUPPORT
+	replay_nSeed = random32();
+#else
+	replay_nSeed = get_tick();
+#endif
+	replay_nGame = nGame;
+	replay_restartRandom(replay_nSeed);
+
+	replay_nPos = 0;
+	replay_nCount = 0;
+	replay_joystick = 0;
+	replay_mode = REPLAY_RECORD;
+}
+
+
+bool replay_play(replay_mode_t nMode,
+                 uint8_t *pGame)
+{
+	replay_stop();
+
+	if (eeprom_read_word(&replay_log.nMagic) != REPLAY_MAGIC)
+	{
+		return false;
+	}
+
+	*pGame = eeprom_read_byte(&replay_log.nGame);
+	replay_restartRandom(eeprom_read_word(&replay_log.nSeedLow) |
+		((uint32_t)eeprom_read_word(&replay_log.nSeedHigh) << 16));
+
+	replay_nPos = 0;
+	replay_nCount = 0;
+	replay_joystick = 0;
+	replay_mode = nMode;
+	return true;
+}
+
+
+void replay_stop(void)
+{
+	// a game without any logged input leaves the previous recording alone
+	if ((replay_mode == REPLAY_RECORD) && (replay_nPos != 0))
+	{
+		replay_flush();
+		replay_appendPair(0, 0);
+		replay_save();
+	}
+	replay_mode = REPLAY_OFF;
+}
+
+
+void replay_frame(void)
+{
+	if (replay_mode == REPLAY_RECORD)
+	{
+		uint8_t const nSample = joy_sample();
+		if ((nSample != replay_joystick) || (replay_nCount == UINT8_MAX))
+		{
+			replay_flush();
+			replay_joystick = nSample;
+		}
+		++replay_nCount;
+	}
+	else if (replay_mode != REPLAY_OFF)
+	{
+		// a replay gets interrupted by the (real) fire button
+		if (joy_sample() & REPLAY_FIRE)
+		{
+			replay_stop();
+			longjmp(newmode_jmpbuf, 0xFEu);
+		}
+
+		if (replay_nCount == 0)
+		{
+			replay_joystick = eeprom_read_byte(&replay_log.nLog[replay_nPos++]);
+			replay_nCount = eeprom_read_byte(&replay_log.nLog[replay_nPos++]);
+
+			// end of the log, continue with the animations
+			if (replay_nCount == 0)
+			{
+				replay_stop();
+				longjmp(newmode_jmpbuf, 0xFDu);
+			}
+		}
+		--replay_nCount;
+	}
+}
@@ -0,0 +1,106 @@
+/**
+ * @file replay.h
+ * @brief Records the joystick input of a game and replays it later on.
+ *
+ * While a game is recorded or replayed, the joystick is sampled only once per
+ * frame, i.e. whenever the game calls wait(). The JOYIS* macros return the
+ * sample of the current frame instead of querying the hardware. Recording
+ * logs the samples (run-length encoded) in RAM and saves them along with the
+ * seed of the random number generator into the EEPROM once the game is over.
+ * A replay restarts the generator with that seed
+ * and feeds the logged samples back, so the game runs bit-identically. Fast
+ * replays skip the delays of wait(), which makes real gameplay sessions
+ * reproducible for profiling.
+ */
+
+#ifndef JOYSTICK_REPLAY_H_
+#define JOYSTICK_REPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../config.h"
+
+#ifndef JOYSTICK_REPLAY_LOG_SIZE
+#	define JOYSTICK_REPLAY_LOG_SIZE 256
+#endif
+
+/** EEPROM bytes taken by a recording (header and log) */
+#define REPLAY_EEPROM_SIZE (7u + JOYSTICK_REPLAY_LOG_SIZE)
+
+/** joystick bits of a sample (same layout as the simulator's fakeport) */
+#define REPLAY_FIRE  0x01u
+#define REPLAY_LEFT  0x02u
+#define REPLAY_RIGHT 0x04u
+#define REPLAY_DOWN  0x08u
+#define REPLAY_UP    0x10u
+
+
+/** what the replay module is currently doing */
+enum replay_mode_e
+{
+	REPLAY_OFF,       /**< joystick queries go straight to the hardware */
+	REPLAY_RECORD,    /**< the hardware gets sampled and logged */
+	REPLAY_PLAY,      /**< logged samples are replayed in real time */
+	REPLAY_PLAY_FAST, /**< logged samples are replayed as fast as possible */
+	REPLAY_DEMO       /**< like REPLAY_PLAY, started by the display loop */
+};
+#ifdef NDEBUG
+	typedef uint8_t replay_mode_t;
+#else
+	typedef enum replay_mode_e replay_mode_t;
+#endif
+
+
+/** current mode of the replay module */
+extern replay_mode_t replay_mode;
+
+/** joystick sample of the current frame (see REPLAY_FIRE etc.) */
+extern uint8_t replay_joystick;
+
+
+/**
+ * Starts recording a game. The random number generator gets restarted from a
+ * fresh seed which is saved along with the game number. The previous
+ * recording is only replaced if the first pair of the log is complete, so a
+ * game which is left right away doesn't wear the EEPROM.
+ * @param nGame Number of the game (e.g. its index in the menu).
+ */
+void replay_record(uint8_t nGame);
+
+
+/**
+ * Starts replaying the last recorded game.
+ * @param nMode REPLAY_PLAY, REPLAY_PLAY_FAST or REPLAY_DEMO.
+ * @param pGame Receives the number of the recorded game.
+ * @return false if there is no complete recording.
+ */
+bool replay_play(replay_mode_t nMode,
+                 uint8_t *pGame);
+
+
+/**
+ * Finishes a recording or replay. A recording gets saved to the EEPROM, which
+ * takes a few ms per changed byte. Does nothing if neither is active.
+ */
+void replay_stop(void);
+
+
+/**
+ * Advances to the next frame, gets called by wait(). If the log of a replay
+ * is exhausted, the replay is stopped and the display loop continues with
+ * the first animation. The (real) fire button interrupts a replay and leads
+ * to the menu.
+ */
+void replay_frame(void);
+
+
+/**
+ * Tells whether wait() should skip its delay.
+ * @return true during fast replays.
+ */
+inline static bool replay_isFast(void)
+{
+	return replay_mode == REPLAY_PLAY_FAST;
+}
+
+#endif /* JOYSTICK_REPLAY_H_ */
@@ -0,0 +1,275 @@
+/**
+ * @file kvstore.c
+ * @brief Small log-structured key-value store for persistent settings.
+ *
+ * Layout of a bank:
+ *   magic, generation, record, record, ..., KV_FREE
+ * Layout of a record:
+ *   key, length, value[length], checksum
+ * Of two valid banks, the one with the newer generation is the active one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "config.h"
+#include "compat/eeprom.h"
+#include "kvstore.h"
+
+/** size of one of the two banks */
+#define KV_BANK_SIZE (KVSTORE_SIZE / 2)
+
+#if KV_BANK_SIZE > 256
+#	error KVSTORE_SIZE must not exceed 512 bytes
+#elif KV_BANK_SIZE < 32
+#	error KVSTORE_SIZE must be at least 64 bytes
+#endif
+
+/** first byte of a valid bank */
+#define KV_MAGIC 0x4Bu
+/** key byte of the unused space behind the last record */
+#define KV_FREE 0xFFu
+/** offset of the first record within a bank */
+#define KV_HEADER_SIZE 2u
+/** key, length and checksum of a record */
+#define KV_RECORD_OVERHEAD 3u
+/** marks kv_nBank before kv_init() has been run */
+#define KV_NO_BANK 0xFFu
+
+
+static uint8_t kv_banks[2][KV_BANK_SIZE] EEMEM;
+
+/** the bank which holds the current values */
+static uint8_t kv_nBank = KV_NO_BANK;
+/** generation of the active bank */
+static uint8_t kv_nGeneration;
+/** offset of the first unused byte of the active bank */
+static uint16_t kv_nTail;
+/** offset of the latest record for each key, 0 if there is none */
+static uint8_t kv_anIndex[KV_KEY_COUNT];
+
+
+static uint8_t kv_read(uint8_t nBank,
+                       uint16_t nOffset)
+{
+	eeprom_busy_wait();
+	return eeprom_read_byte(&kv_banks[nBank][nOffset]);
+}
+
+
+static void kv_write(uint8_t nBank,
+                     uint16_t nOffset,
+                     uint8_t nValue)
+{
+	eeprom_busy_wait();
+	eeprom_update_byte(&kv_banks[nBank][nOffset], nValue);
+}
+
+
+static uint8_t kv_checksum(uint8_t nSum,
+                           uint8_t nByte)
+{
+	return (uint8_t)((nSum << 1) | (nSum >> 7)) + nByte;
+}
+
+
+/**
+ * Walks through the records of the active bank and remembers the latest
+ * one for each key. Records with a wrong checksum or an unknown key (e.g.
+ * written by a newer firmware) are skipped.
+ */
+static void kv_scan(void)
+{
+	memset(kv_anIndex, 0, sizeof(kv_anIndex));
+
+	uint16_t nPos = KV_HEADER_SIZE;
+	while ((nPos + KV_RECORD_OVERHEAD) <= KV_BANK_SIZE)
+	{
+		uint8_t const nKey = kv_read(kv_nBank, nPos);
+		if (nKey == KV_FREE)
+		{
+			break;
+		}
+
+		uint8_t const nLength = kv_read(kv_nBank, nPos + 1);
+		uint16_t const nNext = nPos + KV_RECORD_OVERHEAD + nLength;
+		if (nNext > KV_BANK_SIZE)
+		{
+			break;
+		}
+
+		uint8_t nSum = kv_checksum(kv_checksum(0, nKey), nLength);
+		uint16_t i;
+		for (i = nPos + 2; i < (nNext - 1); ++i)
+		{
+			nSum = kv_checksum(nSum, kv_read(kv_nBank, i));
+		}
+		if ((nSum == kv_read(kv_nBank, nNext - 1)) && (nKey < KV_KEY_COUNT))
+		{
+			kv_anIndex[nKey] = nPos;
+		}
+		nPos = nNext;
+	}
+	kv_nTail = nPos;
+}
+
+
+/**
+ * Copies the latest record of every key to the other bank and activates it.
+ */
+static void kv_compact(void)
+{
+	uint8_t const nTarget = kv_nBank ^ 1u;
+
+	// the target must not be mistaken for a valid bank until it is complete
+	kv_write(nTarget, 0, KV_FREE);
+
+	uint16_t nPos = KV_HEADER_SIZE;
+	uint8_t nKey;
+	for (nKey = 0; nKey < KV_KEY_COUNT; ++nKey)
+	{
+		uint8_t const nSource = kv_anIndex[nKey];
+		if (nSource != 0)
+		{
+			uint16_t const nSize =
+				kv_read(kv_nBank, nSource + 1) + KV_RECORD_OVERHEAD;
+			uint16_t i;
+			for (i = 0; i < nSize; ++i)
+			{
+				kv_write(nTarget, nPos + i, kv_read(kv_nBank, nSource + i));
+			}
+			kv_anIndex[nKey] = nPos;
+			nPos += nSize;
+		}
+	}
+	if (nPos < KV_BANK_SIZE)
+	{
+		kv_write(nTarget, nPos, KV_FREE);
+	}
+
+	kv_nGeneration = (kv_nGeneration + 1u) % 0xFFu;
+	kv_write(nTarget, 1, kv_nGeneration);
+	kv_write(nTarget, 0, KV_MAGIC);
+	kv_nBank = nTarget;
+	kv_nTail = nPos;
+}
+
+
+void kv_init(void)
+{
+	bool abValid[2];
+	uint8_t anGeneration[2];
+	uint8_t nBank;
+	for (nBank = 0; nBank < 2; ++nBank)
+	{
+		anGeneration[nBank] = kv_read(nBank, 1);
+		abValid[nBank] = (kv_read(nBank, 0) == KV_MAGIC) &&
+			(anGeneration[nBank] != 0xFFu);
+	}
+
+	if (abValid[0] && abValid[1])
+	{
+		// generations wrap around, the newer one is just one step ahead
+		kv_nBank = ((int8_t)(anGeneration[1] - anGeneration[0]) > 0) ? 1 : 0;
+	}
+	else if (abValid[0] || abValid[1])
+	{
+		kv_nBank = abValid[0] ? 0 : 1;
+	}
+	else
+	{
+		// blank (or erased) EEPROM
+		kv_nBank = 0;
+		anGeneration[0] = 0;
+		kv_write(0, KV_HEADER_SIZE, KV_FREE);
+		kv_write(0, 1, 0);
+		kv_write(0, 0, KV_MAGIC);
+	}
+	kv_nGeneration = anGeneration[kv_nBank];
+	kv_scan();
+}
+
+
+uint8_t kv_get(kv_key_t nKey,
+               void *pValue,
+               uint8_t nLength)
+{
+	if (kv_nBank == KV_NO_BANK)
+	{
+		kv_init();
+	}
+	if ((nKey >= KV_KEY_COUNT) || (kv_anIndex[nKey] == 0))
+	{
+		return 0;
+	}
+
+	uint8_t const nPos = kv_anIndex[nKey];
+	uint8_t const nStored = kv_read(kv_nBank, nPos + 1);
+	eeprom_busy_wait();
+	eeprom_read_block(pValue, &kv_banks[kv_nBank][nPos + 2],
+		nStored < nLength ? nStored : nLength);
+	return nStored;
+}
+
+
+bool kv_set(kv_key_t nKey,
+            void const *pValue,
+            uint8_t nLength)
+{
+	if (kv_nBank == KV_NO_BANK)
+	{
+		kv_init();
+	}
+	if (nKey >= KV_KEY_COUNT)
+	{
+		return false;
+	}
+
+	uint8_t const *pBytes = pValue;
+	uint8_t i;
+
+	// an unchanged value doesn't cost a write
+	uint8_t const nOld = kv_anIndex[nKey];
+	if ((nOld != 0) && (kv_read(kv_nBank, nOld + 1) == nLength))
+	{
+		for (i = 0; (i < nLength) && (kv_read(kv_nBank, nOld + 2 + i) ==
+				pBytes[i]); ++i);
+		if (i == nLength)
+		{
+			return true;
+		}
+	}
+
+	uint16_t const nSize = nLength + KV_RECORD_OVERHEAD;
+	if ((kv_nTail + nSize) > KV_BANK_SIZE)
+	{
+		kv_compact();
+		if ((kv_nTail + nSize) > KV_BANK_SIZE)
+		{
+			return false;
+		}
+	}
+
+	uint8_t nSum = kv_checksum(kv_checksum(0, nKey), nLength);
+	for (i = 0; i < nLength; ++i)
+	{
+		nSum = kv_checksum(nSum, pBytes[i]);
+	}
+
+	// the key gets written last, so the record stays invisible until complete
+	uint16_t const nPos = kv_nTail;
+	kv_write(kv_nBank, nPos + 1, nLength);
+	eeprom_busy_wait();
+	eeprom_update_block(pValue, &kv_banks[kv_nBank][nPos + 2], nLength);
+	kv_write(kv_nBank, nPos + nSize - 1, nSum);
+	if ((nPos + nSize) < KV_BANK_SIZE)
+	{
+		kv_write(kv_nBank, nPos + nSize, KV_FREE);
+	}
+	kv_write(kv_nBank, nPos, nKey);
+
+	kv_anIndex[nKey] = nPos;
+	kv_nTail = nPos + nSize;
+	return true;
+}
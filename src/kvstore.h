@@ -0,0 +1,76 @@
+/**
+ * @file kvstore.h
+ * @brief Small log-structured key-value store for persistent settings.
+ *
+ * The store occupies two equally sized banks in the EEPROM. Every update
+ * appends a record (key, length, value, checksum) to the active bank, so
+ * the writes wander through the whole bank instead of hammering a single
+ * cell. If the active bank runs full, the current value of every key gets
+ * copied to the other bank, which then takes over. A record only becomes
+ * visible once its key byte, written last, is in place, and a bank only
+ * becomes active once its header is written after the copy. Therefore an
+ * update interrupted by a power loss leaves the previous value intact.
+ *
+ * The bank is scanned once at startup to build an index in RAM which maps
+ * every key to its latest record.
+ */
+
+#ifndef KVSTORE_H_
+#define KVSTORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+#ifndef KVSTORE_SIZE
+#	define KVSTORE_SIZE 256
+#endif
+
+
+/** keys of the values in the store, append new keys at the end */
+enum kv_key_e
+{
+	KV_RESET_COUNTER,       /**< number of resets (uint32_t), seeds the PRNG */
+	KV_TETRIS_HIGHSCORE,    /**< high score of the first Tetris variant */
+	KV_TETRIS_HIGHSCORE_END = KV_TETRIS_HIGHSCORE + 4, /**< one per variant */
+	KV_KEY_COUNT            /**< number of keys */
+};
+#ifdef NDEBUG
+	typedef uint8_t kv_key_t;
+#else
+	typedef enum kv_key_e kv_key_t;
+#endif
+
+
+/**
+ * Finds the active bank and builds the index. Gets called implicitly by the
+ * first access, but may be called again to pick up an erased EEPROM.
+ */
+void kv_init(void);
+
+
+/**
+ * Reads a value from the store.
+ * @param nKey key of the value
+ * @param pValue buffer which receives the value
+ * @param nLength size of the buffer, longer values get truncated
+ * @return length of the stored value, 0 if there is none
+ */
+uint8_t kv_get(kv_key_t nKey,
+               void *pValue,
+               uint8_t nLength);
+
+
+/**
+ * Writes a value to the store. Nothing is written if the stored value is
+ * already the same.
+ * @param nKey key of the value
+ * @param pValue the value
+ * @param nLength length of the value
+ * @return false if the value doesn't fit into the store
+ */
+bool kv_set(kv_key_t nKey,
+            void const *pValue,
+            uint8_t nLength);
+
+#endif /* KVSTORE_H_ */
@@ -7,10 +7,10 @@
 #include "config.h"
 #include "borg_hw/borg_hw.h"
 // #include "can/borg_can.h"
-#include "random/prng.h"
-#include "random/persistentCounter.h"
+#include "boot.h"
 #include "display_loop.h"
 #include "pixel.h"
+#include "util.h"
 
 #ifdef JOYSTICK_SUPPORT
 	#include "joystick/joystick.h"
@@ -24,23 +24,12 @@
 #    include "uart/uart.h"
 #endif
 
-#ifdef RFM12_SUPPORT
-	#include "rfm12/borg_rfm12.h"
-#endif
-
 int main (void){
 	clear_screen(0);
 
-#ifdef RANDOM_SUPPORT
-	srandom32(percnt_get(&g_reset_counter, &g_reset_counter_idx));
-	percnt_inc(&g_reset_counter, &g_reset_counter_idx);
-#endif
-
-#ifdef RFM12_SUPPORT
-	borg_rfm12_init();
-#endif
-
+	// only what the first frame needs, boot_service() does the rest
 	borg_hw_init();
+	tick_init();
 
 #ifdef CAN_SUPPORT
 	bcan_init();
@@ -54,6 +43,8 @@ int main (void){
 	joy_init();	
 #endif
 
+	boot_init();
+
 	sei();
 
 	display_loop();
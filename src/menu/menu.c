@@ -15,6 +15,9 @@
 #include "../util.h"
 #include "../pixel.h"
 #include "../joystick/joystick.h"
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#  include "../joystick/replay.h"
+#endif
 
 
 extern game_descriptor_t _game_descriptors_start__[];
@@ -26,6 +29,8 @@ extern game_descriptor_t _game_descriptors_end__[];
 #define MENU_WIDTH_ICON 8
 #define MENU_HEIGHT_ICON 8
 #define MENU_WIDTH_DELIMITER 2
+#define MENU_WIDTH_ITEM (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)
+#define MENU_STRIP_LENGTH ((uint16_t)MENU_ITEM_MAX * MENU_WIDTH_ITEM)
 #define MENU_POLL_INTERVAL 10
 #define MENU_TIMEOUT_ITERATIONS 2000
 #define MENU_WAIT_CHATTER 60
@@ -50,37 +55,34 @@ enum menu_direction
 
 
 
-static void menu_setpixel(uint8_t x, uint8_t y, uint8_t isSet)
-{
-	uint8_t nColor;
+// icon strip in display coordinates, one bit per column (like the pixmap)
+static uint8_t menu_strip[MENU_HEIGHT_ICON][LINEBYTES];
 
-	// mirror mirror on the wall, what's the quirkiest API of them all...
-	x = NUM_COLS - 1 - x;
+// columns of the strip which are lit on the corresponding plane
+static uint8_t menu_bands[NUMPLANE][LINEBYTES];
+
+// position of the leftmost menu column on the endless band of icons
+static uint16_t menu_nStripPos;
+
+
+static uint8_t menu_getBandColor(uint8_t x)
+{
 	uint8_t nMiddle = (NUM_COLS - MENU_WIDTH_ICON) / 2;
 
-	if (isSet != 0)
+	if ((x >= nMiddle - MENU_WIDTH_DELIMITER) && (x < (nMiddle
+	        + MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)))
 	{
-		if ((x >= nMiddle - MENU_WIDTH_DELIMITER) && (x < (nMiddle
-		        + MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)))
-		{
-			nColor = 3;
-		}
-		else if ((x == (nMiddle - MENU_WIDTH_DELIMITER - 1)) || (x == (nMiddle
-		        + MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)))
-		{
-			nColor = 2;
-		}
-		else
-		{
-			nColor = 1;
-		}
+		return 3;
+	}
+	else if ((x == (nMiddle - MENU_WIDTH_DELIMITER - 1)) || (x == (nMiddle
+	        + MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)))
+	{
+		return 2;
 	}
 	else
 	{
-		nColor = 0;
+		return 1;
 	}
-
-	setpixel((pixel){x, y}, nColor);
 }
 
 
@@ -101,80 +103,137 @@ static uint8_t menu_getIconPixel(uint8_t item, uint8_t x, uint8_t y)
 }
 
 
-static void menu_animate(uint8_t miInitial, menu_direction_t direction)
+static void menu_setStripColumn(uint8_t x, uint16_t nPos)
 {
-	int16_t nWait = MENU_WAIT_INITIAL;
+	// mirror mirror on the wall, what's the quirkiest API of them all...
+	x = NUM_COLS - 1 - x;
+
+	uint8_t const item = nPos / MENU_WIDTH_ITEM;
+	uint8_t const nOffset = nPos % MENU_WIDTH_ITEM;
+	uint8_t const nMask = shl_table[x % 8];
+	uint8_t y;
+	for (y = 0; y < MENU_HEIGHT_ICON; ++y)
+	{
+		if (menu_getIconPixel(item, nOffset, y))
+		{
+			menu_strip[y][x / 8] |= nMask;
+		}
+		else
+		{
+			menu_strip[y][x / 8] &= ~nMask;
+		}
+	}
+}
+
 
+/**
+ * Assembles the icon strip (and its color bands) with the given item in the
+ * middle. This is the only place where all icons get read, the animation
+ * just shifts the strip and fetches the column which scrolls in.
+ * @param miCenter item in the middle of the strip
+ */
+static void menu_buildStrip(uint8_t miCenter)
+{
 	// space between left border and the icon in the middle
-	uint8_t nWidthSide = (NUM_COLS - MENU_WIDTH_ICON) / 2;
+	uint8_t const nWidthSide = (NUM_COLS - MENU_WIDTH_ICON) / 2;
+
+	menu_nStripPos = ((uint16_t)miCenter * MENU_WIDTH_ITEM + MENU_STRIP_LENGTH
+	        - (nWidthSide % MENU_STRIP_LENGTH)) % MENU_STRIP_LENGTH;
 
-	// determine the icon at the leftmost position
-	uint8_t mi = miInitial + MENU_ITEM_MAX;
-	uint8_t nBack = nWidthSide / (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER);
-	if ((nWidthSide % (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)) != 0)
+	uint8_t x, plane;
+	for (x = 0; x < NUM_COLS; ++x)
 	{
-		++nBack;
+		menu_setStripColumn(x, (menu_nStripPos + x) % MENU_STRIP_LENGTH);
+
+		uint8_t const nColor = menu_getBandColor(x);
+		for (plane = 0; plane < NUMPLANE; ++plane)
+		{
+			if (plane < nColor)
+			{
+				menu_bands[plane][x / 8] |= shl_table[x % 8];
+			}
+			else
+			{
+				menu_bands[plane][x / 8] &= ~shl_table[x % 8];
+			}
+		}
 	}
-	mi = (mi + MENU_ITEM_MAX - (nBack % MENU_ITEM_MAX)) % MENU_ITEM_MAX;
+}
+
 
-	// start and stop offsets for the scrolling icons (both are 0 for stills)
-	uint8_t nStart, nStop;
-	if (direction == MENU_DIRECTION_STILL)
+/**
+ * Scrolls the icon strip by one column.
+ * @param direction MENU_DIRECTION_LEFT or MENU_DIRECTION_RIGHT
+ */
+static void menu_shiftStrip(menu_direction_t direction)
+{
+	uint8_t y, i;
+
+	// the display is mirrored, so scrolling to the left means shifting the
+	// strip towards higher display columns
+	if (direction == MENU_DIRECTION_LEFT)
 	{
-		nStart = 0;
-		nStop = 0;
+		for (y = 0; y < MENU_HEIGHT_ICON; ++y)
+		{
+			for (i = LINEBYTES - 1; i > 0; --i)
+			{
+				menu_strip[y][i] = (menu_strip[y][i] << 1) |
+					(menu_strip[y][i - 1] >> 7);
+			}
+			menu_strip[y][0] <<= 1;
+		}
+		menu_nStripPos = (menu_nStripPos + 1) % MENU_STRIP_LENGTH;
+		menu_setStripColumn(NUM_COLS - 1,
+			(menu_nStripPos + NUM_COLS - 1) % MENU_STRIP_LENGTH);
 	}
 	else
 	{
-		nStart = 1;
-		nStop = MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER;
-	}
-
-	// draw menu screen for each offset within the nStart/nStop range
-	uint8_t i;
-	for (i = nStart; i <= nStop; ++i)
-	{
-		// offset of the left most icon if it is cut by the left border
-		uint8_t nInitialSideOffset = (((MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)
-		        - (nWidthSide % (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER)))
-		        + (direction == MENU_DIRECTION_LEFT ? i : -i)
-		        + (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER))
-		        % (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER);
-
-		// an initial side offset of 0 means the leftmost icon was changed 
-		// if we are scrolling to the left, increment value for leftmost item 
-		if (direction == MENU_DIRECTION_LEFT && nInitialSideOffset == 0)
+		for (y = 0; y < MENU_HEIGHT_ICON; ++y)
 		{
-			mi = MENU_NEXTITEM(mi);
+			for (i = 0; i < LINEBYTES - 1; ++i)
+			{
+				menu_strip[y][i] = (menu_strip[y][i] >> 1) |
+					(menu_strip[y][i + 1] << 7);
+			}
+			menu_strip[y][LINEBYTES - 1] >>= 1;
 		}
+		menu_nStripPos = (menu_nStripPos + MENU_STRIP_LENGTH - 1)
+			% MENU_STRIP_LENGTH;
+		menu_setStripColumn(0, menu_nStripPos);
+	}
+}
 
-		// draw the icons from the leftmost position (line by line)
-		uint8_t y;
-		for (y = 0; y < MENU_HEIGHT_ICON; ++y)
+
+static void menu_drawStrip(void)
+{
+	uint8_t y, plane, i;
+	for (y = 0; y < MENU_HEIGHT_ICON; ++y)
+	{
+		uint8_t const nRow = ((NUM_ROWS - MENU_HEIGHT_ICON) / 2) + y;
+		for (plane = 0; plane < NUMPLANE; ++plane)
 		{
-			uint8_t miCurrent = mi;
-			uint8_t nIconOffset = nInitialSideOffset;
-			uint8_t x;
-			for (x = 0; x < NUM_COLS; ++x)
+			for (i = 0; i < LINEBYTES; ++i)
 			{
-				uint8_t nPixel = menu_getIconPixel(miCurrent, nIconOffset, y);
-
-				menu_setpixel(x, ((NUM_ROWS - MENU_HEIGHT_ICON) / 2) + y,
-				        nPixel);
-				if (++nIconOffset >= (MENU_WIDTH_ICON + MENU_WIDTH_DELIMITER))
-				{
-					nIconOffset = 0;
-					miCurrent = MENU_NEXTITEM(miCurrent);
-				}
+				pixmap[plane][nRow][i] = menu_strip[y][i] & menu_bands[plane][i];
 			}
 		}
+	}
+}
 
-		// an initial side offset of 0 means the leftmost icon was changed 
-		// if we are scrolling to the right, decrement value for leftmost item 
-		if (direction == MENU_DIRECTION_RIGHT && nInitialSideOffset == 0)
+
+static void menu_animate(menu_direction_t direction)
+{
+	int16_t nWait = MENU_WAIT_INITIAL;
+
+	// a still gets drawn once, scrolling takes one frame per column
+	uint8_t i = (direction == MENU_DIRECTION_STILL) ? 1 : MENU_WIDTH_ITEM;
+	while (i--)
+	{
+		if (direction != MENU_DIRECTION_STILL)
 		{
-			mi = MENU_PREVITEM(mi);
+			menu_shiftStrip(direction);
 		}
+		menu_drawStrip();
 
 		// wait between the frames so that the animation can be seen
 		wait(nWait);
@@ -184,6 +243,32 @@ static void menu_animate(uint8_t miInitial, menu_direction_t direction)
 }
 
 
+#ifdef JOYSTICK_REPLAY_SUPPORT
+static void menu_replay(replay_mode_t nMode)
+{
+	uint8_t nGame;
+	if (replay_play(nMode, &nGame) && (nGame < MENU_ITEM_MAX))
+	{
+		_game_descriptors_start__[nGame].run();
+	}
+	replay_stop();
+}
+
+
+void menu_demo(void)
+{
+	if (MENU_ITEM_MAX != 0)
+	{
+		// the replay module takes care of the fire button
+		waitForFire = 0;
+		clear_screen(0);
+		menu_replay(REPLAY_DEMO);
+		waitForFire = 1;
+	}
+}
+#endif
+
+
 void menu()
 {
 	if (MENU_ITEM_MAX != 0)
@@ -202,7 +287,8 @@ void menu()
 		// set initial menu item
 		static uint8_t miSelection = 0;
 		// scroll in currently selected menu item
-		menu_animate(MENU_PREVITEM(miSelection), MENU_DIRECTION_LEFT);
+		menu_buildStrip(MENU_PREVITEM(miSelection));
+		menu_animate(MENU_DIRECTION_LEFT);
 
 		uint16_t nMenuIterations= MENU_TIMEOUT_ITERATIONS;
 
@@ -220,7 +306,13 @@ void menu()
 				wait(MENU_WAIT_CHATTER);
 
 				// call corresponding function
+#ifdef JOYSTICK_REPLAY_SUPPORT
+				replay_record(miSelection);
+#endif
 				_game_descriptors_start__[miSelection].run();
+#ifdef JOYSTICK_REPLAY_SUPPORT
+				replay_stop();
+#endif
 
 				break;
 
@@ -228,16 +320,32 @@ void menu()
 			// change selected item and do some scrolling
 			else if (JOYISRIGHT)
 			{
-				menu_animate(miSelection, MENU_DIRECTION_LEFT);
+				menu_animate(MENU_DIRECTION_LEFT);
 				miSelection = MENU_NEXTITEM(miSelection);
 				nMenuIterations = MENU_TIMEOUT_ITERATIONS;
 			}
 			else if (JOYISLEFT)
 			{
-				menu_animate(miSelection, MENU_DIRECTION_RIGHT);
+				menu_animate(MENU_DIRECTION_RIGHT);
 				miSelection = MENU_PREVITEM(miSelection);
 				nMenuIterations = MENU_TIMEOUT_ITERATIONS;
 			}
+#ifdef JOYSTICK_REPLAY_SUPPORT
+			// replay the last recorded game
+			else if (JOYISDOWN)
+			{
+				while (JOYISDOWN)
+				{
+					wait(MENU_POLL_INTERVAL);
+				}
+#  ifdef JOYSTICK_REPLAY_FAST
+				menu_replay(REPLAY_PLAY_FAST);
+#  else
+				menu_replay(REPLAY_PLAY);
+#  endif
+				break;
+			}
+#endif
 			// exit menu
 			else if (JOYISUP)
 			{
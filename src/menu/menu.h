@@ -7,6 +7,7 @@
 #define MENU_H_
 
 #include <inttypes.h>
+#include "../config.h"
 
 
 typedef struct{
@@ -17,5 +18,13 @@ typedef struct{
 
 void menu();
 
+#ifdef JOYSTICK_REPLAY_SUPPORT
+/**
+ * Replays the last recorded game as an attract mode demo. Pressing fire
+ * leads to the menu.
+ */
+void menu_demo(void);
+#endif
+
 #endif /*MENU_H_*/
 
@@ -13,16 +13,57 @@
 uint8_t random_state[16];
 uint8_t random_key[16];
 
+uint32_t random_fast_state = 0;
+
+static uint8_t sr[16];
+static uint8_t i=0;
+
+static void random_refill(void){
+	noekeon_enc(random_state, random_key);
+	memcpy(sr, random_state, 16);
+	i=16;
+}
+
 uint8_t random8(void){
-	static uint8_t sr[16];
-	static uint8_t i=0;	
-	
 	if(i==0){
-		noekeon_enc(random_state, random_key);
-		memcpy(sr, random_state, 16);
-		i=15;
-		return sr[15];
+		random_refill();
 	}
-	--i;
-	return sr[i];
+	return sr[--i];
+}
+
+uint16_t random16(void){
+	uint16_t r = random8();
+	return (r << 8) | random8();
+}
+
+uint32_t random32(void){
+	uint32_t r = random16();
+	return (r << 16) | random16();
+}
+
+void random_fill(void* dest, uint16_t n){
+	uint8_t* p = dest;
+	while(n--){
+		if(i==0){
+			random_refill();
+		}
+		*p++ = sr[--i];
+	}
+}
+
+uint32_t random_fast_reseed(void){
+	uint32_t seed;
+	do{
+		seed = random32();
+	}while(seed == 0);
+	random_fast_state = seed;
+	return seed;
+}
+
+void random_restart(uint32_t seed){
+	memset(random_state, 0, 16);
+	memset(random_key, 0, 16);
+	memcpy(random_key, &seed, 4);
+	i = 0;
+	random_fast_state = 0;
 }
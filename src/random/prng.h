@@ -19,6 +19,42 @@ extern uint8_t random_key[16];
 
 uint8_t random8(void);
 
+/* wider outputs of the same stream, the first byte is the most significant */
+uint16_t random16(void);
+uint32_t random32(void);
+
+/* fills n bytes with what n calls to random8() would return, but without
+ * paying a function call per byte */
+void random_fill(void* dest, uint16_t n);
+
+/* restarts the generator from the given seed, so that several devices which
+ * use the same seed produce the very same sequence */
+void random_restart(uint32_t seed);
+
+/* state of the fast generator below, 0 means it has yet to be seeded */
+extern uint32_t random_fast_state;
+
+/* seeds the fast generator from the noekeon stream */
+uint32_t random_fast_reseed(void);
+
+/* cheap xorshift generator for call sites which need lots of random numbers
+ * but no cryptographic strength, e.g. animations filling the whole screen */
+inline static uint32_t random_fast32(void){
+	uint32_t x = random_fast_state;
+	if(x == 0){
+		x = random_fast_reseed();
+	}
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	random_fast_state = x;
+	return x;
+}
+
+inline static uint8_t random_fast8(void){
+	return random_fast32() >> 24;
+}
+
 inline static void random_block(void* dest){
 	noekeon_enc(random_state, random_key);
 	memcpy(dest, random_state, 16);
@@ -1,6 +1,5 @@
 
 #include <avr/io.h>
-#include <util/delay.h>
 
 #include "rfm12.h"
 
@@ -30,7 +29,7 @@ void borg_rfm12_tick(){
 
 }
 
+// the rfm12 needs about 200ms after power-up, boot_service() takes care of it
 void borg_rfm12_init(){
-	_delay_ms(200);//the rfm12 seems to need this
 	rfm12_init();
 }
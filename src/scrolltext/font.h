@@ -1,8 +1,29 @@
 #ifndef FONT_H
 #define FONT_H
 
+#include <stdint.h>
 #include "../compat/pgmspace.h"
 
+/*
+ * Glyphs are stored column by column, storebytes bytes per column with the
+ * topmost pixel in the LSB. Proportional fonts locate the columns of glyph n
+ * via fontIndex[n] and fontIndex[n + 1]. Monospaced fonts set fixedWidth to
+ * the number of columns of every glyph instead, so glyph n simply starts at
+ * n * fixedWidth * storebytes and fontIndex isn't needed at all.
+ * scripts/bdf2font.py generates fonts in either layout.
+ *
+ * The code points glyph_beg to glyph_end - 1 map to the glyphs 0, 1, ...
+ * Glyphs for further code points (e.g. umlauts) follow behind and are found
+ * via glyphRanges, an array in PROGMEM which is sorted by code point.
+ */
+
+/* maps count consecutive code points starting at first to glyph, glyph + 1... */
+typedef struct{
+	uint16_t first;
+	unsigned char count;
+	unsigned char glyph;
+} glyph_range;
+
 typedef struct{
 	unsigned char fontHeight;
 	const unsigned int* fontIndex;
@@ -11,6 +32,9 @@ typedef struct{
 	unsigned char glyph_end;
 	unsigned char glyph_def;
 	unsigned char storebytes;
+	unsigned char fixedWidth; /* columns per glyph, 0 for proportional fonts */
+	const glyph_range* glyphRanges;
+	unsigned char rangeCount;
 } font;
 
 #endif //FONT_H
@@ -96,7 +96,14 @@ unsigned const int PROGMEM fontIndex_arial8[] = {
 				858, /* | */
 				860, /* } */
 				868, /* ~ */
-				878
+				878, /* U+00C4 */
+				892, /* U+00D6 */
+				906, /* U+00DC */
+				918, /* U+00DF */
+				928, /* U+00E4 */
+				938, /* U+00F6 */
+				948, /* U+00FC */
+				958
 };
 
 unsigned const char PROGMEM fontData_arial8[] = {
@@ -539,6 +546,59 @@ unsigned const char PROGMEM fontData_arial8[] = {
 				0x60, 0x00, /*          ##      */
 				0x40, 0x00, /*          #       */
 				0x20, 0x00, /*           #      */
+				0x00, 0x03, /*       ##         */
+				0xc1, 0x00, /*         ##     # */
+				0xb8, 0x00, /*         # ###    */
+				0x84, 0x00, /*         #    #   */
+				0xb8, 0x00, /*         # ###    */
+				0xc1, 0x00, /*         ##     # */
+				0x00, 0x03, /*       ##         */
+				0xf0, 0x00, /*         ####     */
+				0x09, 0x01, /*        #    #  # */
+				0x04, 0x02, /*       #      #   */
+				0x04, 0x02, /*       #      #   */
+				0x04, 0x02, /*       #      #   */
+				0x09, 0x01, /*        #    #  # */
+				0xf0, 0x00, /*         ####     */
+				0xfc, 0x01, /*        #######   */
+				0x01, 0x02, /*       #        # */
+				0x00, 0x02, /*       #          */
+				0x00, 0x02, /*       #          */
+				0x01, 0x02, /*       #        # */
+				0xfc, 0x01, /*        #######   */
+				0xf8, 0x03, /*       #######    */
+				0x04, 0x00, /*              #   */
+				0x24, 0x02, /*       #   #  #   */
+				0x58, 0x02, /*       #  # ##    */
+				0x80, 0x01, /*        ##        */
+				0xa0, 0x01, /*        ## #      */
+				0x54, 0x02, /*       #  # # #   */
+				0x50, 0x02, /*       #  # #     */
+				0x54, 0x01, /*        # # # #   */
+				0xe0, 0x03, /*       #####      */
+				0xe0, 0x01, /*        ####      */
+				0x14, 0x02, /*       #    # #   */
+				0x10, 0x02, /*       #    #     */
+				0x14, 0x02, /*       #    # #   */
+				0xe0, 0x01, /*        ####      */
+				0xf0, 0x01, /*        #####     */
+				0x04, 0x02, /*       #      #   */
+				0x00, 0x02, /*       #          */
+				0x04, 0x01, /*        #     #   */
+				0xf0, 0x03, /*       ######     */
+};
+
+/* glyphs behind the ASCII range */
+glyph_range const glyphRanges_arial8[] PROGMEM = {
+	{0xC4, 1, 95}, /* A umlaut */
+	{0xD6, 1, 96}, /* O umlaut */
+	{0xDC, 1, 97}, /* U umlaut */
+	{0xDF, 1, 98}, /* sharp s */
+	{0xE4, 1, 99}, /* a umlaut */
+	{0xF6, 1, 100}, /* o umlaut */
+	{0xFC, 1, 101}, /* u umlaut */
 };
 
-font font_arial8 = {13, fontIndex_arial8, fontData_arial8, ' ', '~', '.', 2};
+font font_arial8 = {13, fontIndex_arial8, fontData_arial8, ' ', '~', '.', 2, 0,
+	glyphRanges_arial8,
+	sizeof(glyphRanges_arial8) / sizeof(glyphRanges_arial8[0])};
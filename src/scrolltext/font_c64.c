@@ -1,104 +1,5 @@
 #include "font.h"
 
-unsigned int const fontIndex_c64[] PROGMEM = {
-	0, /*   */
-	8, /* ! */
-	16, /* " */
-	24, /* # */
-	32, /* $ */
-	40, /* % */
-	48, /* & */
-	56, /* ' */
-	64, /* ( */
-	72, /* ) */
-	80, /* * */
-	88, /* + */
-	96, /* , */
-	104, /* - */
-	112, /* . */
-	120, /* / */
-	128, /* 0 */
-	136, /* 1 */
-	144, /* 2 */
-	152, /* 3 */
-	160, /* 4 */
-	168, /* 5 */
-	176, /* 6 */
-	184, /* 7 */
-	192, /* 8 */
-	200, /* 9 */
-	208, /* : */
-	216, /* ; */
-	224, /* < */
-	232, /* = */
-	240, /* > */
-	248, /* ? */
-	256, /* @ */
-	264, /* A */
-	272, /* B */
-	280, /* C */
-	288, /* D */
-	296, /* E */
-	304, /* F */
-	312, /* G */
-	320, /* H */
-	328, /* I */
-	336, /* J */
-	344, /* K */
-	352, /* L */
-	360, /* M */
-	368, /* N */
-	376, /* O */
-	384, /* P */
-	392, /* Q */
-	400, /* R */
-	408, /* S */
-	416, /* T */
-	424, /* U */
-	432, /* V */
-	440, /* W */
-	448, /* X */
-	456, /* Y */
-	464, /* Z */
-	472, /* [ */
-	480, /* \ */
-	488, /* ] */
-	496, /* ^ */
-	504, /* _ */
-	512, /* ` */
-	520, /* a */
-	528, /* b */
-	536, /* c */
-	544, /* d */
-	552, /* e */
-	560, /* f */
-	568, /* g */
-	576, /* h */
-	584, /* i */
-	592, /* j */
-	600, /* k */
-	608, /* l */
-	616, /* m */
-	624, /* n */
-	632, /* o */
-	640, /* p */
-	648, /* q */
-	656, /* r */
-	664, /* s */
-	672, /* t */
-	680, /* u */
-	688, /* v */
-	696, /* w */
-	704, /* x */
-	712, /* y */
-	720, /* z */
-	728, /* { */
-	736, /* | */
-	744, /* } */
-	752, /* ~ */
-};
-
-
 unsigned char const fontData_c64[] PROGMEM = {
 	/* character   / ASCII code 32 / offsets: 39 / 32 */
 	0x00, /* ........ */
@@ -955,6 +856,81 @@ unsigned char const fontData_c64[] PROGMEM = {
 	0x02, /* ......#. */
 	0x03, /* ......## */
 	0x01, /* .......# */
+	/* character A umlaut / U+00C4 */
+	0x00, /* ........ */
+	0x79, /* .####..# */
+	0x7d, /* .#####.# */
+	0x14, /* ...#.#.. */
+	0x14, /* ...#.#.. */
+	0x7d, /* .#####.# */
+	0x79, /* .####..# */
+	0x00, /* ........ */
+	/* character O umlaut / U+00D6 */
+	0x00, /* ........ */
+	0x39, /* ..###..# */
+	0x7d, /* .#####.# */
+	0x44, /* .#...#.. */
+	0x44, /* .#...#.. */
+	0x7d, /* .#####.# */
+	0x39, /* ..###..# */
+	0x00, /* ........ */
+	/* character U umlaut / U+00DC */
+	0x00, /* ........ */
+	0x3d, /* ..####.# */
+	0x7d, /* .#####.# */
+	0x40, /* .#...... */
+	0x40, /* .#...... */
+	0x7d, /* .#####.# */
+	0x3d, /* ..####.# */
+	0x00, /* ........ */
+	/* character sharp s / U+00DF */
+	0x00, /* ........ */
+	0xfe, /* #######. */
+	0xff, /* ######## */
+	0x01, /* .......# */
+	0x49, /* .#..#..# */
+	0x7f, /* .####### */
+	0x36, /* ..##.##. */
+	0x00, /* ........ */
+	/* character a umlaut / U+00E4 */
+	0x00, /* ........ */
+	0x21, /* ..#....# */
+	0x75, /* .###.#.# */
+	0x54, /* .#.#.#.. */
+	0x54, /* .#.#.#.. */
+	0x7d, /* .#####.# */
+	0x79, /* .####..# */
+	0x00, /* ........ */
+	/* character o umlaut / U+00F6 */
+	0x00, /* ........ */
+	0x39, /* ..###..# */
+	0x7d, /* .#####.# */
+	0x44, /* .#...#.. */
+	0x44, /* .#...#.. */
+	0x7d, /* .#####.# */
+	0x39, /* ..###..# */
+	0x00, /* ........ */
+	/* character u umlaut / U+00FC */
+	0x00, /* ........ */
+	0x3d, /* ..####.# */
+	0x7d, /* .#####.# */
+	0x40, /* .#...... */
+	0x40, /* .#...... */
+	0x7d, /* .#####.# */
+	0x3d, /* ..####.# */
+	0x00, /* ........ */
+};
+
+/* glyphs behind the ASCII range */
+glyph_range const glyphRanges_c64[] PROGMEM = {
+	{0xC4, 1, 95}, /* A umlaut */
+	{0xD6, 1, 96}, /* O umlaut */
+	{0xDC, 1, 97}, /* U umlaut */
+	{0xDF, 1, 98}, /* sharp s */
+	{0xE4, 1, 99}, /* a umlaut */
+	{0xF6, 1, 100}, /* o umlaut */
+	{0xFC, 1, 101}, /* u umlaut */
 };
 
-font font_c64 = {8, fontIndex_c64, fontData_c64, ' ', '~', '.', 1};
+font font_c64 = {8, 0, fontData_c64, ' ', '~', '.', 1, 8, glyphRanges_c64,
+	sizeof(glyphRanges_c64) / sizeof(glyphRanges_c64[0])};
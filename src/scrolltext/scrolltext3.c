@@ -10,6 +10,7 @@
 
 #include "../pixel.h"
 #include "../util.h"
+#include "../frame_pacer.h"
 #include "font_arial8.h"
 #if SCROLLTEXT_FONT == FONT_ARIAL8
 	#include "font_arial8.h"
@@ -28,13 +29,21 @@
 	#define FONT_NAME font_arial8
 #endif
 
+/* further fonts which can be selected with the f command */
+#ifdef SCROLLTEXT_WITH_SMALL6
+	#include "font_small6.h"
+#endif
+#ifdef SCROLLTEXT_WITH_UNI53
+	#include "font_uni53.h"
+#endif
+#ifdef SCROLLTEXT_WITH_C64
+	#include "font_c64.h"
+#endif
+
 #ifdef __CYGWIN__
 	#define strtok_r(a, b, c) strtok((a), (b))
 #endif
 
-#define MAX_FONTS 1
-font fonts[MAX_FONTS];
-
 // never used
 /*
 #define MAX_SPECIALCOLORS 3
@@ -122,6 +131,8 @@ typedef struct blob_t_struct {
 	const unsigned int *fontIndex;
 	const unsigned char *fontData;
 	unsigned char font_storebytes;/*bytes per char*/
+	unsigned char font_width;/*columns per glyph, 0 if proportional*/
+	unsigned char font_stride;/*bytes per glyph, 0 if proportional*/
 	unsigned char space;
 #ifndef AVR
 	char scrolltextBuffer[SCROLLTEXT_BUFFER_SIZE];
@@ -159,6 +170,102 @@ void showBlob(blob_t *blob)
 #define PW(a) pgm_read_word(&(a))
 #define PB(a) pgm_read_byte(&(a))
 
+/* offset of a glyph's first column, glyphStart(glyph + 1) is its end */
+static inline unsigned int glyphStart(blob_t *blob, unsigned char glyph)
+{
+	if (blob->font_stride) {
+		return glyph * blob->font_stride;
+	}
+	return PW(blob->fontIndex[glyph]);
+}
+
+
+/* glyph of a code point, 0 (the blank) if the font doesn't have one */
+static unsigned char lookupGlyph(font const *f, uint16_t code)
+{
+	if ((code >= f->glyph_beg) && (code < f->glyph_end)) {
+		return code - f->glyph_beg;
+	}
+
+	// binary search over the ranges, which are sorted by code point
+	unsigned char lo = 0, hi = f->rangeCount;
+	while (lo < hi) {
+		unsigned char mid = (lo + hi) / 2;
+		glyph_range const *range = &f->glyphRanges[mid];
+		uint16_t first = PW(range->first);
+		if (code < first) {
+			hi = mid;
+		} else if ((code - first) >= PB(range->count)) {
+			lo = mid + 1;
+		} else {
+			return PB(range->glyph) + (code - first);
+		}
+	}
+	return 0;
+}
+
+
+/* decodes a UTF-8 sequence, stray bytes are taken as Latin-1 characters */
+static uint16_t nextCodePoint(unsigned char **str)
+{
+	unsigned char *s = *str;
+	uint16_t code = *s++;
+
+	if (((code & 0xE0) == 0xC0) && ((s[0] & 0xC0) == 0x80)) {
+		code = ((code & 0x1F) << 6) | (s[0] & 0x3F);
+		s += 1;
+	} else if (((code & 0xF0) == 0xE0) && ((s[0] & 0xC0) == 0x80) &&
+			((s[1] & 0xC0) == 0x80)) {
+		code = ((code & 0x0F) << 12) | ((s[0] & 0x3F) << 6) | (s[1] & 0x3F);
+		s += 2;
+	} else if (((code & 0xF8) == 0xF0) && ((s[0] & 0xC0) == 0x80) &&
+			((s[1] & 0xC0) == 0x80) && ((s[2] & 0xC0) == 0x80)) {
+		code = 0xFFFF; // beyond 16 bits, no font has these anyway
+		s += 3;
+	}
+	*str = s;
+	return code;
+}
+
+
+/* font for the f command of a blob, see the FONT_* ids in scrolltext.h */
+static font *getFont(char const *commands)
+{
+	while ((*commands != 0) && (*commands != 'f')) {
+		commands++;
+	}
+	if (*commands == 0) {
+		return &FONT_NAME;
+	}
+
+	unsigned char id = 0;
+	while ((*++commands >= '0') && (*commands <= '9')) {
+		id = id * 10 + (*commands - '0');
+	}
+
+	switch (id) {
+#ifdef SCROLLTEXT_WITH_ARIAL8
+	case FONT_ARIAL8:
+		return &font_arial8;
+#endif
+#ifdef SCROLLTEXT_WITH_SMALL6
+	case FONT_SMALL6:
+		return &font_small6;
+#endif
+#ifdef SCROLLTEXT_WITH_UNI53
+	case FONT_UNI53:
+		return &font_uni53;
+#endif
+#ifdef SCROLLTEXT_WITH_C64
+	case FONT_C64:
+		return &font_c64;
+#endif
+	default:
+		return &FONT_NAME;
+	}
+}
+
+
 static unsigned int getLen(blob_t *blob)
 {
 	unsigned char glyph;
@@ -166,6 +273,10 @@ static unsigned int getLen(blob_t *blob)
 	unsigned char *str = (unsigned char*) blob->str;
 	uint8_t space = blob->space *blob->font_storebytes;
 
+	if (blob->font_width) {
+		return strlen(blob->str) * (blob->font_width + blob->space);
+	}
+
 	while ((glyph = *str++)) {
 		glyph -= 1;
 		strLen += PW(blob->fontIndex[glyph + 1]) - PW(blob->fontIndex[glyph]);
@@ -299,6 +410,9 @@ unsigned char blobNextCommand(blob_t *blob)
 		case '+':
 			retval = 2;
 			break;
+		case 'f'://font, already applied by setupBlob()
+			getnum(blob);
+			break;
 		}
 	}
 	return 1;//this blob is finished, and can be deleted.
@@ -346,27 +460,26 @@ static blob_t *setupBlob(char *str)
 	if (blob->str == 0)
 		goto fail;
 
-	blob->fontIndex = fonts[0].fontIndex;
-	blob->fontData = fonts[0].fontData;
-	blob->font_storebytes = fonts[0].storebytes;
+	font const *f = getFont(blob->commands);
+	blob->fontIndex = f->fontIndex;
+	blob->fontData = f->fontData;
+	blob->font_storebytes = f->storebytes;
+	blob->font_width = f->fixedWidth;
+	blob->font_stride = f->fixedWidth * f->storebytes;
 
-	unsigned char tmp1, *strg = (unsigned char*) blob->str;
-	unsigned char glyph_beg = fonts[0].glyph_beg;
-	unsigned char glyph_end = fonts[0].glyph_end;
+	unsigned char *src = (unsigned char*) blob->str;
+	unsigned char *dst = src;
 
-	//translate the string: subtract 1 to get offset in Table
-	while ((tmp1 = *strg)) {
-		if ((tmp1 >= glyph_beg) && (tmp1 < glyph_end)) {
-			*strg = 1 + tmp1 - glyph_beg;
-		} else {
-			*strg = 1;
-		}
-		strg++;
+	//translate the string into glyphs + 1, a glyph never takes more bytes
+	//than its UTF-8 sequence, so this works in place
+	while (*src) {
+		*dst++ = 1 + lookupGlyph(f, nextCodePoint(&src));
 	}
+	*dst = 0;
 
 	blob->space = 1;
 
-	blob->sizey = fonts[0].fontHeight;
+	blob->sizey = f->fontHeight;
 	blob->sizex = getLen(blob);
 	switch (*blob->commands) {
 		case '<':
@@ -492,8 +605,8 @@ static void drawBlob(blob_t *blob)
 	storebytes = blob->font_storebytes;
 
 	glyph = (*blob->str) - 1;
-	charPos = PW(blob->fontIndex[glyph]);
-	charEnd = PW(blob->fontIndex[glyph + 1]);
+	charPos = glyphStart(blob, glyph);
+	charEnd = glyphStart(blob, glyph + 1);
 
 	while (posx >= NUM_COLS) {
 		charPos += storebytes;
@@ -504,8 +617,8 @@ static void drawBlob(blob_t *blob)
 			if (!(glyph = *++str))
 				return;
 			glyph -= 1;
-			charPos = PW(blob->fontIndex[glyph]);
-			charEnd = PW(blob->fontIndex[glyph + 1]);
+			charPos = glyphStart(blob, glyph);
+			charEnd = glyphStart(blob, glyph + 1);
 		}
 	}
 	for (x = posx; x >= 0; x-- ) {
@@ -531,8 +644,8 @@ static void drawBlob(blob_t *blob)
 			if (!(glyph = *++str))
 				return;
 			glyph -= 1;
-			charPos = PW(blob->fontIndex[glyph]);
-			charEnd = PW(blob->fontIndex[glyph + 1]);
+			charPos = glyphStart(blob, glyph);
+			charEnd = glyphStart(blob, glyph + 1);
 		}
 	}
 }
@@ -545,8 +658,6 @@ void scrolltext(char *str)
 	char tmp_str[SCROLLTEXT_BUFFER_SIZE];
 	int ljmp_retval;
 
-	fonts[0] = FONT_NAME;
-
 	unsigned char auto_pixmap[NUM_ROWS][LINEBYTES];
 	text_pixmap = &auto_pixmap;
 
@@ -573,6 +684,8 @@ void scrolltext(char *str)
 	}
 
 	unsigned char retval;
+	frame_pacer_t pacer;
+	frame_pacer_init(&pacer, 2);
 	do {
 		startblob->next = 0;
 		startblob->last = 0;
@@ -615,7 +728,7 @@ void scrolltext(char *str)
 				aktblob = aktblob->next;
 			}
 			update_pixmap();
-			wait(2);
+			next_frame(&pacer);
 		};
 		startblob = setupBlob(0);
 		//showBlob(startblob);
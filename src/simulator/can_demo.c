@@ -0,0 +1,183 @@
+/**
+ * \addtogroup unixsimulator
+ */
+/*@{*/
+
+/**
+ * @file can_demo.c
+ * @brief Simulated CAN node which streams test frames to the borg.
+ *
+ * The node is attached to the loopback stand-in of the CAN driver. It uses the
+ * LAP bulk frame transfer to send a moving test pattern to the borg, obeying
+ * the flow control of the borg's acknowledgements.
+ */
+
+#include <stdint.h>
+#include "../config.h"
+#include "../util.h"
+#include "../can/can.h"
+#include "../can/lap.h"
+#include "can_demo.h"
+
+/** Number of bytes per row. */
+#define LINEBYTES (((NUM_COLS - 1) / 8) + 1)
+
+/** Number of data messages per row of a plane. */
+#define CAN_DEMO_ROW_SEGMENTS \
+	((LINEBYTES + BORG_FRAME_DATA_BYTES - 1) / BORG_FRAME_DATA_BYTES)
+
+/** Number of data messages per frame. */
+#define CAN_DEMO_SEGMENTS (NUMPLANE * NUM_ROWS * CAN_DEMO_ROW_SEGMENTS)
+
+/** Number of frames per run. */
+#define CAN_DEMO_FRAMES 250
+
+/** Frame period in milliseconds. */
+#define CAN_DEMO_PERIOD 40
+
+/** Address of the borg. */
+extern can_addr_t myaddr;
+
+/** Frame which is currently being transferred. */
+static unsigned char can_demo_frame[NUMPLANE][NUM_ROWS][LINEBYTES];
+
+/** Set if a run has been requested. */
+static volatile unsigned char can_demo_requested;
+
+/** Remaining frames of the current run. */
+static uint16_t can_demo_remaining;
+
+/** Sequence number of the current frame. */
+static uint8_t can_demo_seq;
+
+/** Number of data messages sent for the current frame. */
+static uint16_t can_demo_sent;
+
+/** Number of data messages the borg has acknowledged (modulo 256). */
+static uint8_t can_demo_acked;
+
+/** Number of messages which may be unacknowledged. */
+static uint8_t can_demo_window;
+
+/** Set as soon as the frame has been committed. */
+static unsigned char can_demo_committed;
+
+/** Set while waiting for the next frame period. */
+static unsigned char can_demo_idle;
+
+/** Tick at which the current frame has been started. */
+static tick_t can_demo_start;
+
+
+/**
+ * Renders diagonal stripes which move with each frame.
+ */
+static void can_demo_render(void) {
+	unsigned char x, y, p;
+	for (p = 0; p < NUMPLANE; ++p) {
+		for (y = 0; y < NUM_ROWS; ++y) {
+			for (x = 0; x < LINEBYTES; ++x) {
+				can_demo_frame[p][y][x] = 0;
+			}
+		}
+	}
+	for (y = 0; y < NUM_ROWS; ++y) {
+		for (x = 0; x < NUM_COLS; ++x) {
+			unsigned char level = (x + y + can_demo_remaining) % (NUMPLANE + 1);
+			for (p = 0; p < level; ++p) {
+				can_demo_frame[p][y][x / 8] |= 1 << (x % 8);
+			}
+		}
+	}
+}
+
+
+/**
+ * Starts the transfer of a new frame.
+ */
+static void can_demo_begin(void) {
+	can_demo_render();
+	can_demo_sent = 0;
+	can_demo_acked = 0;
+	can_demo_window = 0;
+	can_demo_committed = 0;
+	can_demo_idle = 0;
+	can_demo_start = get_tick();
+	lap_borg_frame_begin(myaddr, ++can_demo_seq);
+}
+
+
+/**
+ * Sends as many data messages as the window permits and commits the frame
+ * after the last one.
+ */
+static void can_demo_send(void) {
+	while (can_demo_sent < CAN_DEMO_SEGMENTS &&
+			(uint8_t)((uint8_t)can_demo_sent - can_demo_acked) < can_demo_window) {
+		unsigned char plane = can_demo_sent / (NUM_ROWS * CAN_DEMO_ROW_SEGMENTS);
+		unsigned char row = (can_demo_sent / CAN_DEMO_ROW_SEGMENTS) % NUM_ROWS;
+		unsigned char offset = (can_demo_sent % CAN_DEMO_ROW_SEGMENTS) *
+				BORG_FRAME_DATA_BYTES;
+		unsigned char len = LINEBYTES - offset;
+		++can_demo_sent;
+		lap_borg_frame_data(myaddr, can_demo_seq, row, plane, offset,
+				&can_demo_frame[plane][row][offset], len);
+	}
+
+	if (!can_demo_committed && can_demo_sent == CAN_DEMO_SEGMENTS &&
+			(uint8_t)((uint8_t)can_demo_sent - can_demo_acked) < can_demo_window) {
+		can_demo_committed = 1;
+		lap_borg_frame_show(myaddr, can_demo_seq, (uint8_t)CAN_DEMO_SEGMENTS);
+	}
+}
+
+
+/**
+ * Watches the messages on the loopback bus for acknowledgements of the borg.
+ * @param msg The transmitted message.
+ */
+static void can_demo_monitor(can_message const *msg) {
+	pdo_message const *ack = (pdo_message const *)msg;
+
+	if (!can_demo_remaining || ack->addr_src != myaddr || ack->addr_dst != 0 ||
+			ack->port_src != PORT_BORG || ack->cmd != FKT_BORG_FRAME_ACK ||
+			ack->data[0] != can_demo_seq) {
+		return;
+	}
+
+	switch (ack->data[1]) {
+	case BORG_FRAME_OK:
+		can_demo_acked = ack->data[2];
+		can_demo_window = ack->data[3];
+		can_demo_send();
+		break;
+	case BORG_FRAME_SHOWN:
+		--can_demo_remaining;
+		can_demo_idle = 1;
+		break;
+	default:
+		// retransmit the frame with a new sequence number
+		can_demo_idle = 1;
+		break;
+	}
+}
+
+
+void can_demo_request(void) {
+	can_demo_requested = 1;
+}
+
+
+void can_demo_tick(void) {
+	if (can_demo_requested) {
+		can_demo_requested = 0;
+		can_loopback_monitor = can_demo_monitor;
+		can_demo_remaining = CAN_DEMO_FRAMES;
+		can_demo_begin();
+	} else if (can_demo_remaining && can_demo_idle &&
+			(tick_t)(get_tick() - can_demo_start) >= CAN_DEMO_PERIOD) {
+		can_demo_begin();
+	}
+}
+
+/*@}*/
@@ -0,0 +1,27 @@
+/**
+ * \addtogroup unixsimulator
+ */
+/*@{*/
+
+/**
+ * @file can_demo.h
+ * @brief Simulated CAN node which streams test frames to the borg.
+ */
+
+#ifndef CAN_DEMO_H_
+#define CAN_DEMO_H_
+
+/**
+ * Requests a new run of test frames (may be called from any thread).
+ */
+void can_demo_request(void);
+
+
+/**
+ * Drives the simulated node, to be called from wait().
+ */
+void can_demo_tick(void);
+
+#endif /* CAN_DEMO_H_ */
+
+/*@}*/
@@ -2,75 +2,164 @@
 //EEPPROM compatibility support for simulator
 
 #include <stdint.h>
-#include <stdio.h>	
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define EEPROM_SIZE 1024
+#include "../compat/eeprom.h"
 
-static FILE * fp;
+// E2END + 1 of the target MCU, set by the Makefile
+#ifndef SIM_EEPROM_SIZE
+	#define SIM_EEPROM_SIZE 1024
+#endif
 
-static uint8_t eemem[EEPROM_SIZE];
+#if SIM_EEPROM_SIZE & (SIM_EEPROM_SIZE - 1)
+	#error SIM_EEPROM_SIZE has to be a power of two
+#endif
 
-static uint8_t inited;
-static void init(){
-	if(!inited){
-		inited = 1;
-		char* filename = ".simulated_eeprom.bin"; 
-		size_t size;
-		fp = fopen(filename, "r+");
-		if(fp == 0){
-			fp = fopen(filename, "w+");
-			if(fp == 0){
-				printf("Failed to open %s\n",filename );
-				exit (1);
+// dirty pages get written back at most this often (in seconds)
+#define SYNC_INTERVAL 2
+
+// the EEPROM contents, mapped from the backing file
+static uint8_t * eemem;
+
+// number of (changing) writes to each cell, i.e. its wear
+static uint32_t writes[SIM_EEPROM_SIZE];
+
+static uint8_t dirty;
+static time_t last_sync;
+
+static void sync_eeprom(void){
+	if(dirty){
+		msync(eemem, SIM_EEPROM_SIZE, MS_SYNC);
+		dirty = 0;
+	}
+}
+
+// prints the wear statistics, per address if SIM_EEPROM_STATS is set
+static void print_stats(void){
+	unsigned long total = 0;
+	unsigned cells = 0, worst = 0;
+	unsigned i;
+	for(i = 0; i < SIM_EEPROM_SIZE; i++){
+		if(writes[i]){
+			total += writes[i];
+			cells++;
+			if(writes[i] > writes[worst]){
+				worst = i;
 			}
+			if(getenv("SIM_EEPROM_STATS")){
+				printf("sim eeprom [%04X] %lu writes\n", i,
+					(unsigned long)writes[i]);
+			}
+		}
+	}
+	if(total){
+		printf("sim eeprom: %lu writes to %u cells, at most %lu to [%04X]\n",
+			total, cells, (unsigned long)writes[worst], worst);
+	}
+}
+
+static void eeprom_shutdown(void){
+	sync_eeprom();
+	print_stats();
+}
+
+static void init(){
+	if(!eemem){
+		char* filename = ".simulated_eeprom.bin";
+		struct stat st;
+		int fd = open(filename, O_RDWR | O_CREAT, 0644);
+		if(fd < 0 || fstat(fd, &st) < 0){
+			printf("Failed to open %s\n",filename );
+			exit (1);
+		}
+		if(st.st_size < SIM_EEPROM_SIZE && ftruncate(fd, SIM_EEPROM_SIZE) < 0){
+			printf("Failed to resize %s\n",filename );
+			exit (1);
 		}
-		size = fread (eemem, 1, EEPROM_SIZE, fp);
-		if(size < EEPROM_SIZE){
-			memset(eemem, 0xff, EEPROM_SIZE);
+		eemem = mmap(NULL, SIM_EEPROM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+			fd, 0);
+		close(fd);
+		if(eemem == MAP_FAILED){
+			printf("Failed to map %s\n",filename );
+			exit (1);
 		}
+		// cells the file didn't cover yet are erased
+		if(st.st_size < SIM_EEPROM_SIZE){
+			memset(eemem + st.st_size, 0xff, SIM_EEPROM_SIZE - st.st_size);
+		}
+		last_sync = time(NULL);
+		atexit(eeprom_shutdown);
 	}
 }
 
 extern uint8_t _eeprom_start__[];
 
-uint16_t conv_addr(void * p){
+static uint16_t conv_addr(const void * p){
 	uint16_t addr;
 	addr = (unsigned long)p - (unsigned long)_eeprom_start__;
-	if(addr >= EEPROM_SIZE){
-		printf ("warning: eeprom write to %X\n",addr);
+	if(addr >= SIM_EEPROM_SIZE){
+		printf ("warning: eeprom access to %X\n",addr);
 	}
-	addr &= (EEPROM_SIZE-1);
+	addr &= (SIM_EEPROM_SIZE-1);
 	return addr;
 }
 
+static void write_cell(uint16_t addr, uint8_t value){
+	eemem[addr] = value;
+	writes[addr]++;
+	dirty = 1;
+	if(time(NULL) - last_sync >= SYNC_INTERVAL){
+		msync(eemem, SIM_EEPROM_SIZE, MS_ASYNC);
+		last_sync = time(NULL);
+	}
+}
+
 void 	eeprom_write_byte (uint8_t *p, uint8_t value){
-	printf("sim eeprom write [%04X]=%02X\n", conv_addr(p), value);
 	init();
-	eemem[conv_addr(p)] = value;
-	fseek(fp, 0, SEEK_SET);
-	fwrite(eemem, 1, EEPROM_SIZE, fp);
+	write_cell(conv_addr(p), value);
 }
 
 void 	eeprom_write_word (uint16_t *p, uint16_t value){
-	printf("sim eeprom write [%04X]=%04X\n", conv_addr(p), value);
+	init();
+	write_cell(conv_addr(p)  , value & 0xff);
+	write_cell(conv_addr((uint8_t*)p + 1), value >> 8);
+}
 
+void 	eeprom_update_byte (uint8_t *p, uint8_t value){
 	init();
-	eemem[conv_addr((uint8_t*)p)  ] = value & 0xff;
-	eemem[conv_addr((uint8_t*)p)+1] = value >> 8;
-	
-	fseek(fp, 0, SEEK_SET);
-	fwrite(eemem, 1, EEPROM_SIZE, fp);
-	fflush(fp);
+	if(eemem[conv_addr(p)] != value){
+		write_cell(conv_addr(p), value);
+	}
+}
+
+void 	eeprom_update_block (const void *src, void *dst, size_t n){
+	size_t i;
+	for(i = 0; i < n; i++){
+		eeprom_update_byte((uint8_t*)dst + i, ((const uint8_t*)src)[i]);
+	}
+}
+
+void 	eeprom_read_block (void *dst, const void *src, size_t n){
+	size_t i;
+	init();
+	for(i = 0; i < n; i++){
+		((uint8_t*)dst)[i] = eemem[conv_addr((const uint8_t*)src + i)];
+	}
 }
 
-uint8_t  eeprom_read_byte (uint8_t *p){
+uint8_t  eeprom_read_byte (const uint8_t *p){
 	init();
 	return eemem[conv_addr(p)];
 }
 
-uint16_t eeprom_read_word (uint16_t *p){
+uint16_t eeprom_read_word (const uint16_t *p){
 	init();
-	return eemem[conv_addr((uint8_t*)p)] | (eemem[conv_addr((uint8_t*)p)+1]<<8);
+	return eemem[conv_addr(p)] | (eemem[conv_addr((const uint8_t*)p + 1)]<<8);
 }
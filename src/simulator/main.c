@@ -17,6 +17,7 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -25,6 +26,15 @@
 
 #include "../config.h"
 #include "../display_loop.h"
+#include "../util.h"
+#include "../compositor.h"
+#ifdef CAN_SUPPORT
+#include "../can/borg_can.h"
+#include "can_demo.h"
+#endif
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#include "../joystick/replay.h"
+#endif
 #include "trackball.h"
 
 /** Number of bytes per row. */
@@ -59,14 +69,51 @@ int win;
  * Simple wait function.
  * @param ms The requested delay in milliseconds.
  */
-void wait(unsigned int ms) {
+void wait(int ms) {
+#ifdef JOYSTICK_REPLAY_SUPPORT
+	if (replay_mode != REPLAY_OFF) {
+		replay_frame();
+		if (replay_isFast()) {
+			ms = 0;
+		}
+	}
+#endif
+
+#ifdef CAN_SUPPORT
+	can_demo_tick();
+	bcan_process_messages();
+#endif
+
 	if (waitForFire) {
 		if (fakeport & 0x01) {
 			longjmp(newmode_jmpbuf, 0xFEu);
 		}
 	}
 
-	usleep(ms * 1000);
+#ifdef TEMPORAL_DITHER_SUPPORT
+	// keep the dithering phases going during long delays
+	compositor_tick();
+	while (ms > 10) {
+		usleep(10000);
+		ms -= 10;
+		compositor_tick();
+	}
+#endif
+
+	if (ms > 0) {
+		usleep(ms * 1000);
+	}
+}
+
+
+/**
+ * Monotonic millisecond tick, derived from the system's monotonic clock.
+ * @return Milliseconds since an arbitrary point in time (modulo 2^16).
+ */
+tick_t get_tick(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (tick_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
 }
 
 
@@ -116,6 +163,12 @@ void display(void) {
 	glPopMatrix();
 	glutSwapBuffers();
 
+#ifdef TEMPORAL_DITHER_SUPPORT
+	// every redraw counts as a shown frame, the next phase gets composed by
+	// wait() in the animation's thread
+	++borg_hw_frame_count;
+#endif
+
 	usleep(20000);
 }
 
@@ -148,6 +201,11 @@ void keyboard(unsigned char key, int x, int y) {
 	case 'w':
 		fakeport |= 0x10;
 		break;
+#ifdef CAN_SUPPORT
+	case 'c':
+		can_demo_request();
+		break;
+#endif
 	}
 }
 
@@ -314,6 +372,10 @@ int main(int argc, char **argv) {
 	tbInit(GLUT_LEFT_BUTTON);
 	tbAnimate(GL_FALSE);
 
+#ifdef CAN_SUPPORT
+	bcan_init();
+#endif
+
 	pthread_t simthread;
 	pthread_create(&simthread, NULL, display_loop_run, NULL);
 
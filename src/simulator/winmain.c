@@ -34,6 +34,11 @@
 #include <stdio.h>
 #include "../config.h"
 #include "../display_loop.h"
+#include "../util.h"
+#include "../compositor.h"
+#ifdef JOYSTICK_REPLAY_SUPPORT
+#include "../joystick/replay.h"
+#endif
 
 /** Number of bytes per row. */
 #define LINEBYTES (((NUM_COLS - 1) / 8) + 1)
@@ -392,6 +397,11 @@ LRESULT CALLBACK simWndProc(HWND hWnd,
 	case WM_TIMER:
 		simDisplay(hWnd);
 		UpdateWindow(hWnd);
+#ifdef TEMPORAL_DITHER_SUPPORT
+		// every redraw counts as a shown frame, the next phase gets composed
+		// by wait() in the animation's thread
+		++borg_hw_frame_count;
+#endif
 		break;
 
 	/* quit application */
@@ -439,6 +449,28 @@ MMRESULT simSetMinimumTimerResolution()
 	return mmresult;
 }
 
+/**
+ * Halts the calling thread via a multimedia timer.
+ * @param ms The requested delay in milliseconds.
+ */
+static void simSleep(int ms)
+{
+	MMRESULT mmTimerEventId;
+
+	/* retrieve a multimedia timer */
+	mmTimerEventId = timeSetEvent(ms, g_uResolution, g_hWaitEvent, 0,
+	    TIME_ONESHOT | TIME_CALLBACK_EVENT_SET);
+	if (mmTimerEventId != 0)
+	{
+		/* now halt until that timer pulses our wait event object */
+		WaitForSingleObject(g_hWaitEvent, INFINITE);
+		ResetEvent(g_hWaitEvent);
+
+		/* relieve the timer from its duties */
+		timeKillEvent(mmTimerEventId);
+	}
+}
+
 /**
  * Wait function which utilizes multimedia timers and thread synchronization
  * objects. Although this is much more complicated than calling the Sleep()
@@ -448,7 +480,13 @@ MMRESULT simSetMinimumTimerResolution()
  */
 void wait(int ms)
 {
-	MMRESULT mmTimerEventId;
+#ifdef JOYSTICK_REPLAY_SUPPORT
+	/* advance recordings and replays by one frame */
+	if (replay_mode != REPLAY_OFF)
+	{
+		replay_frame();
+	}
+#endif
 
 	/* check if fire button is pressed (and if it is, jump to the menu) */
 	if (waitForFire)
@@ -459,18 +497,35 @@ void wait(int ms)
 		}
 	}
 
-	/* retrieve a multimedia timer */
-	mmTimerEventId = timeSetEvent(ms, g_uResolution, g_hWaitEvent, 0,
-	    TIME_ONESHOT | TIME_CALLBACK_EVENT_SET);
-	if (mmTimerEventId != 0)
+#ifdef JOYSTICK_REPLAY_SUPPORT
+	/* fast replays don't wait at all */
+	if (replay_isFast())
 	{
-		/* now halt until that timer pulses our wait event object */
-		WaitForSingleObject(g_hWaitEvent, INFINITE);
-		ResetEvent(g_hWaitEvent);
+		return;
+	}
+#endif
 
-		/* relieve the timer from its duties */
-		timeKillEvent(mmTimerEventId);
+#ifdef TEMPORAL_DITHER_SUPPORT
+	/* keep the dithering phases going during long delays */
+	compositor_tick();
+	while (ms > 10)
+	{
+		simSleep(10);
+		ms -= 10;
+		compositor_tick();
 	}
+#endif
+
+	simSleep(ms);
+}
+
+/**
+ * Monotonic millisecond tick, derived from the multimedia timer services.
+ * @return Milliseconds since system start (modulo 2^16).
+ */
+tick_t get_tick(void)
+{
+	return (tick_t)timeGetTime();
 }
 
 /**
@@ -9,6 +9,8 @@
 #include <avr/pgmspace.h>
 #include <avr/eeprom.h>
 #include "../config.h"
+#include "../kvstore.h"
+#include "../boot.h"
 #include "../borg_hw/borg_hw.h"
 #ifdef JOYSTICK_SUPPORT
 	#include "../joystick/joystick.h"
@@ -61,6 +63,7 @@ char const UART_STR_CLEARLINE[]  PROGMEM = "\r\033[J";
 char const UART_STR_BACKSPACE[]  PROGMEM = "\b \b";
 char const UART_STR_PROMPT[]     PROGMEM = "> ";
 char const UART_STR_MODE[]       PROGMEM = "%d"CR;
+char const UART_STR_BOOT[]       PROGMEM = "First frame after %u ms."CR;
 char const UART_STR_MODE_ERR[]   PROGMEM = "Range is between 0 and 255."CR;
 char const UART_STR_GAMEMO_ERR[] PROGMEM = "No mode change during games."CR;
 char const UART_STR_GAMETX_ERR[] PROGMEM = "No text messages during games."CR;
@@ -68,13 +71,15 @@ char const UART_STR_UART_ERR[]   PROGMEM = "Transmission error."CR;
 char const UART_STR_UNKNOWN[]    PROGMEM = "Unknown command or syntax error."CR;
 char const UART_STR_TOOLONG[]    PROGMEM = CR"Command is too long."CR;
 #ifdef LED_TESTER
-char const UART_STR_HELP[]       PROGMEM = "Allowed commands: erase help mode "
-                                           "msg next power_lo power_hi prev "
-                                           "reset scroll test"CR;
+char const UART_STR_HELP[]       PROGMEM = "Allowed commands: boot erase help "
+                                           "mode msg next power_lo power_hi "
+                                           "prev reset scroll test"CR;
 #else
-char const UART_STR_HELP[]       PROGMEM = "Allowed commands: erase help mode "
-                                           "msg next prev reset scroll test"CR;
+char const UART_STR_HELP[]       PROGMEM = "Allowed commands: boot erase help "
+                                           "mode msg next prev reset scroll "
+                                           "test"CR;
 #endif
+char const UART_CMD_BOOT[]       PROGMEM = "boot";
 char const UART_CMD_ERASE[]      PROGMEM = "erase";
 char const UART_CMD_HELP[]       PROGMEM = "help";
 char const UART_CMD_MODE[]       PROGMEM = "mode";
@@ -161,6 +166,8 @@ static void uartcmd_erase_eeprom(void) {
 		eeprom_busy_wait();
 		eeprom_update_block(eeclear, ee, E2PAGESIZE);
 	}
+	// start over with an empty settings store
+	kv_init();
 #else
 	UART_PUTS_P(UART_STR_NOTIMPL);
 #endif
@@ -302,6 +309,17 @@ static void uartcmd_print_mode(void) {
 }
 
 
+/**
+ * Outputs the time it took from power-up to the first frame via UART.
+ */
+static void uartcmd_print_boot(void) {
+	char boot_output[32];
+	snprintf_P(boot_output, sizeof(boot_output), UART_STR_BOOT,
+		(unsigned int)boot_first_frame);
+	UART_PUTS(boot_output);
+}
+
+
 /**
  * Retrieves desired mode number from command line and switches to that mode.
  */
@@ -503,7 +521,9 @@ static bool uartcmd_read_until_enter(void) {
  */
 void uartcmd_process(void) {
 	if (uartcmd_processing_allowed() && uartcmd_read_until_enter()) {
-		if (!strncmp_P(g_rx_buffer, UART_CMD_ERASE, UART_BUFFER_SIZE)) {
+		if (!strncmp_P(g_rx_buffer, UART_CMD_BOOT, UART_BUFFER_SIZE)) {
+			uartcmd_print_boot();
+		} else if (!strncmp_P(g_rx_buffer, UART_CMD_ERASE, UART_BUFFER_SIZE)) {
 			uartcmd_erase_eeprom();
 		} else if (!strncmp_P(g_rx_buffer, UART_CMD_HELP, UART_BUFFER_SIZE)) {
 			UART_PUTS_P(UART_STR_HELP);
@@ -1,6 +1,9 @@
 #include "config.h"
+#include "util.h"
+#include "boot.h"
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <setjmp.h>
 
 #ifdef JOYSTICK_SUPPORT
@@ -23,8 +26,17 @@ extern jmp_buf newmode_jmpbuf;
 #  include "uart/uart_commands.h"
 #endif
 
-void wait(int ms){
-	// initialize timer
+#ifdef TEMPORAL_DITHER_SUPPORT
+#  include "compositor.h"
+#endif
+
+/*
+ * The timer behind the monotonic tick is configured to fire a compare match
+ * interrupt at 1000Hz. Which timer gets used depends on the display driver,
+ * as some Arduino/LoL Shield variants require Timer1 for multiplexing. Timer0,
+ * on the other hand, is free to use there, which makes it a perfect candidate
+ * for our tick.
+ */
 #if defined (__AVR_ATmega48__)    || \
     defined (__AVR_ATmega48P__)   || \
     defined (__AVR_ATmega88__)    || \
@@ -44,34 +56,94 @@ void wait(int ms){
     defined (__AVR_ATmega32U4__)  || \
     defined (__AVR_ATmega1280__)  || \
     defined (__AVR_ATmega2560__)
-
 #	ifndef USER_TIMER0_FOR_WAIT
-	/* Timer1 for the masses */
-	TCCR1B = _BV(WGM12) | _BV(CS12); //CTC Mode, clk/256
-	OCR1A = (F_CPU/256000);	         //1000Hz
+		/* Timer1 for the masses, CTC Mode, clk/256, 1000Hz */
+#		define TICK_TIMER_INIT()  TCCR1B = _BV(WGM12) | _BV(CS12); \
+		                          OCR1A = (F_CPU/256000)
+#		define TICK_INT_ENABLE()  TIMSK1 |= _BV(OCIE1A)
+#		define TICK_ISR           TIMER1_COMPA_vect
 #	else
-	/* Timer0
-	 * Some Arduino/LoL Shield variants require Timer1 for multiplexing. Timer0,
-	 * on the other hand, is free to use, which makes it a perfect candidate for
-	 * our wait() function. */
-	TCCR0A = _BV(WGM01);    // CTC mode
-	TCCR0B = _BV(CS02);     // clk/256
-	OCR0A = (F_CPU/256000);	//1000Hz
+		/* Timer0, CTC mode, clk/256, 1000Hz */
+#		define TICK_TIMER_INIT()  TCCR0A = _BV(WGM01); TCCR0B = _BV(CS02); \
+		                          OCR0A = (F_CPU/256000)
+#		define TICK_INT_ENABLE()  TIMSK0 |= _BV(OCIE0A)
+#		define TICK_ISR           TIMER0_COMPA_vect
 #	endif
 #else
 #	ifndef USER_TIMER0_FOR_WAIT
-	/* Timer1 */
-	TCCR1B = _BV(WGM12) | _BV(CS12); //CTC Mode, clk/256
-	OCR1A = (F_CPU/256000);	         //1000Hz
+		/* Timer1, CTC Mode, clk/256, 1000Hz */
+#		define TICK_TIMER_INIT()  TCCR1B = _BV(WGM12) | _BV(CS12); \
+		                          OCR1A = (F_CPU/256000)
+#		define TICK_INT_ENABLE()  TIMSK |= _BV(OCIE1A)
+#		define TICK_ISR           TIMER1_COMPA_vect
+#	elif !defined(__AVR_ATmega8__)
+		/* Timer0, CTC mode, clk/256, 1000Hz */
+#		define TICK_TIMER_INIT()  TCCR0 = _BV(WGM01) | _BV(CS02); \
+		                          OCR0 = (F_CPU/256000)
+#		define TICK_INT_ENABLE()  TIMSK |= _BV(OCIE0)
+#		define TICK_ISR           TIMER0_COMP_vect
 #	else
-	/* Timer0 */
-	/* CTC mode, clk/256 */
-	TCCR0 = _BV(WGM01) | _BV(CS02);
-	OCR0 = (F_CPU/256000);	//1000Hz
+#		error Timer0 for wait() is not supported on ATmega8
 #	endif
 #endif
 
-	for(;ms>0;ms--){
+/** Milliseconds since tick_init(), advanced by the timer interrupt. */
+static volatile tick_t tick_count;
+
+ISR(TICK_ISR) {
+	++tick_count;
+}
+
+
+/**
+ * Starts the millisecond tick which drives both get_tick() and wait(). Has to
+ * be called before interrupts get enabled for the first time.
+ */
+void tick_init(void) {
+	TICK_TIMER_INIT();
+	TICK_INT_ENABLE();
+}
+
+
+/**
+ * Returns the monotonic millisecond tick.
+ * @return Milliseconds since tick_init() (modulo 2^16).
+ */
+tick_t get_tick(void) {
+	// a 16 bit value can't be read atomically on an 8 bit MCU
+	uint8_t const sreg = SREG;
+	cli();
+	tick_t const tick = tick_count;
+	SREG = sreg;
+	return tick;
+}
+
+
+/**
+ * Waits for the given amount of milliseconds while keeping the message
+ * handlers and the joystick serviced. The handlers are serviced once even if
+ * no time is requested, so the caller can use wait(0) just for that. Pending
+ * boot jobs (see boot.h) are finished here as well.
+ * @param ms The requested delay in milliseconds.
+ */
+void wait(int ms){
+#ifdef JOYSTICK_REPLAY_SUPPORT
+	// one joystick sample per frame, fast replays don't wait at all
+	if (replay_mode != REPLAY_OFF) {
+		replay_frame();
+		if (replay_isFast()) {
+			ms = 0;
+		}
+	}
+#endif
+
+	do {
+		// the low byte suffices for detecting the next tick
+		uint8_t const tick = (uint8_t)tick_count;
+
+		if (boot_pending) {
+			boot_service();
+		}
 
 #ifdef CAN_SUPPORT
 		bcan_process_messages();
@@ -82,7 +154,13 @@ void wait(int ms){
 #endif
 
 #ifdef RFM12_SUPPORT
-		borg_rfm12_tick();
+		if (boot_isDone(BOOT_RFM12)) {
+			borg_rfm12_tick();
+		}
+#endif
+
+#ifdef TEMPORAL_DITHER_SUPPORT
+		compositor_tick();
 #endif
 
 #ifdef JOYSTICK_SUPPORT
@@ -95,47 +173,11 @@ void wait(int ms){
 		}
 #endif
 
-	// busy waiting for compare match interrupt flag
-#if defined (__AVR_ATmega48__)    || \
-    defined (__AVR_ATmega48P__)   || \
-    defined (__AVR_ATmega88__)    || \
-    defined (__AVR_ATmega88P__)   || \
-    defined (__AVR_ATmega168__)   || \
-    defined (__AVR_ATmega168P__)  || \
-    defined (__AVR_ATmega328__)   || \
-    defined (__AVR_ATmega328P__)  || \
-    defined (__AVR_ATmega164__)   || \
-    defined (__AVR_ATmega164P__)  || \
-    defined (__AVR_ATmega324__)   || \
-    defined (__AVR_ATmega324P__)  || \
-    defined (__AVR_ATmega644__)   || \
-    defined (__AVR_ATmega644P__)  || \
-    defined (__AVR_ATmega1284__)  || \
-    defined (__AVR_ATmega1284P__) || \
-    defined (__AVR_ATmega32U4__)  || \
-    defined (__AVR_ATmega1280__)  || \
-    defined (__AVR_ATmega2560__)
-#	ifndef USER_TIMER0_FOR_WAIT
-		/* Timer1 for the masses */
-		while(!(TIFR1 & _BV(OCF1A))); // wait for compare match flag
-		TIFR1 |= _BV(OCF1A);          // reset that flag
-#	else
-		/* Timer0 for e.g. Arduino/LoL Shield */
-		while(!(TIFR0 & _BV(OCF0A))); // wait for compare match flag
-		TIFR0 |= _BV(OCF0A);          // reset that flag
-#	endif
-#else
-#	ifndef USER_TIMER0_FOR_WAIT
-		/* Timer1 for the masses */
-		while(!(TIFR & _BV(OCF1A)));  // wait for compare match flag
-		TIFR |= _BV(OCF1A);           // reset that flag
-#	elif !defined(__AVR_ATmega8__)
-		/* Timer0 */
-		while(!(TIFR & _BV(OCF0)));   // wait for compare match flag
-		TIFR |= _BV(OCF0);            // reset that flag
-#	else
-#		error Timer0 for wait() is not supported on ATmega8
-#	endif
-#endif
-	}
+		if (ms <= 0) {
+			break;
+		}
+
+		// busy waiting for the next tick
+		while ((uint8_t)tick_count == tick);
+	} while (--ms);
 }
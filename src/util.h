@@ -1,6 +1,18 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <stdint.h>
+
+/**
+ * Type of the monotonic millisecond tick. It wraps around after 65.5 seconds,
+ * so only differences between two ticks are meaningful (which are computed
+ * with unsigned arithmetic and therefore survive the wrap-around).
+ */
+typedef uint16_t tick_t;
+
+void tick_init(void);
+tick_t get_tick(void);
+
 void wait(int ms);
 
 #endif